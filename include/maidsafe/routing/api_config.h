@@ -19,13 +19,17 @@
 #ifndef MAIDSAFE_ROUTING_API_CONFIG_H_
 #define MAIDSAFE_ROUTING_API_CONFIG_H_
 
+#include <chrono>
 #include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "boost/asio/ip/udp.hpp"
 #include "boost/optional.hpp"
 
+#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/common/node_id.h"
 #include "maidsafe/rudp/managed_connections.h"
@@ -67,6 +71,15 @@ typedef std::function<void(const std::string& /*message*/,
 typedef std::function<void(boost::optional<asymm::PublicKey> /*public_key*/)> GivePublicKeyFunctor;
 typedef std::function<void(NodeId /*node Id*/, GivePublicKeyFunctor)> RequestPublicKeyFunctor;
 
+// Batched alternative to RequestPublicKeyFunctor.  Requests made within a short window (see
+// Parameters::public_key_request_batch_window) are passed to the user in a single call.  The user
+// should call the GivePublicKeysFunctor once, with the keys of those nodes which are valid.  Nodes
+// omitted from the reply are treated as having no valid key.
+typedef std::function<void(std::vector<std::pair<NodeId, asymm::PublicKey>> /*public_keys*/)>
+    GivePublicKeysFunctor;
+typedef std::function<void(std::vector<NodeId> /*node Ids*/, GivePublicKeysFunctor)>
+    RequestPublicKeysFunctor;
+
 typedef std::function<void(const std::string& /*data*/,
                            ReplyFunctor /*reply functor*/)> HaveCacheDataFunctor;
 typedef std::function<void(const std::string& /*data*/)> StoreCacheDataFunctor;
@@ -117,7 +130,8 @@ struct Functors {
         network_status(),
         close_nodes_change(),
         set_public_key(),
-        request_public_key() {}
+        request_public_key(),
+        request_public_keys() {}
 
   MessageAndCachingFunctors message_and_caching;
   TypedMessageAndCachingFunctor typed_message_and_caching;
@@ -125,6 +139,42 @@ struct Functors {
   CloseNodesChangeFunctor close_nodes_change;
   GivePublicKeyFunctor set_public_key;
   RequestPublicKeyFunctor request_public_key;
+  // If provided, used instead of request_public_key.
+  RequestPublicKeysFunctor request_public_keys;
+};
+
+// Optional per-object settings for a Routing object.  By default each Routing object creates its
+// own AsioService and uses the process-wide values held in Parameters.
+// If 'asio_service' is provided, the Routing object runs all its handlers and timers on that
+// service instead, so many Routing objects in one process can share a single thread pool.  Each
+// Routing object then handles its received messages, lost connections and its own maintenance
+// timers (bootstrap, find node, routing table saves) on a strand it owns.  Response and
+// acknowledgement timeouts are not on the strand; they only call thread-safe code.  The caller
+// must keep the service running until every Routing object using it has been destroyed.
+// Each set optional field overrides the corresponding Parameters value for this object only.  The
+// thread counts are of threads each Routing object dedicates to that work; many Routing objects
+// sharing a service may set them to 0 to have it done on the service's threads instead.
+struct RoutingOptions {
+  RoutingOptions()
+      : asio_service(),
+        max_routing_table_size(),
+        routing_table_size_threshold(),
+        max_routing_table_size_for_client(),
+        caching(),
+        close_nodes_change_quiet_period(),
+        decode_thread_count(),
+        transmit_thread_count(),
+        signing_thread_count() {}
+
+  std::shared_ptr<AsioService> asio_service;
+  boost::optional<unsigned int> max_routing_table_size;
+  boost::optional<unsigned int> routing_table_size_threshold;
+  boost::optional<unsigned int> max_routing_table_size_for_client;
+  boost::optional<bool> caching;
+  boost::optional<std::chrono::steady_clock::duration> close_nodes_change_quiet_period;
+  boost::optional<unsigned int> decode_thread_count;
+  boost::optional<unsigned int> transmit_thread_count;
+  boost::optional<unsigned int> signing_thread_count;
 };
 
 }  // namespace routing
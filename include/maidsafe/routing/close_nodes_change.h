@@ -59,14 +59,21 @@ class CloseNodesChange {
 
   CheckHoldersResult CheckHolders(const NodeId& target) const;
   NodeId ChoosePmidNode(const std::set<NodeId>& online_pmids, const NodeId& target) const;
+  // The closest node to have left, or joined, the close nodes.  A change covering several nodes
+  // dropped at once may have lost (and so gained) more than one; see lost_nodes() and new_nodes().
   NodeId lost_node() const { return lost_node_; }
   NodeId new_node() const { return new_node_; }
   std::vector<NodeId> new_close_nodes() const { return new_close_nodes_; }
+  std::vector<NodeId> old_close_nodes() const { return old_close_nodes_; }
+  // All nodes which have left, or joined, the close nodes, closest first.
+  std::vector<NodeId> lost_nodes() const;
+  std::vector<NodeId> new_nodes() const;
   void Print() const;
   std::string ReportConnection() const;
 
   friend void swap(CloseNodesChange& lhs, CloseNodesChange& rhs) MAIDSAFE_NOEXCEPT;
   friend class RoutingTable;
+  friend class CloseNodesChangeCoalescer;
   friend class test::CloseNodesChangeTest_BEH_CheckHolders_Test;
   friend class test::SingleCloseNodesChangeTest_BEH_ChoosePmidNode_Test;
 
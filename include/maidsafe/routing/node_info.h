@@ -20,6 +20,7 @@
 #define MAIDSAFE_ROUTING_NODE_INFO_H_
 
 #include <cstdint>
+#include <memory>
 #include <vector>
 
 #include "maidsafe/common/node_id.h"
@@ -32,7 +33,13 @@ namespace maidsafe {
 
 namespace routing {
 
+// The record held for each peer in the routing tables and returned by their queries.  The public
+// key is only needed when a peer is validated or compared with another, so routing holds it as a
+// shared, immutable handle (see shared_public_key()) rather than by value: copying a NodeInfo
+// copies the handle, not the key.  A copy doesn't carry the deprecated public_key member; if only
+// that was set, the copy's handle holds it instead.
 struct NodeInfo {
+  typedef std::shared_ptr<const asymm::PublicKey> PublicKeyPtr;
   typedef TaggedValue<NonEmptyString, struct SerialisedNodeInfoTag> serialised_type;
 
   NodeInfo();
@@ -44,8 +51,17 @@ struct NodeInfo {
 
   serialised_type Serialise() const;
 
+  // The peer's public key, shared by every copy of this record; null if not known.
+  const PublicKeyPtr& shared_public_key() const { return shared_public_key_; }
+  // Makes a new handle holding a copy of 'key'; where a handle already exists, pass that instead.
+  void set_public_key(const asymm::PublicKey& key);
+  void set_public_key(PublicKeyPtr key);
+
   NodeId id;
   NodeId connection_id;  // Id of a node as far as rudp is concerned
+  // Deprecated: use set_public_key() and shared_public_key().  Routing leaves this empty in the
+  // records it holds and returns, and only reads it (in ZeroStateJoin) if no key has been set.  Not
+  // copied (see above).
   asymm::PublicKey public_key;
   int32_t rank;
   int32_t bucket;
@@ -53,6 +69,11 @@ struct NodeInfo {
   std::vector<int32_t> dimension_list;
 
   static const int32_t kInvalidBucket;
+
+ private:
+  friend void swap(NodeInfo& lhs, NodeInfo& rhs) MAIDSAFE_NOEXCEPT;
+
+  PublicKeyPtr shared_public_key_;
 };
 
 void swap(NodeInfo& lhs, NodeInfo& rhs) MAIDSAFE_NOEXCEPT;
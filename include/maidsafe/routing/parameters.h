@@ -22,6 +22,7 @@
 #include <chrono>
 #include <cstdint>
 #include "boost/date_time/posix_time/posix_time_duration.hpp"
+#include "boost/filesystem/path.hpp"
 
 namespace maidsafe {
 
@@ -61,6 +62,112 @@ struct Parameters {
   static unsigned int firewall_message_life_in_seconds;
   static unsigned int public_key_holding_time;
   static bool caching;
+  // Number of parsed/copied messages kept for reuse, and the largest payload size of a message
+  // which will be kept (see MessagePool).
+  static unsigned int message_pool_size;
+  static uint32_t max_pooled_message_size;
+  // Size in bytes of routing's own cache of responses to cacheable GETs, split over
+  // cache_shard_count shards (see ShardedCache).  The cache also holds at most num_chunks_to_cache
+  // entries.  0 disables it, leaving caching to the upper layer's functors.
+  static uint64_t max_cache_size_in_bytes;
+  static unsigned int cache_shard_count;
+  // If enabled, how often each cacheable GET is seen is estimated (see FrequencySketch) and a
+  // passing response is only cached if its data is requested often enough: for the built-in cache,
+  // more often than the entry it would evict; for the upper layer's functors, at least
+  // cache_admission_threshold times recently.
+  static bool cache_admission;
+  static unsigned int cache_admission_threshold;
+  // Directory of a persistent cache tier (see DiskCache) behind the built-in one, holding up to
+  // max_disk_cache_size_in_bytes in segment files of disk_cache_segment_size.  Each node uses a
+  // subdirectory named after its id.  Empty disables it.
+  static boost::filesystem::path disk_cache_directory;
+  static uint64_t max_disk_cache_size_in_bytes;
+  static uint32_t disk_cache_segment_size;
+  // Writes to, and compaction of, the disk cache run on a thread of its own; at most this many
+  // writes are queued for it, further ones being dropped.
+  static size_t disk_cache_write_queue_size;
+  // If enabled, a cacheable GET which is identical to one already forwarded by this node (same
+  // type, destination and key) is held (up to max_coalesced_gets per such GET) and answered from
+  // the first one's response when that passes back through.  Held requests are forwarded as normal
+  // after coalesced_get_timeout.
+  static bool coalesce_cacheable_gets;
+  static unsigned int max_coalesced_gets;
+  static std::chrono::steady_clock::duration coalesced_get_timeout;
+  // Number of public key fingerprints remembered by each RoutingTable as already validated, so that
+  // a reconnecting peer's key isn't re-validated.  0 disables the cache.
+  static unsigned int validated_public_key_cache_size;
+  // If Functors::request_public_keys is used, key requests are gathered for up to this long, or
+  // until this many distinct nodes are waiting, before being passed to it as one batch.
+  static std::chrono::steady_clock::duration public_key_request_batch_window;
+  static unsigned int max_public_key_request_batch_size;
+  // If enabled, FindNodes and Connect requests are signed on signing_thread_count dedicated threads
+  // (or by the sending thread if 0), and the signature echoed in the response is checked (see
+  // SignatureVerifier) before the response is handled.  The checks run on
+  // signature_verification_threads dedicated threads, and up to signature_verification_cache_size
+  // recently verified signatures are remembered.
+  static bool verify_routing_signatures;
+  static unsigned int signing_thread_count;
+  static unsigned int signature_verification_threads;
+  static unsigned int signature_verification_cache_size;
+  // Number of threads each Routing object dedicates to running application callbacks (see
+  // CallbackExecutor), or that Routing objects sharing an AsioService share.  If 0, callbacks are
+  // run directly on routing's own asio threads.  At most callback_queue_capacity callbacks are
+  // queued for them; beyond that, callbacks are dropped (and counted) rather than let a slow
+  // application stall routing's own threads.
+  static unsigned int callback_thread_count;
+  static unsigned int callback_queue_capacity;
+  // Received messages are queued in lock-free rings of this capacity (see MessageInbox), and
+  // handled in batches of up to message_inbox_batch_size per posted task.  A message arriving at a
+  // full ring is dropped; its sender's ack timeout resends it if needed.
+  static unsigned int message_inbox_capacity;
+  static unsigned int message_inbox_batch_size;
+  // Firewall, Acknowledgement and Timer each split their state over this many independently locked
+  // shards.  Received messages are steered to inbox rings by a hash of their source, so a power of
+  // two keeps each Firewall shard with a single ring.
+  static unsigned int state_shard_count;
+  // Received messages are parsed by decode_thread_count dedicated threads, each inbox ring's
+  // batches then being handled in order on routing's own threads.  If 0, routing's threads parse
+  // them too.
+  static unsigned int decode_thread_count;
+  // Outgoing messages are serialised and handed to rudp by transmit_thread_count dedicated threads,
+  // in batches of up to pipeline_batch_size from a queue of up to pipeline_queue_capacity (see
+  // PipelineStage).  If 0, or if the queue is full, the sending thread does this itself.
+  static unsigned int transmit_thread_count;
+  static unsigned int pipeline_queue_capacity;
+  static unsigned int pipeline_batch_size;
+  // Lost connections reported within this window of the first are dropped from the routing table
+  // together, producing a single RoutingTableChange and CloseNodesChange.  If zero, each is handled
+  // as soon as it is reported.
+  static std::chrono::steady_clock::duration connection_loss_batch_window;
+  // If non-zero, close_nodes_change notifications are held until the close nodes have been stable
+  // for this long, and then reported as one net change (see CloseNodesChangeCoalescer).  However
+  // long the churn lasts, a change is reported within close_nodes_change_max_hold of the first.
+  static std::chrono::steady_clock::duration close_nodes_change_quiet_period;
+  static std::chrono::steady_clock::duration close_nodes_change_max_hold;
+  // Once joined, routing table fill and recovery query up to find_nodes_parallelism of the closest
+  // known nodes at a time (see NodeLookup), abandoning any which don't respond within
+  // find_nodes_response_timeout.  If 0, a single FindNodes is routed to the closest node instead.
+  static unsigned int find_nodes_parallelism;
+  static std::chrono::steady_clock::duration find_nodes_response_timeout;
+  // At most max_concurrent_connect_attempts connect handshakes are run at once, further candidates
+  // being queued and started in order of how much they would improve the routing table (see
+  // ConnectionManager).  An attempt which hasn't completed within connect_attempt_timeout frees
+  // its slot.
+  static unsigned int max_concurrent_connect_attempts;
+  static std::chrono::steady_clock::duration connect_attempt_timeout;
+  // Whether a joining node asks the node closest to it for a routing table's worth of nodes, in a
+  // FindNodes alongside its first, so that it can start connecting to all of those nodes at once.
+  static bool request_routing_table_on_join;
+  // The routing table's members, with when each was last heard from, are saved to the bootstrap
+  // file at most once per routing_table_save_interval while it changes, and when the node stops.
+  // On joining, the node reconnects straight away to those heard from within
+  // max_saved_contact_age.  Zero disables saving.
+  static std::chrono::steady_clock::duration routing_table_save_interval;
+  static std::chrono::system_clock::duration max_saved_contact_age;
+  // Newly found bootstrap contacts are held in memory and written to the bootstrap file together
+  // this long after the first of them is found (see BootstrapContactStore).  If zero, each is
+  // written as it is found.
+  static std::chrono::steady_clock::duration bootstrap_contact_flush_interval;
 
  private:
   Parameters();
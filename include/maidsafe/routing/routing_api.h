@@ -32,6 +32,7 @@
 #define MAIDSAFE_ROUTING_ROUTING_API_H_
 
 #include <condition_variable>
+#include <cstdint>
 #include <future>
 #include <memory>
 #include <mutex>
@@ -73,6 +74,7 @@ class Routing {
  public:
   // create a non-mutating client
   Routing();
+  explicit Routing(const RoutingOptions& options);
 
   // Providing :
   // pmid as a paramater will create a non client routing object(vault).
@@ -84,7 +86,19 @@ class Routing {
     asymm::Keys keys;
     keys.private_key = fob.private_key();
     keys.public_key = fob.public_key();
-    InitialisePimpl(detail::is_client<FobType>::value, NodeId(fob.name()->string()), keys);
+    InitialisePimpl(detail::is_client<FobType>::value, NodeId(fob.name()->string()), keys,
+                    RoutingOptions());
+  }
+
+  // As above, but allows e.g. a shared AsioService or per-object Parameters overrides to be used.
+  template <typename FobType>
+  Routing(const FobType& fob, const RoutingOptions& options)
+      : pimpl_() {
+    asymm::Keys keys;
+    keys.private_key = fob.private_key();
+    keys.public_key = fob.public_key();
+    InitialisePimpl(detail::is_client<FobType>::value, NodeId(fob.name()->string()), keys,
+                    options);
   }
 
   ~Routing();
@@ -146,13 +160,23 @@ class Routing {
   // Checks if client routing table contains given node id
   bool IsConnectedClient(const NodeId& node_id);
 
+  // Returns the number of application callbacks (message received, response, network status, etc.)
+  // which are queued but not yet started.  Always 0 if Parameters::callback_thread_count is 0.
+  // Routing objects sharing an AsioService share a queue, so this and the count below cover all of
+  // them.
+  size_t callback_queue_depth() const;
+  // Returns the number of application callbacks which found that queue full (see
+  // Parameters::callback_queue_capacity), or arrived once routing was stopping, and were dropped.
+  uint64_t callback_queue_overflow_count() const;
+
   friend class test::GenericNode;
 
  private:
   Routing(const Routing&);
   Routing(const Routing&&);
   Routing& operator=(const Routing&);
-  void InitialisePimpl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys);
+  void InitialisePimpl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys,
+                       const RoutingOptions& options);
 
   class Impl;
   std::shared_ptr<Impl> pimpl_;
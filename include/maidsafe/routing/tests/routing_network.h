@@ -81,8 +81,10 @@ class GenericNode {
  public:
   GenericNode(bool client_mode, const rudp::NatType& nat_type);
   explicit GenericNode(bool has_symmetric_nat = false);
-  GenericNode(const passport::Pmid& pmid, bool has_symmetric_nat = false);
-  GenericNode(const passport::Maid& maid, bool has_symmetric_nat = false);
+  GenericNode(const passport::Pmid& pmid, bool has_symmetric_nat = false,
+              const RoutingOptions& options = RoutingOptions());
+  GenericNode(const passport::Maid& maid, bool has_symmetric_nat = false,
+              const RoutingOptions& options = RoutingOptions());
   virtual ~GenericNode();
   int GetStatus() const;
   NodeId node_id() const;
@@ -148,6 +150,9 @@ class GenericNode {
   asymm::PublicKey public_key();
   int Health();
   void SetHealth(int health);
+  // Time from Join() until the routing table first held Parameters::routing_table_ready_to_response
+  // nodes (or as many as expected, if fewer), or zero if it hasn't yet.
+  std::chrono::steady_clock::duration time_to_ready();
   friend class GenericNetwork;
   Functors functors_;
 
@@ -167,6 +172,8 @@ class GenericNode {
 
  private:
   int health_;
+  std::chrono::steady_clock::time_point join_time_;
+  std::chrono::steady_clock::duration time_to_ready_;
   void InitialiseFunctors();
 };
 
@@ -247,6 +254,9 @@ class GenericNetwork {
                                       const NodeId& destination_node_id,
                                       const ExpectedNodeType& destination_node_type = kExpectVault);
   void AddPublicKey(const NodeId& node_id, const asymm::PublicKey& public_key);
+  // Makes all nodes subsequently created from a fob share one AsioService running 'thread_count'
+  // threads, rather than each node creating its own.  Should be called before SetUp().
+  void ShareAsioService(unsigned int thread_count);
 
   friend class NodesEnvironment;
 
@@ -254,7 +264,9 @@ class GenericNetwork {
   unsigned int NonClientNodesSize() const;
   unsigned int NonClientNonSymmetricNatNodesSize() const;
   void AddNodeDetails(NodePtr node);
+  RoutingOptions NodeOptions() const;
 
+  std::shared_ptr<AsioService> shared_asio_service_;
   mutable std::mutex mutex_, fobs_mutex_;
   std::map<NodeId, asymm::PublicKey> public_keys_;
   unsigned int client_index_;
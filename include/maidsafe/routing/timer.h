@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_ROUTING_TIMER_H_
 #define MAIDSAFE_ROUTING_TIMER_H_
 
+#include <atomic>
+#include <cassert>
 #include <condition_variable>
 #include <chrono>
 #include <cstdint>
@@ -27,6 +29,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 #include "boost/asio/steady_timer.hpp"
 #include "boost/asio/error.hpp"
@@ -36,6 +39,8 @@
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/utils.h"
 
+#include "maidsafe/routing/parameters.h"
+
 namespace maidsafe {
 
 namespace routing {
@@ -50,7 +55,10 @@ template <typename Response>
 class Timer {
  public:
   typedef std::function<void(Response)> ResponseFunctor;
-  explicit Timer(AsioService& asio_service);
+  // Tasks are spread by ID over 'shard_count' independently locked shards, so that threads
+  // handling different tasks rarely contend.
+  explicit Timer(AsioService& asio_service,
+                 unsigned int shard_count = Parameters::state_shard_count);
   // Cancels all tasks and blocks until all functors have been executed and all tasks removed.
   ~Timer();
   // Adds a task with a deadline, and returns a unique ID for the task.  'response_functor' will be
@@ -74,10 +82,11 @@ class Timer {
   friend class test::TimerTest;
 
   void PrintTaskIds() {
-    std::lock_guard<std::mutex> lock(mutex_);
     LOG(kVerbose) << "This timer containing following tasks : ";
-    for (auto& task : tasks_) {
-      LOG(kVerbose) << "      task id   ---   " << task.first;
+    for (auto& shard : shards_) {
+      std::lock_guard<std::mutex> lock(shard->mutex);
+      for (auto& task : shard->tasks)
+        LOG(kVerbose) << "      task id   ---   " << task.first;
     }
   }
 
@@ -98,17 +107,25 @@ class Timer {
     Task& operator=(const Task&) = delete;
   };
 
+  struct Shard {
+    Shard() : mutex(), cond_var(), tasks() {}
+    std::mutex mutex;
+    std::condition_variable cond_var;
+    std::map<TaskId, Task> tasks;
+  };
+
   Timer(const Timer&);
   Timer(const Timer&&);
   Timer& operator=(Timer);
 
+  Shard& ShardFor(TaskId task_id) {
+    return *shards_[static_cast<uint32_t>(task_id) % shards_.size()];
+  }
   void FinishTask(TaskId task_id, const boost::system::error_code& error);
 
   AsioService& asio_service_;
-  TaskId new_task_id_;
-  std::mutex mutex_;
-  std::condition_variable cond_var_;
-  std::map<TaskId, Task> tasks_;
+  std::atomic<TaskId> new_task_id_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 // ==================== Implementation =============================================================
@@ -135,8 +152,12 @@ typename Timer<Response>::Task& Timer<Response>::Task::operator=(Task&& other) {
 }
 
 template <typename Response>
-Timer<Response>::Timer(AsioService& asio_service)
-    : asio_service_(asio_service), new_task_id_(RandomInt32()), mutex_(), cond_var_(), tasks_() {}
+Timer<Response>::Timer(AsioService& asio_service, unsigned int shard_count)
+    : asio_service_(asio_service), new_task_id_(RandomInt32()), shards_() {
+  assert(shard_count != 0);
+  for (unsigned int i(0); i != shard_count; ++i)
+    shards_.emplace_back(new Shard);
+}
 
 template <typename Response>
 Timer<Response>::~Timer() {
@@ -148,11 +169,13 @@ Timer<Response>::~Timer() {
 template <typename Response>
 void Timer<Response>::CancelAll() {
   LOG(kVerbose) << "Timer<Response>::CancelAll";
-  std::unique_lock<std::mutex> lock(mutex_);
-  LOG(kVerbose) << "Timer<Response>::CancelAll task count " << tasks_.size();
-  for (const auto& task : tasks_)
-    task.second.timer->cancel();
-  cond_var_.wait(lock, [&] { return tasks_.empty(); });
+  for (auto& shard : shards_) {
+    std::unique_lock<std::mutex> lock(shard->mutex);
+    LOG(kVerbose) << "Timer<Response>::CancelAll task count " << shard->tasks.size();
+    for (const auto& task : shard->tasks)
+      task.second.timer->cancel();
+    shard->cond_var.wait(lock, [&] { return shard->tasks.empty(); });
+  }
   LOG(kVerbose) << "Timer<Response>::CancelAll completed";
 }
 
@@ -168,9 +191,10 @@ void Timer<Response>::AddTask(const std::chrono::steady_clock::duration& timeout
                 << " incorrect expected_response_count";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
   }
-  std::lock_guard<std::mutex> lock(mutex_);
+  Shard& shard(ShardFor(task_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
   LOG(kVerbose) << "Timer<Response>::AddTask process adding task " << task_id;
-  auto result(tasks_.insert(std::move(
+  auto result(shard.tasks.insert(std::move(
       std::make_pair(task_id, std::move(Task(asio_service_.service(), timeout, response_functor,
                                              expected_response_count))))));
   assert(result.second);
@@ -184,11 +208,12 @@ void Timer<Response>::FinishTask(TaskId task_id, const boost::system::error_code
   int outstanding_response_count(0);
   ResponseFunctor functor;
   LOG(kVerbose) << "Timer<Response>::FinishTask finish task " << task_id;
+  Shard& shard(ShardFor(task_id));
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(shard.mutex);
     LOG(kVerbose) << "Timer<Response>::FinishTask process finishing task " << task_id;
-    auto itr(tasks_.find(task_id));
-    if (itr == std::end(tasks_)) {
+    auto itr(shard.tasks.find(task_id));
+    if (itr == std::end(shard.tasks)) {
       LOG(kError) << "Timer<Response>::FinishTask Task " << task_id << " not held by Timer.";
       BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
     }
@@ -200,7 +225,7 @@ void Timer<Response>::FinishTask(TaskId task_id, const boost::system::error_code
       functor = itr->second.functor;
     }
 
-    tasks_.erase(itr);
+    shard.tasks.erase(itr);
 
     switch (error.value()) {
       case boost::system::errc::success:  // Task's timer has expired
@@ -216,17 +241,18 @@ void Timer<Response>::FinishTask(TaskId task_id, const boost::system::error_code
   for (int i(0); i != outstanding_response_count; ++i)
     asio_service_.service().dispatch([=] { functor(Response()); });
   LOG(kVerbose) << "Timer<Response> notifying condition_variable";
-  cond_var_.notify_one();
+  shard.cond_var.notify_one();
   LOG(kVerbose) << "Timer<Response>::FinishTask completed";
 }
 
 template <typename Response>
 void Timer<Response>::CancelTask(TaskId task_id) {
   LOG(kVerbose) << "Timer<Response>::CancelTask task " << task_id << " is to be canceled";
-  std::lock_guard<std::mutex> lock(mutex_);
+  Shard& shard(ShardFor(task_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
   LOG(kVerbose) << "Timer<Response>::CancelTask process cancelling task " << task_id;
-  auto itr(tasks_.find(task_id));
-  if (itr == std::end(tasks_)) {
+  auto itr(shard.tasks.find(task_id));
+  if (itr == std::end(shard.tasks)) {
     LOG(kError) << "Task " << task_id << " not held by Timer.";
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
   }
@@ -239,10 +265,11 @@ void Timer<Response>::AddResponse(TaskId task_id, const Response& response) {
   ResponseFunctor functor;
   LOG(kVerbose) << "Timer<Response>::AddResponse add response to task " << task_id;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
+    Shard& shard(ShardFor(task_id));
+    std::lock_guard<std::mutex> lock(shard.mutex);
     LOG(kVerbose) << "Timer<Response>::AddResponse process adding response to task " << task_id;
-    auto itr(tasks_.find(task_id));
-    if (itr == std::end(tasks_)) {
+    auto itr(shard.tasks.find(task_id));
+    if (itr == std::end(shard.tasks)) {
       LOG(kError) << "Task " << task_id << " not held by Timer.";
       BOOST_THROW_EXCEPTION(MakeError(CommonErrors::no_such_element));
     }
@@ -263,9 +290,6 @@ void Timer<Response>::AddResponse(TaskId task_id, const Response& response) {
 
 template <typename Response>
 TaskId Timer<Response>::NewTaskId() {
-  LOG(kVerbose) << "Timer<Response>::NewTaskId";
-  std::lock_guard<std::mutex> lock(mutex_);
-  LOG(kVerbose) << "Timer<Response>::NewTaskId completed";
   return new_task_id_++;
 }
 
@@ -31,9 +31,14 @@ namespace maidsafe {
 
 namespace routing {
 
-Acknowledgement::Acknowledgement(const NodeId& local_node_id, AsioService& io_service)
-    : kNodeId_(local_node_id), ack_id_(RandomInt32()), mutex_(), stop_handling_(false),
-      io_service_(io_service), queue_(), group_queue_() {}
+Acknowledgement::Acknowledgement(const NodeId& local_node_id, AsioService& io_service,
+                                 unsigned int shard_count)
+    : kNodeId_(local_node_id), ack_id_(RandomInt32()), stop_handling_(false),
+      io_service_(io_service), shards_() {
+  assert(shard_count != 0);
+  for (unsigned int i(0); i != shard_count; ++i)
+    shards_.emplace_back(new Shard);
+}
 
 Acknowledgement::~Acknowledgement() {
   stop_handling_ = true;
@@ -42,9 +47,9 @@ Acknowledgement::~Acknowledgement() {
 
 void Acknowledgement::RemoveAll() {
   std::vector<AckId> ack_ids;
-  {
-    std::lock_guard<std::mutex> lock(mutex_);
-    for (const auto& timer : queue_) {
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (const auto& timer : shard->queue) {
       ack_ids.push_back(timer.ack_id);
     }
   }
@@ -53,41 +58,48 @@ void Acknowledgement::RemoveAll() {
     LOG(kVerbose) << "still in list: " << ack_id;
     Remove(ack_id);
   }
-  for (auto& entry : group_queue_)
-    entry.timer->cancel();
+  for (auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    for (auto& entry : shard->group_queue)
+      entry.timer->cancel();
+  }
+}
+
+Acknowledgement::Shard& Acknowledgement::ShardFor(AckId ack_id) {
+  return *shards_[static_cast<uint32_t>(ack_id) % shards_.size()];
 }
 
 AckId Acknowledgement::GetId() {
-  std::lock_guard<std::mutex> lock(mutex_);
   return ++ack_id_;
 }
 
 void Acknowledgement::Add(const protobuf::Message& message, Handler handler, int timeout) {
-  std::lock_guard<std::mutex> lock(mutex_);
   assert(message.has_ack_id() && "non-existing ack id");
   assert((message.ack_id() != 0) && "invalid ack id");
 
   AckId ack_id(message.ack_id());
-  const auto group_itr(std::find_if(std::begin(group_queue_), std::end(group_queue_),
+  Shard& shard(ShardFor(ack_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  const auto group_itr(std::find_if(std::begin(shard.group_queue), std::end(shard.group_queue),
                        [ack_id](const GroupAckTimer& timer) {
                          return ack_id == timer.ack_id;
                        }));
-  if (group_itr != std::end(group_queue_)) {
+  if (group_itr != std::end(shard.group_queue)) {
     group_itr->requested_peers.insert(
         std::make_pair(NodeId(message.destination_id()), GroupMessageAckStatus::kPending));
     LOG(kVerbose) << "Add group entry " << NodeId(message.destination_id());
     return;
   }
 
-  const auto it(std::find_if(std::begin(queue_), std::end(queue_),
+  const auto it(std::find_if(std::begin(shard.queue), std::end(shard.queue),
                              [ack_id](const AckTimer& timer) {
                                return ack_id == timer.ack_id;
                              }));
-  if (it == std::end(queue_)) {
+  if (it == std::end(shard.queue)) {
     TimerPointer timer(new asio::deadline_timer(io_service_.service(),
                                                 boost::posix_time::seconds(timeout)));
     timer->async_wait(handler);
-    queue_.emplace_back(AckTimer(ack_id, message, timer, 0));
+    shard.queue.emplace_back(AckTimer(ack_id, timer, 0));
     LOG(kVerbose) << "AddAck added an ack, with id: " << ack_id;
   } else {
     LOG(kVerbose) << "Acknowledgement re-sends " << message.id();
@@ -104,46 +116,51 @@ void Acknowledgement::Add(const protobuf::Message& message, Handler handler, int
 }
 
 void Acknowledgement::AddGroup(const protobuf::Message& message, Handler handler, int timeout) {
-  std::lock_guard<std::mutex> lock(mutex_);
   assert(message.has_ack_id() && "non-existing ack id");
   assert((message.ack_id() != 0) && "invalid ack id");
 
   AckId ack_id(message.ack_id());
-  auto const it(std::find_if(std::begin(group_queue_), std::end(group_queue_),
+  Shard& shard(ShardFor(ack_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto const it(std::find_if(std::begin(shard.group_queue), std::end(shard.group_queue),
                              [ack_id](const GroupAckTimer& timer) {
                                return ack_id == timer.ack_id;
                              }));
-  if (it == std::end(group_queue_)) {
+  if (it == std::end(shard.group_queue)) {
     TimerPointer timer(new asio::deadline_timer(io_service_.service(),
                                                 boost::posix_time::seconds(timeout)));
     timer->async_wait(handler);
-    group_queue_.emplace_back(GroupAckTimer(ack_id, message, timer, std::map<NodeId,
-                                            GroupMessageAckStatus>()));
+    shard.group_queue.emplace_back(GroupAckTimer(ack_id, NodeId(message.destination_id()),
+                                                 timer,
+                                                 std::map<NodeId, GroupMessageAckStatus>()));
     LOG(kVerbose) << "AddAck added a group ack, with id: " << ack_id;
   }
 }
 
 void Acknowledgement::Remove(AckId ack_id) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto const it(std::find_if(std::begin(queue_), std::end(queue_),
+  Shard& shard(ShardFor(ack_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto const it(std::find_if(std::begin(shard.queue), std::end(shard.queue),
                              [ack_id] (const AckTimer& timer)->bool {
                                return ack_id == timer.ack_id;
                              }));
-  if (it != std::end(queue_)) {
+  if (it != std::end(shard.queue)) {
     it->timer->cancel();
-    queue_.erase(it);
-    LOG(kVerbose) << "After ack with id: " << ack_id << " queue size: " << queue_.size();
+    shard.queue.erase(it);
+    LOG(kVerbose) << "After ack with id: " << ack_id << " queue size: " << shard.queue.size();
   } else {
-    LOG(kVerbose) << "Non existiing ack id" << ack_id << " queue size: " << queue_.size();
+    LOG(kVerbose) << "Non existiing ack id" << ack_id << " queue size: " << shard.queue.size();
   }
 }
 
 void Acknowledgement::GroupQueueRemove(AckId ack_id) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  group_queue_.erase(std::remove_if(std::begin(group_queue_), std::end(group_queue_),
-                                    [ack_id](const GroupAckTimer& group_ack) {
-                                      return group_ack.ack_id == ack_id;
-                                    }), std::end(group_queue_));
+  Shard& shard(ShardFor(ack_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  shard.group_queue.erase(std::remove_if(std::begin(shard.group_queue),
+                                         std::end(shard.group_queue),
+                                         [ack_id](const GroupAckTimer& group_ack) {
+                                           return group_ack.ack_id == ack_id;
+                                         }), std::end(shard.group_queue));
 }
 
 void Acknowledgement::HandleMessage(AckId ack_id) {
@@ -164,12 +181,13 @@ bool Acknowledgement::HandleGroupMessage(const protobuf::Message& message) {
   assert((ack_id != 0) && "Invalid acknowledgement id");
   LOG(kVerbose) << "MessageHandler::HandleGroupMessage " << ack_id;
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto const it(std::find_if(std::begin(group_queue_), std::end(group_queue_),
+  Shard& shard(ShardFor(ack_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto const it(std::find_if(std::begin(shard.group_queue), std::end(shard.group_queue),
                              [ack_id](const GroupAckTimer& timer) {
                                return ack_id == timer.ack_id;
                              }));
-  if (it == std::end(group_queue_))
+  if (it == std::end(shard.group_queue))
     return false;
 
   auto group_itr(it->requested_peers.find(target_id));
@@ -190,44 +208,45 @@ bool Acknowledgement::HandleGroupMessage(const protobuf::Message& message) {
                     }) == expected) {
     LOG(kVerbose) << "HandleGroupMessage: expected meets: " << ack_id;
     it->timer->cancel();
-    group_queue_.erase(it);
+    shard.group_queue.erase(it);
     return true;
   }
 
   return true;
 }
 
-NodeId Acknowledgement::AppendGroup(AckId ack_id, std::vector<std::string>& exclusion) {
+NodeId Acknowledgement::AppendGroup(AckId ack_id, NodeIdExclusion& exclusion) {
   assert((ack_id != 0) && "Invalid acknowledgement id");
   LOG(kVerbose) << "MessageHandler::AppendGroup " << ack_id;
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto const it(std::find_if(std::begin(group_queue_), std::end(group_queue_),
+  Shard& shard(ShardFor(ack_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto const it(std::find_if(std::begin(shard.group_queue), std::end(shard.group_queue),
                              [ack_id](const GroupAckTimer& timer) {
                                return ack_id == timer.ack_id;
                              }));
-  if (it == std::end(group_queue_)) {
+  if (it == std::end(shard.group_queue)) {
     LOG(kVerbose) << "Not in group queue " << ack_id;
     return NodeId();
   }
-  for (const auto&  peer : it->requested_peers) {
-    if (std::find(std::begin(exclusion), std::end(exclusion),
-                  peer.first.string()) == std::end(exclusion))
-    exclusion.push_back(peer.first.string());
+  for (const auto& peer : it->requested_peers) {
+    if (std::find(std::begin(exclusion), std::end(exclusion), peer.first) == std::end(exclusion))
+      exclusion.push_back(peer.first);
   }
-  return NodeId(it->message.destination_id());
+  return it->group_id;
 }
 
 void Acknowledgement::SetAsFailedPeer(AckId ack_id, const NodeId& node_id) {
   assert((ack_id != 0) && "Invalid acknowledgement id");
   LOG(kVerbose) << "MessageHandler::SetAsFailedPeer " << ack_id;
 
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto const it(std::find_if(std::begin(group_queue_), std::end(group_queue_),
+  Shard& shard(ShardFor(ack_id));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto const it(std::find_if(std::begin(shard.group_queue), std::end(shard.group_queue),
                              [ack_id](const GroupAckTimer& timer) {
                                return ack_id == timer.ack_id;
                              }));
-  if (it == std::end(group_queue_))
+  if (it == std::end(shard.group_queue))
     return;
   auto member(it->requested_peers.find(node_id));
   if (member != it->requested_peers.end())
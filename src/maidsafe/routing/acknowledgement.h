@@ -20,8 +20,10 @@
 #ifndef MAIDSAFE_ROUTING_ACKNOWLEDGEMENT_H_
 #define MAIDSAFE_ROUTING_ACKNOWLEDGEMENT_H_
 
-#include<mutex>
+#include <atomic>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <utility>
 #include <vector>
@@ -31,6 +33,7 @@
 
 #include "maidsafe/routing/api_config.h"
 #include "maidsafe/routing/client_routing_table.h"
+#include "maidsafe/routing/parameters.h"
 #include "maidsafe/routing/routing_table.h"
 #include "maidsafe/rudp/managed_connections.h"
 #include "maidsafe/common/asio_service.h"
@@ -59,30 +62,33 @@ enum class GroupMessageAckStatus {
   kFailure = 2
 };
 
+// The message awaiting acknowledgement is held by the handler which resends it, so it isn't
+// copied into these entries.
 struct AckTimer {
-  AckTimer(AckId ack_id_in, const protobuf::Message& message_in, TimerPointer timer_in,
-           unsigned int quantity_in)
-    : ack_id(ack_id_in), message(message_in), timer(timer_in), quantity(quantity_in) {}
+  AckTimer(AckId ack_id_in, TimerPointer timer_in, unsigned int quantity_in)
+    : ack_id(ack_id_in), timer(timer_in), quantity(quantity_in) {}
   AckId ack_id;
-  protobuf::Message message;
   TimerPointer timer;
   unsigned int quantity;
 };
 
 struct GroupAckTimer {
-  GroupAckTimer(AckId ack_id_in, const protobuf::Message& message_in, TimerPointer timer_in,
+  GroupAckTimer(AckId ack_id_in, const NodeId& group_id_in, TimerPointer timer_in,
                 const std::map<NodeId, GroupMessageAckStatus> requested_peers_in)
-    : ack_id(ack_id_in), message(message_in), timer(timer_in),
+    : ack_id(ack_id_in), group_id(group_id_in), timer(timer_in),
       requested_peers(requested_peers_in) {}
   AckId ack_id;
-  protobuf::Message message;
+  NodeId group_id;
   TimerPointer timer;
   std::map<NodeId, GroupMessageAckStatus> requested_peers;
 };
 
+// Pending acknowledgements are spread by ack ID over independently locked shards, so that threads
+// handling different messages rarely contend.
 class Acknowledgement {
  public:
-  Acknowledgement(const NodeId& local_node_id, AsioService& io_service);
+  Acknowledgement(const NodeId& local_node_id, AsioService& io_service,
+                  unsigned int shard_count = Parameters::state_shard_count);
   Acknowledgement& operator=(const Acknowledgement&) = delete;
   Acknowledgement& operator=(const Acknowledgement&&) = delete;
   Acknowledgement(const Acknowledgement&) = delete;
@@ -98,21 +104,30 @@ class Acknowledgement {
   bool HandleGroupMessage(const protobuf::Message& message);
   bool NeedsAck(const protobuf::Message& message, const NodeId& node_id);
   bool IsSendingAckRequired(const protobuf::Message& message, const NodeId& local_node_id);
-  NodeId AppendGroup(AckId ack_id, std::vector<std::string>& exclusion);
+  NodeId AppendGroup(AckId ack_id, NodeIdExclusion& exclusion);
   void SetAsFailedPeer(AckId ack_id, const NodeId& node_id);
   void AdjustAckHistory(protobuf::Message& message);
   void RemoveAll();
+  // The service on which ack timers run.
+  AsioService& io_service() const { return io_service_; }
 
   friend class test::GenericNode;
 
  private:
+  struct Shard {
+    Shard() : mutex(), queue(), group_queue() {}
+    std::mutex mutex;
+    std::vector<AckTimer> queue;
+    std::vector<GroupAckTimer> group_queue;
+  };
+
+  Shard& ShardFor(AckId ack_id);
+
   const NodeId kNodeId_;
-  AckId ack_id_;
-  std::mutex mutex_;
+  std::atomic<AckId> ack_id_;
   bool stop_handling_;
   AsioService& io_service_;
-  std::vector<AckTimer> queue_;
-  std::vector<GroupAckTimer> group_queue_;
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 }  // namespace routing
@@ -0,0 +1,103 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/bootstrap_contact_store.h"
+
+#include <utility>
+
+#include "boost/exception/diagnostic_information.hpp"
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+BootstrapContactStore::BootstrapContactStore(AsioService& asio_service,
+                                             boost::filesystem::path bootstrap_file_path,
+                                             std::chrono::steady_clock::duration flush_interval)
+    : kBootstrapFilePath_(std::move(bootstrap_file_path)),
+      kFlushInterval_(flush_interval),
+      mutex_(),
+      pending_(),
+      flush_scheduled_(false),
+      timer_(asio_service.service()) {}
+
+BootstrapContactStore::~BootstrapContactStore() {
+  boost::system::error_code error_code;
+  timer_.cancel(error_code);
+  Flush();
+}
+
+void BootstrapContactStore::Add(const BootstrapContact& bootstrap_contact) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    pending_.insert(bootstrap_contact);
+    if (kFlushInterval_ != std::chrono::steady_clock::duration::zero()) {
+      if (flush_scheduled_)
+        return;
+      flush_scheduled_ = true;
+      std::weak_ptr<BootstrapContactStore> this_weak_ptr(shared_from_this());
+      timer_.expires_from_now(kFlushInterval_);
+      timer_.async_wait([this_weak_ptr](const boost::system::error_code& error) {
+        if (auto this_ptr = this_weak_ptr.lock())
+          this_ptr->OnTimeout(error);
+      });
+      return;
+    }
+  }
+  Flush();
+}
+
+void BootstrapContactStore::Flush() {
+  BootstrapContacts bootstrap_contacts;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bootstrap_contacts.assign(std::begin(pending_), std::end(pending_));
+    pending_.clear();
+  }
+  if (bootstrap_contacts.empty())
+    return;
+  try {
+    WriteBootstrapContacts(bootstrap_contacts, kBootstrapFilePath_);
+    LOG(kVerbose) << "Wrote " << bootstrap_contacts.size() << " bootstrap contacts to "
+                  << kBootstrapFilePath_;
+  } catch (const std::exception& error) {
+    LOG(kWarning) << "Failed to write " << bootstrap_contacts.size() << " bootstrap contacts to "
+                  << kBootstrapFilePath_ << " . Error : " << boost::diagnostic_information(error);
+  }
+}
+
+size_t BootstrapContactStore::pending_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return pending_.size();
+}
+
+void BootstrapContactStore::OnTimeout(const boost::system::error_code& error) {
+  if (error == boost::asio::error::operation_aborted)
+    return;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    flush_scheduled_ = false;
+  }
+  Flush();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,72 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_BOOTSTRAP_CONTACT_STORE_H_
+#define MAIDSAFE_ROUTING_BOOTSTRAP_CONTACT_STORE_H_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <set>
+
+#include "boost/asio/steady_timer.hpp"
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
+
+#include "maidsafe/routing/bootstrap_file_operations.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Write-behind cache for a bootstrap file.  Added contacts are held in memory and written in one
+// transaction 'flush_interval' after the first of them was added, rather than each costing a
+// transaction of its own.  Contacts still held are written by Flush() and on destruction.  If
+// 'flush_interval' is zero, each contact is written as it is added.
+class BootstrapContactStore : public std::enable_shared_from_this<BootstrapContactStore> {
+ public:
+  BootstrapContactStore(AsioService& asio_service, boost::filesystem::path bootstrap_file_path,
+                        std::chrono::steady_clock::duration flush_interval);
+  BootstrapContactStore(const BootstrapContactStore&) = delete;
+  BootstrapContactStore(const BootstrapContactStore&&) = delete;
+  BootstrapContactStore& operator=(const BootstrapContactStore&) = delete;
+  BootstrapContactStore& operator=(const BootstrapContactStore&&) = delete;
+  ~BootstrapContactStore();
+
+  void Add(const BootstrapContact& bootstrap_contact);
+  // Writes any contacts held.  Write errors are logged and the contacts dropped.
+  void Flush();
+  size_t pending_count() const;
+
+ private:
+  void OnTimeout(const boost::system::error_code& error);
+
+  const boost::filesystem::path kBootstrapFilePath_;
+  const std::chrono::steady_clock::duration kFlushInterval_;
+  mutable std::mutex mutex_;
+  std::set<BootstrapContact> pending_;
+  bool flush_scheduled_;
+  boost::asio::steady_timer timer_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_BOOTSTRAP_CONTACT_STORE_H_
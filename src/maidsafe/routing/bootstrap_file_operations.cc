@@ -18,6 +18,8 @@
 
 #include "maidsafe/routing/bootstrap_file_operations.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <string>
 
@@ -61,6 +63,17 @@ namespace routing {
 namespace {
 typedef boost::asio::ip::udp::endpoint Endpoint;
 
+#ifdef TESTING
+std::atomic<uint64_t> g_commit_count(0);
+#endif
+
+void Commit(sqlite::Tranasction& transaction) {
+  transaction.Commit();
+#ifdef TESTING
+  ++g_commit_count;
+#endif
+}
+
 boost::asio::ip::udp::endpoint GetEndpoint(const std::string& endpoint) {
   size_t delim = endpoint.rfind(':');
   boost::asio::ip::udp::endpoint ep;
@@ -90,6 +103,16 @@ void PrepareBootstrapTable(sqlite::Database& database) {
   statement.Reset();
 }
 
+void PrepareRoutingTableContactsTable(sqlite::Database& database) {
+  std::string query(
+      "CREATE TABLE IF NOT EXISTS ROUTING_TABLE_CONTACTS("
+      "OWNER_ID TEXT NOT NULL, NODE_ID TEXT NOT NULL, LAST_SEEN TEXT NOT NULL, "
+      "PRIMARY KEY (OWNER_ID, NODE_ID));");
+  sqlite::Statement statement{database, query};
+  statement.Step();
+  statement.Reset();
+}
+
 }  // unnamed namespace
 
 namespace detail {
@@ -104,6 +127,10 @@ boost::filesystem::path DoGetBootstrapFilePath(bool is_client,
   return kLocalFilePath;
 }
 
+#ifdef TESTING
+uint64_t BootstrapFileCommitCount() { return g_commit_count; }
+#endif
+
 }  // namespace detail
 
 void WriteBootstrapContacts(const BootstrapContacts& bootstrap_contacts,
@@ -112,7 +139,7 @@ void WriteBootstrapContacts(const BootstrapContacts& bootstrap_contacts,
   sqlite::Tranasction transaction(database);
   PrepareBootstrapTable(database);
   InsertBootstrapContacts(database, bootstrap_contacts);
-  transaction.Commit();
+  Commit(transaction);
 }
 
 // TODO(Team) : Consider timestamp in forming the list. If offline for more than a week, then
@@ -139,7 +166,57 @@ void InsertOrUpdateBootstrapContact(const BootstrapContact& bootstrap_contact,
   sqlite::Tranasction transaction(database);
   PrepareBootstrapTable(database);
   InsertBootstrapContacts(database, BootstrapContacts(1, bootstrap_contact));
-  transaction.Commit();
+  Commit(transaction);
+}
+
+void WriteRoutingTableContacts(const NodeId& owner_id,
+                               const RoutingTableContacts& routing_table_contacts,
+                               const fs::path& bootstrap_file_path) {
+  const std::string kOwnerId(owner_id.ToStringEncoded(NodeId::EncodingType::kHex));
+  sqlite::Database database(bootstrap_file_path, sqlite::Mode::kReadWriteCreate);
+  sqlite::Tranasction transaction(database);
+  PrepareRoutingTableContactsTable(database);
+  {
+    sqlite::Statement statement{database,
+                                "DELETE FROM ROUTING_TABLE_CONTACTS WHERE OWNER_ID = ?"};
+    statement.BindText(1, kOwnerId);
+    statement.Step();
+    statement.Reset();
+  }
+  sqlite::Statement statement{
+      database,
+      "INSERT OR REPLACE INTO ROUTING_TABLE_CONTACTS (OWNER_ID, NODE_ID, LAST_SEEN) "
+      "VALUES (?, ?, ?)"};
+  for (const auto& contact : routing_table_contacts) {
+    statement.BindText(1, kOwnerId);
+    statement.BindText(2, contact.node_id.ToStringEncoded(NodeId::EncodingType::kHex));
+    statement.BindText(3, std::to_string(std::chrono::duration_cast<std::chrono::seconds>(
+                                             contact.last_seen.time_since_epoch()).count()));
+    statement.Step();
+    statement.Reset();
+  }
+  Commit(transaction);
+}
+
+RoutingTableContacts ReadRoutingTableContacts(const NodeId& owner_id,
+                                              const fs::path& bootstrap_file_path) {
+  sqlite::Database database(bootstrap_file_path, sqlite::Mode::kReadOnly);
+  sqlite::Statement statement{
+      database, "SELECT NODE_ID, LAST_SEEN from ROUTING_TABLE_CONTACTS WHERE OWNER_ID = ?"};
+  statement.BindText(1, owner_id.ToStringEncoded(NodeId::EncodingType::kHex));
+  RoutingTableContacts routing_table_contacts;
+  while (statement.Step() == sqlite::StepResult::kSqliteRow) {
+    RoutingTableContact contact;
+    contact.node_id = NodeId(statement.ColumnText(0), NodeId::EncodingType::kHex);
+    contact.last_seen = std::chrono::system_clock::time_point(
+        std::chrono::seconds(std::stoll(statement.ColumnText(1))));
+    routing_table_contacts.push_back(contact);
+  }
+  std::sort(std::begin(routing_table_contacts), std::end(routing_table_contacts),
+            [](const RoutingTableContact& lhs, const RoutingTableContact& rhs) {
+              return lhs.last_seen > rhs.last_seen;
+            });
+  return routing_table_contacts;
 }
 
 }  // namespace routing
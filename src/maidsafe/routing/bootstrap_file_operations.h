@@ -19,12 +19,16 @@
 #ifndef MAIDSAFE_ROUTING_BOOTSTRAP_FILE_OPERATIONS_H_
 #define MAIDSAFE_ROUTING_BOOTSTRAP_FILE_OPERATIONS_H_
 
+#include <chrono>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "boost/asio/ip/udp.hpp"
 #include "boost/filesystem/path.hpp"
 
+#include "maidsafe/common/node_id.h"
+
 namespace maidsafe {
 
 namespace routing {
@@ -44,6 +48,12 @@ boost::filesystem::path GetDefaultBootstrapFilePath() {
   return DoGetBootstrapFilePath(is_client, "bootstrap.dat");
 }
 
+#ifdef TESTING
+// The number of transactions this process has committed to bootstrap files.  Each costs sqlite at
+// least one sync to disk, so this is what batching writes saves.
+uint64_t BootstrapFileCommitCount();
+#endif
+
 }  // namespace detail
 
 // FIXME(Team) BEFORE_RELEASE add public key and timestamp to BootstrapContact
@@ -59,6 +69,25 @@ BootstrapContacts ReadBootstrapContacts(const boost::filesystem::path& bootstrap
 
 void InsertOrUpdateBootstrapContact(const BootstrapContact& bootstrap_contact,
                                     const boost::filesystem::path& bootstrap_file_path);
+
+// A member of a node's routing table, saved so that the node can reconnect to it after a restart.
+struct RoutingTableContact {
+  NodeId node_id;
+  std::chrono::system_clock::time_point last_seen;
+};
+
+typedef std::vector<RoutingTableContact> RoutingTableContacts;
+
+// Replaces the routing table contacts saved for owner_id (kept in the bootstrap file, alongside any
+// other nodes' contacts) with routing_table_contacts.
+void WriteRoutingTableContacts(const NodeId& owner_id,
+                               const RoutingTableContacts& routing_table_contacts,
+                               const boost::filesystem::path& bootstrap_file_path);
+
+// Returns the routing table contacts saved for owner_id, most recently seen first.
+RoutingTableContacts ReadRoutingTableContacts(const NodeId& owner_id,
+                                              const boost::filesystem::path& bootstrap_file_path);
+
 }  // namespace routing
 
 }  // namespace maidsafe
@@ -77,6 +77,32 @@ void InsertOrUpdateBootstrapContact(const BootstrapContact& bootstrap_contact, b
                                            : detail::GetCurrentBootstrapFilePath<false>());
 }
 
+RoutingTableContacts GetRoutingTableContacts(const NodeId& owner_id, bool is_client) {
+  const fs::path kCurrentBootstrapFilePath{
+    is_client ? detail::GetCurrentBootstrapFilePath<true>()
+              : detail::GetCurrentBootstrapFilePath<false>() };
+  try {
+    return ReadRoutingTableContacts(owner_id, kCurrentBootstrapFilePath);
+  } catch (const std::exception& error) {
+    LOG(kVerbose) << "No saved routing table contacts in : " << kCurrentBootstrapFilePath
+                  << " . Error : " << boost::diagnostic_information(error);
+  }
+  return RoutingTableContacts();
+}
+
+void SaveRoutingTableContacts(const NodeId& owner_id,
+                              const RoutingTableContacts& routing_table_contacts, bool is_client) {
+  const fs::path kCurrentBootstrapFilePath{
+    is_client ? detail::GetCurrentBootstrapFilePath<true>()
+              : detail::GetCurrentBootstrapFilePath<false>() };
+  try {
+    WriteRoutingTableContacts(owner_id, routing_table_contacts, kCurrentBootstrapFilePath);
+  } catch (const std::exception& error) {
+    LOG(kWarning) << "Failed to save routing table contacts to : " << kCurrentBootstrapFilePath
+                  << " . Error : " << boost::diagnostic_information(error);
+  }
+}
+
 BootstrapContacts GetZeroStateBootstrapContacts(udp::endpoint local_endpoint) {
   BootstrapContacts bootstrap_contacts { GetBootstrapContacts(false) };
   bootstrap_contacts.erase(std::remove(std::begin(bootstrap_contacts), std::end(bootstrap_contacts),
@@ -62,6 +62,12 @@ BootstrapContacts GetZeroStateBootstrapContacts(boost::asio::ip::udp::endpoint l
 
 void InsertOrUpdateBootstrapContact(const BootstrapContact& bootstrap_contact, bool is_client);
 
+// As Read/WriteRoutingTableContacts, using the current bootstrap file.  Errors are logged rather
+// than thrown, GetRoutingTableContacts returning no contacts.
+RoutingTableContacts GetRoutingTableContacts(const NodeId& owner_id, bool is_client);
+
+void SaveRoutingTableContacts(const NodeId& owner_id,
+                              const RoutingTableContacts& routing_table_contacts, bool is_client);
 
 }  // namespace routing
 
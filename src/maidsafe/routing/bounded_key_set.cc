@@ -0,0 +1,69 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/bounded_key_set.h"
+
+#include <algorithm>
+
+namespace maidsafe {
+
+namespace routing {
+
+BoundedKeySet::BoundedKeySet(size_t capacity)
+    : kCapacity_(capacity), mutex_(), keys_(), insertion_order_() {}
+
+bool BoundedKeySet::Contains(const std::string& key) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return keys_.count(key) != 0;
+}
+
+bool BoundedKeySet::Insert(const std::string& key) {
+  if (kCapacity_ == 0)
+    return false;
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!keys_.insert(key).second)
+    return false;
+  insertion_order_.push_back(key);
+  if (insertion_order_.size() > kCapacity_) {
+    keys_.erase(insertion_order_.front());
+    insertion_order_.pop_front();
+  }
+  return true;
+}
+
+void BoundedKeySet::Erase(const std::string& key) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (keys_.erase(key) == 0)
+    return;
+  insertion_order_.erase(std::find(std::begin(insertion_order_), std::end(insertion_order_), key));
+}
+
+void BoundedKeySet::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  keys_.clear();
+  insertion_order_.clear();
+}
+
+size_t BoundedKeySet::size() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return keys_.size();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
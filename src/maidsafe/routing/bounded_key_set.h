@@ -0,0 +1,61 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_BOUNDED_KEY_SET_H_
+#define MAIDSAFE_ROUTING_BOUNDED_KEY_SET_H_
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+
+namespace maidsafe {
+
+namespace routing {
+
+// A thread-safe set holding at most 'capacity' keys.  Once full, inserting a new key evicts the
+// oldest one.  Used to remember the results of expensive checks (e.g. public key validation) so
+// that they needn't be repeated for recently seen inputs.  A capacity of 0 disables the set.
+class BoundedKeySet {
+ public:
+  explicit BoundedKeySet(size_t capacity);
+  BoundedKeySet(const BoundedKeySet&) = delete;
+  BoundedKeySet(const BoundedKeySet&&) = delete;
+  BoundedKeySet& operator=(const BoundedKeySet&) = delete;
+  BoundedKeySet& operator=(const BoundedKeySet&&) = delete;
+
+  bool Contains(const std::string& key) const;
+  // Returns false if the key was already present.
+  bool Insert(const std::string& key);
+  void Erase(const std::string& key);
+  void Clear();
+  size_t size() const;
+  size_t capacity() const { return kCapacity_; }
+
+ private:
+  const size_t kCapacity_;
+  mutable std::mutex mutex_;
+  std::unordered_set<std::string> keys_;
+  std::deque<std::string> insertion_order_;  // oldest first
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_BOUNDED_KEY_SET_H_
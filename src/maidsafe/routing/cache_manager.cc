@@ -16,10 +16,12 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
-#include <future>
-
 #include "maidsafe/routing/cache_manager.h"
 
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/make_unique.h"
+#include "maidsafe/common/utils.h"
+
 #include "maidsafe/routing/network.h"
 #include "maidsafe/routing/parameters.h"
 #include "maidsafe/routing/routing.pb.h"
@@ -30,11 +32,76 @@ namespace maidsafe {
 
 namespace routing {
 
-CacheManager::CacheManager(const NodeId& node_id, Network& network)
+namespace {
+
+std::unique_ptr<DiskCache> OpenDiskCache(const NodeId& node_id) {
+  std::unique_ptr<DiskCache> disk_cache;
+  if (Parameters::disk_cache_directory.empty())
+    return disk_cache;
+  try {
+    disk_cache.reset(new DiskCache(
+        Parameters::disk_cache_directory / node_id.ToStringEncoded(NodeId::EncodingType::kHex),
+        Parameters::max_disk_cache_size_in_bytes, Parameters::disk_cache_segment_size));
+  }
+  catch (const std::exception& e) {
+    LOG(kError) << "Failed to open disk cache in " << Parameters::disk_cache_directory << ": "
+                << boost::diagnostic_information(e);
+  }
+  return disk_cache;
+}
+
+// Identifies the data a cacheable GET or PUT of 'type' refers to; a prefix of CoalescingKey().
+std::string DataKey(int32_t type, const std::string& key) {
+  return std::to_string(type) + ':' + std::to_string(key.size()) + ':' + key;
+}
+
+// Only GETs which agree on all of type, destination and key are coalesced.
+std::string CoalescingKey(const protobuf::Message& request) {
+  return DataKey(request.type(), request.data(0)) + request.destination_id();
+}
+
+}  // unnamed namespace
+
+CacheManager::PendingLookup::PendingLookup(boost::asio::io_service& io_service)
+    : request(), completed(false), timer(io_service) {}
+
+CacheManager::InFlightGet::InFlightGet(boost::asio::io_service& io_service)
+    : held(), timer(io_service) {}
+
+CacheManager::CacheManager(const NodeId& node_id, Network& network, AsioService& asio_service)
     : kNodeId_(node_id),
       network_(network),
+      asio_service_(asio_service),
       message_and_caching_functors_(),
-      typed_message_and_caching_functors_() {}
+      typed_message_and_caching_functors_(),
+      cache_(Parameters::max_cache_size_in_bytes == 0
+                 ? nullptr
+                 : new ShardedCache(Parameters::num_chunks_to_cache,
+                                    static_cast<size_t>(Parameters::max_cache_size_in_bytes),
+                                    Parameters::cache_shard_count)),
+      sketch_(Parameters::cache_admission ? new FrequencySketch(Parameters::num_chunks_to_cache)
+                                          : nullptr),
+      disk_cache_(OpenDiskCache(node_id)),
+      disk_writer_(),
+      in_flight_mutex_(),
+      in_flight_gets_(),
+      lifetime_(std::make_shared<Lifetime>()) {
+  if (disk_cache_) {
+    disk_writer_ = maidsafe::make_unique<PipelineStage<std::pair<std::string, std::string>>>(
+        1, Parameters::disk_cache_write_queue_size, Parameters::pipeline_batch_size,
+        [this](std::vector<std::pair<std::string, std::string>>& writes) { WriteToDisk(writes); });
+  }
+}
+
+CacheManager::~CacheManager() {
+  lifetime_->Close();
+  std::lock_guard<std::mutex> lock(in_flight_mutex_);
+  for (auto& in_flight : in_flight_gets_) {
+    boost::system::error_code ignored;
+    in_flight.second->timer.cancel(ignored);
+  }
+  in_flight_gets_.clear();
+}
 
 void CacheManager::InitialiseFunctors(const MessageAndCachingFunctors&
                                       message_and_caching_functors) {
@@ -56,6 +123,27 @@ void CacheManager::InitialiseFunctors(const TypedMessageAndCachingFunctor&
 
 void CacheManager::AddToCache(const protobuf::Message& message) {
 //  assert(!message.request());
+  AnswerCoalescedGets(message);
+  if (message.has_cache_key() && message.data_size() != 0) {
+    if (cache_) {
+      ShardedCache::AdmissionFunctor admit;
+      if (sketch_) {
+        admit = [this](const std::string& candidate_key, const std::string& victim_key) {
+          return sketch_->Frequency(candidate_key) > sketch_->Frequency(victim_key);
+        };
+      }
+      cache_->Put(message.cache_key(), message.data(0), admit);
+    }
+    if (disk_writer_ && Admit(message.cache_key())) {
+      auto write(std::make_pair(message.cache_key(), message.data(0)));
+      if (!disk_writer_->TryPush(write))
+        LOG(kVerbose) << "CacheManager::AddToCache disk writes backed up, not caching on disk";
+    }
+    if (!Admit(message.cache_key())) {
+      LOG(kVerbose) << "CacheManager::AddToCache not caching rarely requested data";
+      return;
+    }
+  }
   if (message_and_caching_functors_.store_cache_data) {
     message_and_caching_functors_.store_cache_data(message.data(0));
   } else {
@@ -88,72 +176,196 @@ void CacheManager::TypedMessageAddtoCache(const protobuf::Message& message) {
 // TODO(Mahmoud): In the current implementation, typed and untyped messages are handled slighlty
 // differently, which needs to become the same after discussions.
 // 1) Typed message cache handling is blocking
-// 2) Untyped message cache handling is blocking, however, there is a deadline of
-//    Parameter::local_retreival_timeout seconds for a reply. If the reply is not received at this
-//    deadline the function returns "false".
+// 2) Untyped message cache handling is asynchronous, with a deadline of
+//    Parameter::local_retreival_timeout for a reply.  If the reply is empty or is not received by
+//    this deadline, the original request is passed on.
 // The advantages of the second approach (the one for untyped messages) are:
 //     a) not allowing a slow node to slows down the flow
 //     b) to customise the timeout in such a way to avoid the potential conflicts with acks.
-bool CacheManager::HandleGetFromCache(protobuf::Message& message) {
+void CacheManager::HandleGetFromCache(protobuf::Message& message, CacheMissFunctor cache_miss) {
   assert(IsRequest(message));
   assert(IsCacheableGet(message));
-  auto cache_hit(std::make_shared<std::promise<bool>>());
-  auto future(cache_hit->get_future());
-  if (message_and_caching_functors_.have_cache_data) {
-    if (IsRequest(message)) {
-      LOG(kVerbose) << " [" << DebugId(kNodeId_) << "] rcvd : "
-                    << MessageTypeString(message) << " from "
-                    << HexSubstr(message.source_id())
-                    << "   (id: " << message.id() << ")  --NodeLevel-- caching";
-      ReplyFunctor response_functor = [=](const std::string& reply_message) {
-          if (reply_message.empty()) {
-            LOG(kVerbose) << "No cache available, passing on the original request";
-            cache_hit->set_value(false);
-            return;
-          }
-
-          LOG(kVerbose) << "Cache contents: " << reply_message;
-
-          //  Responding with cached response
-          protobuf::Message message_out;
-          message_out.set_request(false);
-          message_out.set_ack_id(RandomInt32());
-          message_out.set_hops_to_live(Parameters::hops_to_live);
-          message_out.set_destination_id(message.source_id());
-          message_out.set_type(message.type());
-          message_out.set_direct(true);
-          message_out.clear_data();
-          message_out.set_client_node(message.client_node());
-          message_out.set_routing_message(message.routing_message());
-          message_out.add_data(reply_message);
-          message_out.set_last_id(kNodeId_.string());
-          message_out.set_source_id(kNodeId_.string());
-          if (message.has_cacheable())
-            message_out.set_cacheable(static_cast<int32_t>(Cacheable::kPut));
-          if (message.has_id())
-            message_out.set_id(message.id());
-          else
-            LOG(kInfo) << "Message to be sent back had no ID.";
-
-          if (message.has_relay_id())
-            message_out.set_relay_id(message.relay_id());
-
-          if (message.has_relay_connection_id()) {
-            message_out.set_relay_connection_id(message.relay_connection_id());
-          }
-          network_.SendToClosestNode(message_out);
-          cache_hit->set_value(true);
-      };
-
-      if (message_and_caching_functors_.have_cache_data)
-        message_and_caching_functors_.have_cache_data(message.data(0), response_functor);
-    }
-  } else {
-    return TypedMessageHandleGetFromCache(message);
+  if (sketch_ && message.data_size() != 0)
+    sketch_->Increment(message.data(0));
+  std::string cached_data;
+  if (message.data_size() != 0 && GetCached(message.data(0), cached_data)) {
+    LOG(kVerbose) << " [" << DebugId(kNodeId_) << "] rcvd : " << MessageTypeString(message)
+                  << " from " << HexSubstr(message.source_id()) << "   (id: " << message.id()
+                  << ")  --NodeLevel-- answered from routing cache";
+    SendCachedResponse(message, cached_data);
+    return;
+  }
+
+  if (Parameters::coalesce_cacheable_gets && message.data_size() != 0) {
+    std::shared_ptr<Lifetime> lifetime(lifetime_);
+    cache_miss = [this, lifetime, cache_miss](protobuf::Message& request) {
+      lifetime->Run([&] { ForwardOrHold(request, cache_miss); });
+    };
+  }
+
+  if (!message_and_caching_functors_.have_cache_data) {
+    if (!TypedMessageHandleGetFromCache(message))
+      cache_miss(message);
+    return;
   }
-  if (future.wait_for(Parameters::local_retreival_timeout) != std::future_status::ready)
+
+  LOG(kVerbose) << " [" << DebugId(kNodeId_) << "] rcvd : " << MessageTypeString(message)
+                << " from " << HexSubstr(message.source_id()) << "   (id: " << message.id()
+                << ")  --NodeLevel-- caching";
+  // The request is suspended here until the upper layer replies or the timer expires, whichever
+  // happens first.  A miss resumes it on an asio thread.
+  auto lookup(std::make_shared<PendingLookup>(asio_service_.service()));
+  lookup->request.Swap(&message);
+  // The upper layer may reply, and the timer may fire, after this has been destroyed.
+  std::shared_ptr<Lifetime> lifetime(lifetime_);
+  auto resume([this, lifetime, lookup, cache_miss](const std::string& reply_message) {
+    if (lookup->completed.exchange(true))
+      return;
+    boost::system::error_code ignored;
+    lookup->timer.cancel(ignored);
+    lifetime->Run([&] {
+      if (!reply_message.empty()) {
+        LOG(kVerbose) << "Cache contents: " << reply_message;
+        return SendCachedResponse(lookup->request, reply_message);
+      }
+      LOG(kVerbose) << "No cache available, passing on the original request";
+      asio_service_.service().post([lifetime, lookup, cache_miss] {
+        lifetime->Run([&] { cache_miss(lookup->request); });
+      });
+    });
+  });
+  lookup->timer.expires_from_now(Parameters::local_retreival_timeout);
+  lookup->timer.async_wait([resume](const boost::system::error_code& error_code) {
+    if (error_code != boost::asio::error::operation_aborted)
+      resume(std::string());
+  });
+  message_and_caching_functors_.have_cache_data(lookup->request.data(0), resume);
+}
+
+bool CacheManager::GetCached(const std::string& key, std::string& data) {
+  if (cache_ && cache_->Get(key, data))
+    return true;
+  if (!disk_cache_ || !disk_cache_->Get(key, data))
     return false;
-  return future.get();
+  if (cache_)
+    cache_->Put(key, data);
+  return true;
+}
+
+void CacheManager::WriteToDisk(std::vector<std::pair<std::string, std::string>>& writes) {
+  for (const auto& write : writes) {
+    if (!disk_cache_->Put(write.first, write.second))
+      LOG(kVerbose) << "CacheManager::WriteToDisk entry too large for the disk cache";
+  }
+  if (disk_cache_->NeedsCompaction())
+    disk_cache_->Compact();
+}
+
+bool CacheManager::Admit(const std::string& key) const {
+  return !sketch_ || sketch_->Frequency(key) >= Parameters::cache_admission_threshold;
+}
+
+void CacheManager::ForwardOrHold(protobuf::Message& message, CacheMissFunctor cache_miss) {
+  std::string key(CoalescingKey(message));
+  {
+    std::lock_guard<std::mutex> lock(in_flight_mutex_);
+    auto itr(in_flight_gets_.find(key));
+    if (itr == in_flight_gets_.end()) {
+      auto in_flight(std::make_shared<InFlightGet>(asio_service_.service()));
+      in_flight_gets_.insert(std::make_pair(key, in_flight));
+      in_flight->timer.expires_from_now(Parameters::coalesced_get_timeout);
+      std::shared_ptr<Lifetime> lifetime(lifetime_);
+      in_flight->timer.async_wait([this, lifetime, key,
+                                   in_flight](const boost::system::error_code& error) {
+        if (error != boost::asio::error::operation_aborted)
+          lifetime->Run([&] { ReleaseHeldGets(key, in_flight); });
+      });
+    } else if (itr->second->held.size() < Parameters::max_coalesced_gets) {
+      LOG(kVerbose) << " [" << DebugId(kNodeId_) << "] holding " << MessageTypeString(message)
+                    << " from " << HexSubstr(message.source_id()) << "   (id: " << message.id()
+                    << ") behind identical request in flight";
+      itr->second->held.push_back(std::make_pair(protobuf::Message(), cache_miss));
+      itr->second->held.back().first.Swap(&message);
+      return;
+    }
+  }
+  cache_miss(message);
+}
+
+void CacheManager::ReleaseHeldGets(const std::string& key,
+                                   std::shared_ptr<InFlightGet> in_flight) {
+  {
+    std::lock_guard<std::mutex> lock(in_flight_mutex_);
+    auto itr(in_flight_gets_.find(key));
+    if (itr == in_flight_gets_.end() || itr->second != in_flight)
+      return;
+    in_flight_gets_.erase(itr);
+  }
+  LOG(kVerbose) << "No response for " << in_flight->held.size()
+                << " held request(s), passing them on";
+  for (auto& held : in_flight->held)
+    held.second(held.first);
+}
+
+void CacheManager::AnswerCoalescedGets(const protobuf::Message& response) {
+  if (!response.has_cache_key() || response.data_size() == 0)
+    return;
+  // The response carries the data, so it answers GETs for that data whichever destination they
+  // were sent to.
+  const std::string kDataKey(DataKey(response.type(), response.cache_key()));
+  std::vector<std::shared_ptr<InFlightGet>> answered;
+  {
+    std::lock_guard<std::mutex> lock(in_flight_mutex_);
+    auto itr(in_flight_gets_.lower_bound(kDataKey));
+    while (itr != in_flight_gets_.end() && itr->first.compare(0, kDataKey.size(), kDataKey) == 0) {
+      answered.push_back(itr->second);
+      itr = in_flight_gets_.erase(itr);
+    }
+  }
+  for (const auto& in_flight : answered) {
+    boost::system::error_code ignored;
+    in_flight->timer.cancel(ignored);
+    for (const auto& held : in_flight->held)
+      SendCachedResponse(held.first, response.data(0));
+  }
+}
+
+void CacheManager::SendCachedResponse(const protobuf::Message& request,
+                                      const std::string& data) {
+  protobuf::Message message_out;
+  message_out.set_request(false);
+  message_out.set_ack_id(RandomInt32());
+  message_out.set_hops_to_live(Parameters::hops_to_live);
+  message_out.set_destination_id(request.source_id());
+  message_out.set_type(request.type());
+  message_out.set_direct(true);
+  message_out.clear_data();
+  message_out.set_client_node(request.client_node());
+  message_out.set_routing_message(request.routing_message());
+  message_out.add_data(data);
+  message_out.set_last_id(kNodeId_.string());
+  message_out.set_source_id(kNodeId_.string());
+  if (request.has_cacheable()) {
+    message_out.set_cacheable(static_cast<int32_t>(Cacheable::kPut));
+    if (request.data_size() != 0)
+      message_out.set_cache_key(request.data(0));
+  }
+  if (request.has_id())
+    message_out.set_id(request.id());
+  else
+    LOG(kInfo) << "Message to be sent back had no ID.";
+
+  if (request.has_relay_id())
+    message_out.set_relay_id(request.relay_id());
+
+  if (request.has_relay_connection_id()) {
+    message_out.set_relay_connection_id(request.relay_connection_id());
+  }
+  network_.SendToClosestNode(message_out);
+}
+
+ShardedCache::Statistics CacheManager::statistics() const {
+  return cache_ ? cache_->statistics() : ShardedCache::Statistics();
 }
 
 bool CacheManager::TypedMessageHandleGetFromCache(protobuf::Message& message) {
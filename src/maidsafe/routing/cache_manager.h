@@ -19,41 +19,103 @@
 #ifndef MAIDSAFE_ROUTING_CACHE_MANAGER_H_
 #define MAIDSAFE_ROUTING_CACHE_MANAGER_H_
 
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/asio/io_service.hpp"
+#include "boost/asio/steady_timer.hpp"
+
+#include "maidsafe/common/asio_service.h"
 
 #include "maidsafe/routing/api_config.h"
+#include "maidsafe/routing/disk_cache.h"
+#include "maidsafe/routing/frequency_sketch.h"
+#include "maidsafe/routing/lifetime.h"
+#include "maidsafe/routing/pipeline_stage.h"
+#include "maidsafe/routing/routing.pb.h"
+#include "maidsafe/routing/sharded_cache.h"
 
 namespace maidsafe {
 
 namespace routing {
 
-namespace protobuf {
-class Message;
-}
-
 class Network;
 
 class CacheManager {
  public:
-  CacheManager(const NodeId& node_id, Network& network);
+  typedef std::function<void(protobuf::Message& /*request*/)> CacheMissFunctor;
+
+  CacheManager(const NodeId& node_id, Network& network, AsioService& asio_service);
+  ~CacheManager();
 
   void InitialiseFunctors(const MessageAndCachingFunctors& message_and_caching_functors);
   void InitialiseFunctors(const TypedMessageAndCachingFunctor& typed_message_and_caching_functors);
   void AddToCache(const protobuf::Message& message);
-  bool HandleGetFromCache(protobuf::Message& message);
+  // Answers any requests held behind an identical in-flight GET (see
+  // Parameters::coalesce_cacheable_gets) with 'response', a cacheable put.  Called by AddToCache.
+  void AnswerCoalescedGets(const protobuf::Message& response);
+  // Answers 'message' from the cache if possible, otherwise passes it to 'cache_miss' to be handled
+  // as normal.  This never blocks waiting for the upper layer: if its have_cache_data functor is
+  // used, 'message' is moved from and 'cache_miss' is invoked later on an asio thread, at most
+  // Parameters::local_retreival_timeout after this call.
+  void HandleGetFromCache(protobuf::Message& message, CacheMissFunctor cache_miss);
+  // Statistics of the built-in cache (see Parameters::max_cache_size_in_bytes); all zero if it is
+  // disabled.
+  ShardedCache::Statistics statistics() const;
 
  private:
   CacheManager(const CacheManager&);
   CacheManager(const CacheManager&&);
   CacheManager& operator=(const CacheManager&);
 
+  struct PendingLookup {
+    explicit PendingLookup(boost::asio::io_service& io_service);
+    protobuf::Message request;
+    std::atomic<bool> completed;
+    boost::asio::steady_timer timer;
+  };
+
+  // An identical cacheable GET which has been forwarded and the requests held behind it.
+  struct InFlightGet {
+    explicit InFlightGet(boost::asio::io_service& io_service);
+    std::vector<std::pair<protobuf::Message, CacheMissFunctor>> held;
+    boost::asio::steady_timer timer;
+  };
+
+  // Looks 'key' up in the built-in cache, then the disk cache, promoting disk hits.
+  bool GetCached(const std::string& key, std::string& data);
+  bool Admit(const std::string& key) const;
+  // Runs on disk_writer_'s thread, compacting afterwards if needed.
+  void WriteToDisk(std::vector<std::pair<std::string, std::string>>& writes);
+  void ForwardOrHold(protobuf::Message& message, CacheMissFunctor cache_miss);
+  void ReleaseHeldGets(const std::string& key, std::shared_ptr<InFlightGet> in_flight);
+
   void TypedMessageAddtoCache(const protobuf::Message& message);
   bool TypedMessageHandleGetFromCache(protobuf::Message& message);
+  void SendCachedResponse(const protobuf::Message& request, const std::string& data);
 
   const NodeId kNodeId_;
   Network& network_;
+  AsioService& asio_service_;
   MessageAndCachingFunctors message_and_caching_functors_;
   TypedMessageAndCachingFunctor typed_message_and_caching_functors_;
+  std::unique_ptr<ShardedCache> cache_;
+  std::unique_ptr<FrequencySketch> sketch_;
+  std::unique_ptr<DiskCache> disk_cache_;
+  // Present with disk_cache_, so that disk I/O never runs on the caller's (routing) thread.
+  std::unique_ptr<PipelineStage<std::pair<std::string, std::string>>> disk_writer_;
+  std::mutex in_flight_mutex_;
+  // Keyed by CoalescingKey(), so that all GETs for one piece of data are adjacent.
+  std::map<std::string, std::shared_ptr<InFlightGet>> in_flight_gets_;
+  // Shared with every callback this hands to asio or to the upper layer, since those can run after
+  // this has been destroyed.
+  std::shared_ptr<Lifetime> lifetime_;
 };
 
 }  // namespace routing
@@ -0,0 +1,133 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/callback_executor.h"
+
+#include <algorithm>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+CallbackExecutor::CallbackExecutor(unsigned int thread_count, size_t capacity)
+    : state_(std::make_shared<State>(std::max(capacity, static_cast<size_t>(1)))),
+      threads_mutex_(),
+      threads_() {
+  for (unsigned int i(0); i < std::max(thread_count, 1U); ++i) {
+    std::shared_ptr<State> state(state_);
+    threads_.emplace_back([state] { Run(state); });
+  }
+}
+
+CallbackExecutor::~CallbackExecutor() { Stop(); }
+
+void CallbackExecutor::Stop() {
+  {
+    std::lock_guard<std::mutex> lock(state_->mutex);
+    state_->stopped = true;
+  }
+  state_->condition.notify_all();
+  std::vector<std::thread> threads;
+  {
+    std::lock_guard<std::mutex> lock(threads_mutex_);
+    threads.swap(threads_);
+  }
+  for (auto& thread : threads) {
+    if (thread.get_id() == std::this_thread::get_id())
+      thread.detach();
+    else
+      thread.join();
+  }
+}
+
+void CallbackExecutor::Post(std::function<void()> callback) {
+  Post(state_, std::move(callback), false);
+}
+
+void CallbackExecutor::PostOrdered(std::function<void()> callback) {
+  Post(state_, std::move(callback), true);
+}
+
+void CallbackExecutor::Post(const std::shared_ptr<State>& state, std::function<void()> callback,
+                            bool ordered) {
+  std::lock_guard<std::mutex> lock(state->mutex);
+  if (state->stopped || state->queue_depth() >= state->capacity) {
+    // Running it here instead would stall routing's own thread behind the application.
+    if (state->dropped_count++ % 1000 == 0 && !state->stopped)
+      LOG(kWarning) << "Application callbacks backed up; dropping one";
+    return;
+  }
+  (ordered ? state->ordered_callbacks : state->callbacks).push_back(std::move(callback));
+  state->max_queue_depth = std::max(state->max_queue_depth, state->queue_depth());
+  state->condition.notify_one();
+}
+
+size_t CallbackExecutor::queue_depth() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->queue_depth();
+}
+
+size_t CallbackExecutor::max_queue_depth() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->max_queue_depth;
+}
+
+uint64_t CallbackExecutor::dropped_count() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->dropped_count;
+}
+
+void CallbackExecutor::Run(std::shared_ptr<State> state) {
+  std::unique_lock<std::mutex> lock(state->mutex);
+  for (;;) {
+    auto ordered_ready([&state] {
+      return !state->ordered_running && !state->ordered_callbacks.empty();
+    });
+    state->condition.wait(lock, [&] {
+      return state->stopped || !state->callbacks.empty() || ordered_ready();
+    });
+    // An ordered callback queued behind a running one is left to the thread running that one.
+    const bool ordered(ordered_ready());
+    if (!ordered && state->callbacks.empty())
+      return;  // stopped and drained
+    auto& queue(ordered ? state->ordered_callbacks : state->callbacks);
+    auto callback(std::move(queue.front()));
+    queue.pop_front();
+    if (ordered)
+      state->ordered_running = true;
+    lock.unlock();
+    try {
+      callback();
+    }
+    catch (const std::exception& e) {
+      LOG(kError) << "Application callback threw: " << e.what();
+    }
+    // Released before relocking, as it may hold the last reference to the executor's owner, whose
+    // destruction calls Stop().
+    callback = nullptr;
+    lock.lock();
+    if (ordered)
+      state->ordered_running = false;  // this thread then takes the next, if any
+  }
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,155 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_CALLBACK_EXECUTOR_H_
+#define MAIDSAFE_ROUTING_CALLBACK_EXECUTOR_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/routing/lifetime.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Runs application callbacks on a small pool of its own threads, so that slow user code (e.g. disk
+// I/O in a message handler) can't hold up routing's asio threads and with them the forwarding of
+// everyone else's messages.  At most 'capacity' callbacks are queued; once full, a posted callback
+// is dropped and counted, which bounds the queue's memory without stalling routing behind the
+// application.  On Stop() (or destruction), callbacks already queued are run before the threads
+// are joined; from then on, posted callbacks are dropped.  An executor may be shared by several
+// owners, each wrapping its functors with a Lifetime of its own which it closes on destruction.
+class CallbackExecutor {
+ public:
+  CallbackExecutor(unsigned int thread_count, size_t capacity);
+  CallbackExecutor(const CallbackExecutor&) = delete;
+  CallbackExecutor(const CallbackExecutor&&) = delete;
+  CallbackExecutor& operator=(const CallbackExecutor&) = delete;
+  CallbackExecutor& operator=(const CallbackExecutor&&) = delete;
+  // Calls Stop().
+  ~CallbackExecutor();
+
+  // Queues 'callback', or drops it if the queue is full or this executor has been stopped.  The
+  // caller's thread never runs it.
+  void Post(std::function<void()> callback);
+  // As Post(), but the callbacks posted this way run one at a time, in the order posted.
+  void PostOrdered(std::function<void()> callback);
+  // Returns a functor which posts a call to 'functor' on this executor, or drops it if this
+  // executor has since been destroyed.  If 'lifetime' is given, the call is made through its Run(),
+  // so is also dropped once that has been closed.  Returns null if 'functor' is null.
+  template <typename... Args>
+  std::function<void(Args...)> Wrap(std::function<void(Args...)> functor,
+                                    std::shared_ptr<Lifetime> lifetime = nullptr);
+  // As Wrap(), but the calls are posted by PostOrdered().
+  template <typename... Args>
+  std::function<void(Args...)> WrapOrdered(std::function<void(Args...)> functor,
+                                           std::shared_ptr<Lifetime> lifetime = nullptr);
+  // Runs the callbacks already queued and joins the threads.  If called (directly, or by destroying
+  // the executor) from one of its own callbacks, that thread is left to finish and exit by itself;
+  // it only uses state shared with it, so may safely outlive the executor.
+  void Stop();
+
+  // Number of callbacks queued but not yet started, and the highest this has been.
+  size_t queue_depth() const;
+  size_t max_queue_depth() const;
+  // Number of callbacks dropped because the queue was full or the executor had been stopped.
+  uint64_t dropped_count() const;
+
+ private:
+  // Shared with the threads and with wrapped functors, so that neither depends on the executor
+  // itself still existing.
+  struct State {
+    explicit State(size_t capacity_in)
+        : mutex(),
+          condition(),
+          callbacks(),
+          ordered_callbacks(),
+          ordered_running(false),
+          capacity(capacity_in),
+          max_queue_depth(0),
+          dropped_count(0),
+          stopped(false) {}
+    size_t queue_depth() const { return callbacks.size() + ordered_callbacks.size(); }
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::deque<std::function<void()>> callbacks;
+    // Taken by one thread at a time: whichever has set ordered_running.
+    std::deque<std::function<void()>> ordered_callbacks;
+    bool ordered_running;
+    const size_t capacity;
+    size_t max_queue_depth;
+    uint64_t dropped_count;
+    bool stopped;
+  };
+
+  static void Post(const std::shared_ptr<State>& state, std::function<void()> callback,
+                   bool ordered);
+  static void Run(std::shared_ptr<State> state);
+
+  template <typename... Args>
+  std::function<void(Args...)> Wrap(std::function<void(Args...)> functor,
+                                    std::shared_ptr<Lifetime> lifetime, bool ordered);
+
+  const std::shared_ptr<State> state_;
+  std::mutex threads_mutex_;
+  std::vector<std::thread> threads_;
+};
+
+template <typename... Args>
+std::function<void(Args...)> CallbackExecutor::Wrap(std::function<void(Args...)> functor,
+                                                     std::shared_ptr<Lifetime> lifetime) {
+  return Wrap(functor, lifetime, false);
+}
+
+template <typename... Args>
+std::function<void(Args...)> CallbackExecutor::WrapOrdered(std::function<void(Args...)> functor,
+                                                            std::shared_ptr<Lifetime> lifetime) {
+  return Wrap(functor, lifetime, true);
+}
+
+template <typename... Args>
+std::function<void(Args...)> CallbackExecutor::Wrap(std::function<void(Args...)> functor,
+                                                     std::shared_ptr<Lifetime> lifetime,
+                                                     bool ordered) {
+  if (!functor)
+    return functor;
+  std::weak_ptr<State> state_weak_ptr(state_);
+  return [state_weak_ptr, functor, lifetime, ordered](Args... args) {
+    auto state(state_weak_ptr.lock());
+    if (!state)
+      return;
+    std::function<void()> call(std::bind(functor, args...));
+    if (lifetime)
+      Post(state, [lifetime, call] { lifetime->Run(call); }, ordered);
+    else
+      Post(state, std::move(call), ordered);
+  };
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_CALLBACK_EXECUTOR_H_
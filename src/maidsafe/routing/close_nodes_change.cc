@@ -82,7 +82,8 @@ CloseNodesChange::CloseNodesChange(NodeId this_node_id, const std::vector<NodeId
                             [this](const NodeId & lhs, const NodeId & rhs) {
                               return NodeId::CloserToTarget(lhs, rhs, node_id_);
                             });
-        assert(lost_nodes.size() <= 1);
+        // Several may be lost at once if the change covers a bulk drop (see
+        // RoutingTable::DropNodes); the closest is reported.
         return (lost_nodes.empty()) ? NodeId() : lost_nodes.at(0);
       }()),
       new_node_([this]()->NodeId {
@@ -93,7 +94,6 @@ CloseNodesChange::CloseNodesChange(NodeId this_node_id, const std::vector<NodeId
                             [this](const NodeId& lhs, const NodeId& rhs) {
                               return NodeId::CloserToTarget(lhs, rhs, node_id_);
                             });
-        assert(new_nodes.size() <= 1);
         return (new_nodes.empty())? NodeId() : new_nodes.at(0);
       }()),
       radius_([this]()->crypto::BigInt {
@@ -121,6 +121,26 @@ CloseNodesChange::CloseNodesChange(NodeId this_node_id, const std::vector<NodeId
 #endif
 }
 
+std::vector<NodeId> CloseNodesChange::lost_nodes() const {
+  std::vector<NodeId> lost_nodes;
+  std::set_difference(std::begin(old_close_nodes_), std::end(old_close_nodes_),
+                      std::begin(new_close_nodes_), std::end(new_close_nodes_),
+                      std::back_inserter(lost_nodes), [this](const NodeId& lhs, const NodeId& rhs) {
+                        return NodeId::CloserToTarget(lhs, rhs, node_id_);
+                      });
+  return lost_nodes;
+}
+
+std::vector<NodeId> CloseNodesChange::new_nodes() const {
+  std::vector<NodeId> new_nodes;
+  std::set_difference(std::begin(new_close_nodes_), std::end(new_close_nodes_),
+                      std::begin(old_close_nodes_), std::end(old_close_nodes_),
+                      std::back_inserter(new_nodes), [this](const NodeId& lhs, const NodeId& rhs) {
+                        return NodeId::CloserToTarget(lhs, rhs, node_id_);
+                      });
+  return new_nodes;
+}
+
 CheckHoldersResult CloseNodesChange::CheckHolders(const NodeId& target) const {
   // Handle cases of lower number of group close_nodes nodes
   size_t group_size_adjust(Parameters::group_size + 1U);
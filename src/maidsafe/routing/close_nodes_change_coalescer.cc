@@ -0,0 +1,107 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/close_nodes_change_coalescer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+CloseNodesChangeCoalescer::CloseNodesChangeCoalescer(
+    AsioService& asio_service, std::chrono::steady_clock::duration quiet_period,
+    std::chrono::steady_clock::duration max_hold, CloseNodesChangeFunctor close_nodes_change)
+    : kQuietPeriod_(quiet_period),
+      kMaxHold_(max_hold),
+      close_nodes_change_(std::move(close_nodes_change)),
+      mutex_(),
+      pending_(false),
+      deadline_(),
+      node_id_(),
+      original_close_nodes_(),
+      final_close_nodes_(),
+      timer_(asio_service.service()) {
+  assert(close_nodes_change_);
+}
+
+CloseNodesChangeCoalescer::~CloseNodesChangeCoalescer() {
+  boost::system::error_code error_code;
+  timer_.cancel(error_code);
+}
+
+void CloseNodesChangeCoalescer::Add(std::shared_ptr<CloseNodesChange> close_nodes_change) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto now(std::chrono::steady_clock::now());
+  if (!pending_) {
+    pending_ = true;
+    deadline_ = (kMaxHold_ == std::chrono::steady_clock::duration::zero())
+                    ? std::chrono::steady_clock::time_point::max()
+                    : now + kMaxHold_;
+    node_id_ = close_nodes_change->node_id_;
+    original_close_nodes_ = close_nodes_change->old_close_nodes_;
+  }
+  final_close_nodes_ = close_nodes_change->new_close_nodes_;
+
+  std::weak_ptr<CloseNodesChangeCoalescer> this_weak_ptr(shared_from_this());
+  timer_.expires_at(std::min(now + kQuietPeriod_, deadline_));
+  timer_.async_wait([this_weak_ptr](const boost::system::error_code& error) {
+    if (auto this_ptr = this_weak_ptr.lock())
+      this_ptr->OnTimeout(error);
+  });
+}
+
+void CloseNodesChangeCoalescer::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  pending_ = false;
+  boost::system::error_code error_code;
+  timer_.cancel(error_code);
+}
+
+void CloseNodesChangeCoalescer::OnTimeout(const boost::system::error_code& error) {
+  if (error == boost::asio::error::operation_aborted)
+    return;
+  NodeId node_id;
+  std::vector<NodeId> original_close_nodes, final_close_nodes;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    // The timer may have been restarted by Add() after this wait completed but before it ran.
+    if (!pending_ || timer_.expires_at() > std::chrono::steady_clock::now())
+      return;
+    pending_ = false;
+    node_id = node_id_;
+    original_close_nodes_.swap(original_close_nodes);
+    final_close_nodes_.swap(final_close_nodes);
+  }
+
+  std::sort(std::begin(original_close_nodes), std::end(original_close_nodes));
+  std::sort(std::begin(final_close_nodes), std::end(final_close_nodes));
+  if (original_close_nodes == final_close_nodes) {
+    LOG(kVerbose) << "Close nodes changes cancelled each other out.";
+    return;
+  }
+  close_nodes_change_(std::shared_ptr<CloseNodesChange>(
+      new CloseNodesChange(node_id, original_close_nodes, final_close_nodes)));
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
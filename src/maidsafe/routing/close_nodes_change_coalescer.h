@@ -0,0 +1,79 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_CLOSE_NODES_CHANGE_COALESCER_H_
+#define MAIDSAFE_ROUTING_CLOSE_NODES_CHANGE_COALESCER_H_
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "boost/asio/steady_timer.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/node_id.h"
+
+#include "maidsafe/routing/api_config.h"
+#include "maidsafe/routing/close_nodes_change.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Folds a burst of CloseNodesChanges into one.  Each added change restarts a quiet period; once it
+// elapses with no further change, the functor is invoked with a single change running from the
+// close nodes before the first change of the burst to those after the last.  Nodes which left and
+// rejoined (or joined and left) within the burst are not reported, and nothing is reported if the
+// close nodes end up as they started.  So that continuous churn can't defer the report forever, a
+// non-zero max_hold caps how long after the first change of a burst the report is made.
+class CloseNodesChangeCoalescer
+    : public std::enable_shared_from_this<CloseNodesChangeCoalescer> {
+ public:
+  CloseNodesChangeCoalescer(AsioService& asio_service,
+                            std::chrono::steady_clock::duration quiet_period,
+                            std::chrono::steady_clock::duration max_hold,
+                            CloseNodesChangeFunctor close_nodes_change);
+  CloseNodesChangeCoalescer(const CloseNodesChangeCoalescer&) = delete;
+  CloseNodesChangeCoalescer(const CloseNodesChangeCoalescer&&) = delete;
+  CloseNodesChangeCoalescer& operator=(const CloseNodesChangeCoalescer&) = delete;
+  CloseNodesChangeCoalescer& operator=(const CloseNodesChangeCoalescer&&) = delete;
+  ~CloseNodesChangeCoalescer();
+
+  void Add(std::shared_ptr<CloseNodesChange> close_nodes_change);
+  // Drops any pending change without reporting it.
+  void Cancel();
+
+ private:
+  void OnTimeout(const boost::system::error_code& error);
+
+  const std::chrono::steady_clock::duration kQuietPeriod_, kMaxHold_;
+  const CloseNodesChangeFunctor close_nodes_change_;
+  std::mutex mutex_;
+  bool pending_;
+  std::chrono::steady_clock::time_point deadline_;
+  NodeId node_id_;
+  std::vector<NodeId> original_close_nodes_, final_close_nodes_;
+  boost::asio::steady_timer timer_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_CLOSE_NODES_CHANGE_COALESCER_H_
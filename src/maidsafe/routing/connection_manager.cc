@@ -0,0 +1,165 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/connection_manager.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+ConnectionManager::ConnectionManager(AsioService& asio_service, const NodeId& this_node_id,
+                                     unsigned int max_concurrent, unsigned int max_queued,
+                                     std::chrono::steady_clock::duration attempt_timeout,
+                                     PriorityFunctor priority, AttemptFunctor attempt)
+    : kNodeId_(this_node_id),
+      kMaxConcurrent_(std::max(max_concurrent, 1U)),
+      kMaxQueued_(max_queued),
+      kAttemptTimeout_(attempt_timeout),
+      priority_(std::move(priority)),
+      attempt_(std::move(attempt)),
+      mutex_(),
+      queued_(),
+      in_flight_(),
+      timer_(asio_service.service()) {
+  assert(attempt_);
+}
+
+ConnectionManager::~ConnectionManager() {
+  boost::system::error_code error_code;
+  timer_.cancel(error_code);
+}
+
+bool ConnectionManager::Add(const NodeId& peer) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (in_flight_.count(peer) != 0 ||
+      std::find(std::begin(queued_), std::end(queued_), peer) != std::end(queued_)) {
+    LOG(kVerbose) << "Connect attempt to " << DebugId(peer) << " already pending.";
+    return false;
+  }
+  if (queued_.size() >= kMaxQueued_ && in_flight_.size() >= kMaxConcurrent_) {
+    LOG(kVerbose) << "Connect queue full, dropping " << DebugId(peer);
+    return false;
+  }
+  queued_.push_back(peer);
+  StartAttempts(lock);
+  return true;
+}
+
+void ConnectionManager::Finished(const NodeId& peer) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (in_flight_.erase(peer) == 0)
+    return;
+  StartAttempts(lock);
+}
+
+size_t ConnectionManager::queued_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return queued_.size();
+}
+
+size_t ConnectionManager::in_flight_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return in_flight_.size();
+}
+
+std::vector<NodeId> ConnectionManager::NextAttempts(std::unique_lock<std::mutex>& lock) {
+  assert(lock.owns_lock());
+  static_cast<void>(lock);
+  std::vector<NodeId> attempts;
+  if (queued_.empty() || in_flight_.size() >= kMaxConcurrent_)
+    return attempts;
+
+  std::vector<std::pair<int, NodeId>> ranked;
+  for (const auto& peer : queued_)
+    ranked.emplace_back(priority_ ? priority_(peer) : 0, peer);
+  std::sort(std::begin(ranked), std::end(ranked),
+            [this](const std::pair<int, NodeId>& lhs, const std::pair<int, NodeId>& rhs) {
+              if (lhs.first != rhs.first)
+                return lhs.first > rhs.first;
+              return NodeId::CloserToTarget(lhs.second, rhs.second, kNodeId_);
+            });
+
+  const auto kNow(std::chrono::steady_clock::now());
+  queued_.clear();
+  for (const auto& entry : ranked) {
+    if (in_flight_.size() < kMaxConcurrent_) {
+      in_flight_.insert(std::make_pair(entry.second, kNow));
+      attempts.push_back(entry.second);
+    } else {
+      queued_.push_back(entry.second);
+    }
+  }
+  return attempts;
+}
+
+void ConnectionManager::ArmTimer(std::unique_lock<std::mutex>& lock) {
+  assert(lock.owns_lock());
+  static_cast<void>(lock);
+  if (in_flight_.empty())
+    return;
+  auto earliest(std::min_element(std::begin(in_flight_), std::end(in_flight_),
+                                 [](const std::pair<const NodeId,
+                                                    std::chrono::steady_clock::time_point>& lhs,
+                                    const std::pair<const NodeId,
+                                                    std::chrono::steady_clock::time_point>& rhs) {
+                                   return lhs.second < rhs.second;
+                                 })->second);
+  std::weak_ptr<ConnectionManager> this_weak_ptr(shared_from_this());
+  timer_.expires_at(earliest + kAttemptTimeout_);
+  timer_.async_wait([this_weak_ptr](const boost::system::error_code& error) {
+    if (auto this_ptr = this_weak_ptr.lock())
+      this_ptr->OnTimeout(error);
+  });
+}
+
+void ConnectionManager::OnTimeout(const boost::system::error_code& error) {
+  if (error == boost::asio::error::operation_aborted)
+    return;
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto kNow(std::chrono::steady_clock::now());
+  auto itr(std::begin(in_flight_));
+  while (itr != std::end(in_flight_)) {
+    if (itr->second + kAttemptTimeout_ <= kNow) {
+      LOG(kVerbose) << "Connect attempt to " << DebugId(itr->first) << " timed out.";
+      itr = in_flight_.erase(itr);
+    } else {
+      ++itr;
+    }
+  }
+  // Attempts still in flight need the timer even if no new ones are started.
+  ArmTimer(lock);
+  StartAttempts(lock);
+}
+
+void ConnectionManager::StartAttempts(std::unique_lock<std::mutex>& lock) {
+  auto attempts(NextAttempts(lock));
+  if (!attempts.empty())
+    ArmTimer(lock);
+  lock.unlock();
+  for (const auto& peer : attempts)
+    attempt_(peer);
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,89 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_CONNECTION_MANAGER_H_
+#define MAIDSAFE_ROUTING_CONNECTION_MANAGER_H_
+
+#include <chrono>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "boost/asio/steady_timer.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/node_id.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Schedules connect handshakes to candidate peers, running at most 'max_concurrent' at a time.
+// Candidates wait in a queue of up to 'max_queued' peers and are started highest priority first,
+// the priority functor being evaluated when a slot frees up so that it reflects the routing table
+// at that time.  Equal priorities are started closest to this node first.  A peer is never queued
+// or attempted twice at once.  An attempt ends when Finished() is called for it, or after
+// 'attempt_timeout' if it never is.
+class ConnectionManager : public std::enable_shared_from_this<ConnectionManager> {
+ public:
+  typedef std::function<int(const NodeId& peer)> PriorityFunctor;
+  typedef std::function<void(const NodeId& peer)> AttemptFunctor;
+
+  ConnectionManager(AsioService& asio_service, const NodeId& this_node_id,
+                    unsigned int max_concurrent, unsigned int max_queued,
+                    std::chrono::steady_clock::duration attempt_timeout, PriorityFunctor priority,
+                    AttemptFunctor attempt);
+  ConnectionManager(const ConnectionManager&) = delete;
+  ConnectionManager(const ConnectionManager&&) = delete;
+  ConnectionManager& operator=(const ConnectionManager&) = delete;
+  ConnectionManager& operator=(const ConnectionManager&&) = delete;
+  ~ConnectionManager();
+
+  // Returns false if the peer is already queued or being attempted, or if the queue is full.
+  bool Add(const NodeId& peer);
+  // Ends the attempt to peer (successful or not), letting the next queued peer be attempted.
+  // Unknown peers are ignored.
+  void Finished(const NodeId& peer);
+  size_t queued_count() const;
+  size_t in_flight_count() const;
+
+ private:
+  // Moves the best queued peers into free slots, returning them to be attempted.
+  std::vector<NodeId> NextAttempts(std::unique_lock<std::mutex>& lock);
+  void ArmTimer(std::unique_lock<std::mutex>& lock);
+  void OnTimeout(const boost::system::error_code& error);
+  void StartAttempts(std::unique_lock<std::mutex>& lock);
+
+  const NodeId kNodeId_;
+  const unsigned int kMaxConcurrent_, kMaxQueued_;
+  const std::chrono::steady_clock::duration kAttemptTimeout_;
+  const PriorityFunctor priority_;
+  const AttemptFunctor attempt_;
+  mutable std::mutex mutex_;
+  std::vector<NodeId> queued_;
+  std::map<NodeId, std::chrono::steady_clock::time_point> in_flight_;
+  boost::asio::steady_timer timer_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_CONNECTION_MANAGER_H_
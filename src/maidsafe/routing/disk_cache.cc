@@ -0,0 +1,261 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/disk_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/error.h"
+#include "maidsafe/common/log.h"
+
+namespace fs = boost::filesystem;
+namespace bi = boost::interprocess;
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+const uint32_t kRecordMagic(0x4d534443);  // "MSDC"
+
+struct RecordHeader {
+  uint32_t magic, key_size, value_size;
+};
+
+const uint32_t kHeaderSize(static_cast<uint32_t>(sizeof(RecordHeader)));
+
+uint32_t RecordSize(size_t key_size, size_t value_size) {
+  return kHeaderSize + static_cast<uint32_t>(key_size + value_size);
+}
+
+}  // unnamed namespace
+
+DiskCache::Segment::Segment(const fs::path& path_in, uint32_t size, bool create)
+    : path(path_in), file(), region(), write_offset(0), live_bytes(0) {
+  if (create) {
+    std::ofstream(path.string().c_str(), std::ios::binary | std::ios::trunc);
+    fs::resize_file(path, size);
+  }
+  file = bi::file_mapping(path.string().c_str(), bi::read_write);
+  region = bi::mapped_region(file, bi::read_write);
+}
+
+DiskCache::DiskCache(const fs::path& directory, uint64_t max_size, uint32_t segment_size)
+    : kDirectory_(directory),
+      kSegmentSize_(segment_size),
+      kMaxSegments_(static_cast<size_t>(std::max<uint64_t>(2, max_size / segment_size))),
+      mutex_(),
+      segments_(),
+      index_() {
+  if (kSegmentSize_ <= kHeaderSize)
+    BOOST_THROW_EXCEPTION(MakeError(CommonErrors::invalid_parameter));
+  fs::create_directories(kDirectory_);
+  Load();
+}
+
+DiskCache::~DiskCache() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  for (auto& segment : segments_)
+    segment.second->region.flush();
+}
+
+bool DiskCache::Get(const std::string& key, std::string& value) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto itr(index_.find(key));
+  if (itr == index_.end())
+    return false;
+  const Location& location(itr->second);
+  const char* record(static_cast<const char*>(segments_.at(location.segment)->region.get_address()) +
+                     location.offset);
+  value.assign(record + kHeaderSize + location.key_size, location.value_size);
+  return true;
+}
+
+bool DiskCache::Put(const std::string& key, const std::string& value) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return Append(key, value);
+}
+
+bool DiskCache::NeedsCompaction() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return CompactionCandidate() != 0;
+}
+
+void DiskCache::Compact() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint64_t number(CompactionCandidate());
+  if (number == 0)
+    return;
+  // Copy the live entries out before the segment is removed, since appending them may itself
+  // need to drop the oldest segment.
+  const char* base(static_cast<const char*>(segments_.at(number)->region.get_address()));
+  std::vector<std::pair<std::string, std::string>> live;
+  for (const auto& entry : index_) {
+    if (entry.second.segment != number)
+      continue;
+    const char* record(base + entry.second.offset + kHeaderSize);
+    live.push_back(std::make_pair(entry.first, std::string(record + entry.second.key_size,
+                                                           entry.second.value_size)));
+  }
+  LOG(kVerbose) << "Compacting disk cache segment " << number << ", " << live.size()
+                << " live entries";
+  RemoveSegment(number);
+  for (const auto& entry : live)
+    Append(entry.first, entry.second);
+}
+
+size_t DiskCache::entries() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return index_.size();
+}
+
+size_t DiskCache::segment_count() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return segments_.size();
+}
+
+void DiskCache::Load() {
+  std::vector<uint64_t> numbers;
+  for (fs::directory_iterator itr(kDirectory_); itr != fs::directory_iterator(); ++itr) {
+    if (itr->path().extension() != ".segment")
+      continue;
+    try {
+      numbers.push_back(std::stoull(itr->path().stem().string()));
+    }
+    catch (const std::exception&) {
+      LOG(kWarning) << "Ignoring unexpected file in disk cache: " << itr->path();
+    }
+  }
+  std::sort(numbers.begin(), numbers.end());
+  for (auto number : numbers) {
+    if (number == 0 || fs::file_size(SegmentPath(number)) != kSegmentSize_) {
+      LOG(kWarning) << "Removing disk cache segment of unexpected size: " << SegmentPath(number);
+      fs::remove(SegmentPath(number));
+      continue;
+    }
+    Segment* segment(new Segment(SegmentPath(number), kSegmentSize_, false));
+    segments_.insert(std::make_pair(number, std::unique_ptr<Segment>(segment)));
+    IndexSegment(number, *segment);
+  }
+  while (segments_.size() > kMaxSegments_)
+    RemoveSegment(segments_.begin()->first);
+  LOG(kInfo) << "Loaded " << index_.size() << " entries from " << segments_.size()
+             << " disk cache segments";
+}
+
+void DiskCache::IndexSegment(uint64_t number, Segment& segment) {
+  const char* base(static_cast<const char*>(segment.region.get_address()));
+  uint32_t offset(0);
+  while (offset + kHeaderSize <= kSegmentSize_) {
+    RecordHeader header;
+    std::memcpy(&header, base + offset, kHeaderSize);
+    if (header.magic != kRecordMagic ||
+        static_cast<uint64_t>(header.key_size) + header.value_size > kSegmentSize_ - offset -
+                                                                         kHeaderSize) {
+      break;
+    }
+    Location location = { number, offset, header.key_size, header.value_size };
+    segment.live_bytes += RecordSize(header.key_size, header.value_size);
+    AddToIndex(std::string(base + offset + kHeaderSize, header.key_size), location);
+    offset += RecordSize(header.key_size, header.value_size);
+  }
+  segment.write_offset = offset;
+}
+
+void DiskCache::AddToIndex(const std::string& key, const Location& location) {
+  auto result(index_.insert(std::make_pair(key, location)));
+  if (!result.second) {
+    Location& replaced(result.first->second);
+    auto segment(segments_.find(replaced.segment));
+    if (segment != segments_.end())
+      segment->second->live_bytes -= RecordSize(replaced.key_size, replaced.value_size);
+    replaced = location;
+  }
+}
+
+bool DiskCache::Append(const std::string& key, const std::string& value) {
+  const uint64_t kRecordSize(static_cast<uint64_t>(kHeaderSize) + key.size() + value.size());
+  if (kRecordSize > kSegmentSize_)
+    return false;
+  if (segments_.empty() ||
+      segments_.rbegin()->second->write_offset + kRecordSize > kSegmentSize_) {
+    AddSegment();
+  }
+  const uint64_t kNumber(segments_.rbegin()->first);
+  Segment& segment(*segments_.rbegin()->second);
+  char* record(static_cast<char*>(segment.region.get_address()) + segment.write_offset);
+  std::memcpy(record + kHeaderSize, key.data(), key.size());
+  std::memcpy(record + kHeaderSize + key.size(), value.data(), value.size());
+  RecordHeader header = { kRecordMagic, static_cast<uint32_t>(key.size()),
+                          static_cast<uint32_t>(value.size()) };
+  std::memcpy(record, &header, kHeaderSize);
+
+  Location location = { kNumber, segment.write_offset, header.key_size, header.value_size };
+  segment.write_offset += static_cast<uint32_t>(kRecordSize);
+  segment.live_bytes += static_cast<uint32_t>(kRecordSize);
+  AddToIndex(key, location);
+  return true;
+}
+
+void DiskCache::AddSegment() {
+  while (segments_.size() >= kMaxSegments_)
+    RemoveSegment(segments_.begin()->first);
+  uint64_t number(segments_.empty() ? 1 : segments_.rbegin()->first + 1);
+  segments_.insert(std::make_pair(
+      number, std::unique_ptr<Segment>(new Segment(SegmentPath(number), kSegmentSize_, true))));
+}
+
+void DiskCache::RemoveSegment(uint64_t number) {
+  for (auto itr(index_.begin()); itr != index_.end();) {
+    if (itr->second.segment == number)
+      itr = index_.erase(itr);
+    else
+      ++itr;
+  }
+  auto path(segments_.at(number)->path);
+  segments_.erase(number);
+  boost::system::error_code error_code;
+  fs::remove(path, error_code);
+  if (error_code)
+    LOG(kWarning) << "Failed to remove disk cache segment " << path << ": " << error_code.message();
+}
+
+uint64_t DiskCache::CompactionCandidate() const {
+  if (segments_.size() < 2)
+    return 0;
+  auto newest(segments_.rbegin()->first);
+  for (const auto& segment : segments_) {
+    if (segment.first != newest && segment.second->live_bytes < segment.second->write_offset / 2)
+      return segment.first;
+  }
+  return 0;
+}
+
+fs::path DiskCache::SegmentPath(uint64_t number) const {
+  return kDirectory_ / (std::to_string(number) + ".segment");
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
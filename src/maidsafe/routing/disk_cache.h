@@ -0,0 +1,98 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_DISK_CACHE_H_
+#define MAIDSAFE_ROUTING_DISK_CACHE_H_
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "boost/filesystem/path.hpp"
+#include "boost/interprocess/file_mapping.hpp"
+#include "boost/interprocess/mapped_region.hpp"
+
+namespace maidsafe {
+
+namespace routing {
+
+// A persistent key/value cache held in a directory of fixed-size, memory-mapped segment files.
+// Entries are only ever appended to the newest segment; an in-memory index maps each key to its
+// latest record.  When the cache would exceed its size the oldest segment is dropped as a whole,
+// and segments made mostly of replaced entries can be compacted by copying their live entries
+// forward.  The index is rebuilt from the segments on construction, so the cache survives
+// restarts.  A record is written before its header, so a record torn by a crash is ignored.
+class DiskCache {
+ public:
+  DiskCache(const boost::filesystem::path& directory, uint64_t max_size, uint32_t segment_size);
+  ~DiskCache();
+  DiskCache(const DiskCache&) = delete;
+  DiskCache(const DiskCache&&) = delete;
+  DiskCache& operator=(const DiskCache&) = delete;
+  DiskCache& operator=(const DiskCache&&) = delete;
+
+  // Returns true and sets 'value' if 'key' is cached.
+  bool Get(const std::string& key, std::string& value) const;
+  // Returns false if the entry can't fit in a segment.
+  bool Put(const std::string& key, const std::string& value);
+  // True if an older segment is less than half live data.
+  bool NeedsCompaction() const;
+  // Compacts the oldest such segment.
+  void Compact();
+  size_t entries() const;
+  size_t segment_count() const;
+
+ private:
+  struct Segment {
+    Segment(const boost::filesystem::path& path_in, uint32_t size, bool create);
+    boost::filesystem::path path;
+    boost::interprocess::file_mapping file;
+    boost::interprocess::mapped_region region;
+    uint32_t write_offset, live_bytes;
+  };
+
+  struct Location {
+    uint64_t segment;
+    uint32_t offset, key_size, value_size;
+  };
+
+  void Load();
+  void IndexSegment(uint64_t number, Segment& segment);
+  void AddToIndex(const std::string& key, const Location& location);
+  bool Append(const std::string& key, const std::string& value);
+  void AddSegment();
+  void RemoveSegment(uint64_t number);
+  uint64_t CompactionCandidate() const;
+  boost::filesystem::path SegmentPath(uint64_t number) const;
+
+  const boost::filesystem::path kDirectory_;
+  const uint32_t kSegmentSize_;
+  const size_t kMaxSegments_;
+  mutable std::mutex mutex_;
+  std::map<uint64_t, std::unique_ptr<Segment>> segments_;  // oldest first
+  std::unordered_map<std::string, Location> index_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_DISK_CACHE_H_
@@ -18,7 +18,10 @@
 
 #include "maidsafe/routing/firewall.h"
 
+#include <cassert>
+
 #include "maidsafe/routing/parameters.h"
+#include "maidsafe/routing/utils.h"
 
 namespace maidsafe {
 
@@ -29,37 +32,41 @@ bool operator < (const Firewall::ProcessedEntry& lhs, const Firewall::ProcessedE
                                             : lhs.message_id < rhs.message_id;
 }
 
-Firewall::Firewall()
-    : mutex_(), history_() {}
+Firewall::Firewall(unsigned int shard_count) : shards_() {
+  assert(shard_count != 0);
+  for (unsigned int i(0); i != shard_count; ++i)
+    shards_.emplace_back(new Shard);
+}
 
 bool Firewall::Add(const NodeId& source_id, int32_t message_id) {
   if (source_id.IsZero())
     return false;
 
-  std::unique_lock<std::mutex> lock(mutex_);
+  Shard& shard(*shards_[ShardIndex(source_id.string(), shards_.size())]);
+  std::unique_lock<std::mutex> lock(shard.mutex);
   auto entry(ProcessedEntry(source_id, message_id));
-  auto found(history_.find(entry));
-  if (found != std::end(history_))
+  auto found(shard.history.find(entry));
+  if (found != std::end(shard.history))
     return false;
 
-  history_.insert(entry);
-  if (history_.size() % Parameters::firewall_history_cleanup_factor == 0)
-    Remove(lock);
+  shard.history.insert(entry);
+  if (shard.history.size() % Parameters::firewall_history_cleanup_factor == 0)
+    Remove(shard, lock);
 
   return true;
 }
 
-void Firewall::Remove(std::unique_lock<std::mutex>& lock) {
+void Firewall::Remove(Shard& shard, std::unique_lock<std::mutex>& lock) {
   assert(lock.owns_lock());
   static_cast<void>(lock);
   ProcessedEntry dummy(NodeId(NodeId::IdType::kRandomId), RandomInt32());
   auto upper(std::upper_bound(
-      std::begin(history_), std::end(history_), dummy,
+      std::begin(shard.history), std::end(shard.history), dummy,
       [this](const ProcessedEntry& lhs, const ProcessedEntry& rhs) {
         return (lhs.birth_time - rhs.birth_time < Parameters::firewall_message_life_in_seconds);
       }));
-  if (upper != std::end(history_))
-    history_.erase(std::begin(history_), upper);
+  if (upper != std::end(shard.history))
+    shard.history.erase(std::begin(shard.history), upper);
 }
 
 
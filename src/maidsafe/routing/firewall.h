@@ -21,6 +21,10 @@
 
 #include <time.h>
 
+#include <memory>
+#include <mutex>
+#include <vector>
+
 #include "boost/multi_index_container.hpp"
 #include "boost/multi_index/global_fun.hpp"
 #include "boost/multi_index/mem_fun.hpp"
@@ -28,6 +32,7 @@
 #include "boost/multi_index/identity.hpp"
 
 #include "maidsafe/routing/api_config.h"
+#include "maidsafe/routing/parameters.h"
 
 namespace maidsafe {
 
@@ -38,16 +43,18 @@ namespace test {
   class FirewallTest_BEH_AddRemove_Test;
 }
 
+// Remembers which messages have been processed recently.  Entries are spread over independently
+// locked shards by a hash of the source id (see ShardIndex()).  Received messages are steered to
+// MessageInbox rings by the same hash, so a shard's lock is normally only taken by one worker.
 class Firewall {
  public:
-  Firewall();
+  explicit Firewall(unsigned int shard_count = Parameters::state_shard_count);
   Firewall& operator=(const Firewall&) = delete;
   Firewall& operator=(const Firewall&&) = delete;
   Firewall(const Firewall&) = delete;
   Firewall(const Firewall&&) = delete;
 
   bool Add(const NodeId& source_id, int32_t message_id);
-  void Remove(std::unique_lock<std::mutex>& lock);
 
   struct ProcessedEntry {
     ProcessedEntry(const NodeId& source_in, int32_t messsage_id_in)
@@ -71,8 +78,15 @@ class Firewall {
     >
   > ProcessedEntrySet;
 
-  std::mutex mutex_;
-  ProcessedEntrySet history_;
+  struct Shard {
+    Shard() : mutex(), history() {}
+    std::mutex mutex;
+    ProcessedEntrySet history;
+  };
+
+  void Remove(Shard& shard, std::unique_lock<std::mutex>& lock);
+
+  std::vector<std::unique_ptr<Shard>> shards_;
 };
 
 bool operator > (const Firewall::ProcessedEntry& lhs, const Firewall::ProcessedEntry& rhs);
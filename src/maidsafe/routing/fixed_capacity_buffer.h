@@ -0,0 +1,107 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_FIXED_CAPACITY_BUFFER_H_
+#define MAIDSAFE_ROUTING_FIXED_CAPACITY_BUFFER_H_
+
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+#include "maidsafe/common/node_id.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// A sequence of at most Capacity elements stored inline, i.e. without any heap allocation of its
+// own.  Elements are only constructed when they are added, so an empty buffer costs nothing to
+// create on the stack.
+template <typename T, std::size_t Capacity>
+class FixedCapacityBuffer {
+ public:
+  typedef T value_type;
+  typedef T* iterator;
+  typedef const T* const_iterator;
+
+  FixedCapacityBuffer() : size_(0) {}
+  FixedCapacityBuffer(const FixedCapacityBuffer& other) : size_(0) {
+    for (const auto& element : other)
+      push_back(element);
+  }
+  FixedCapacityBuffer& operator=(const FixedCapacityBuffer& other) {
+    if (this != &other) {
+      clear();
+      for (const auto& element : other)
+        push_back(element);
+    }
+    return *this;
+  }
+  ~FixedCapacityBuffer() { clear(); }
+
+  // Returns false, and leaves the buffer unchanged, if it is already full.
+  bool push_back(const T& element) {
+    if (full())
+      return false;
+    new (&storage_[size_]) T(element);
+    ++size_;
+    return true;
+  }
+  void clear() {
+    while (size_ != 0)
+      data()[--size_].~T();
+  }
+
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return Capacity; }
+  bool empty() const { return size_ == 0; }
+  bool full() const { return size_ == Capacity; }
+
+  T& operator[](std::size_t index) {
+    assert(index < size_);
+    return data()[index];
+  }
+  const T& operator[](std::size_t index) const {
+    assert(index < size_);
+    return data()[index];
+  }
+
+  iterator begin() { return data(); }
+  iterator end() { return data() + size_; }
+  const_iterator begin() const { return data(); }
+  const_iterator end() const { return data() + size_; }
+
+ private:
+  T* data() { return reinterpret_cast<T*>(&storage_[0]); }
+  const T* data() const { return reinterpret_cast<const T*>(&storage_[0]); }
+
+  typename std::aligned_storage<sizeof(T), std::alignment_of<T>::value>::type storage_[Capacity];
+  std::size_t size_;
+};
+
+// Nodes to skip when choosing the next hop for a message: its route history plus any group members
+// it has already been sent to.  Sized for Parameters::max_route_history + Parameters::group_size
+// with room to spare; ids which don't fit are simply not excluded.
+typedef FixedCapacityBuffer<NodeId, 16> NodeIdExclusion;
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_FIXED_CAPACITY_BUFFER_H_
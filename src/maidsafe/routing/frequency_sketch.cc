@@ -0,0 +1,93 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/frequency_sketch.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace {
+
+size_t NextPowerOfTwo(size_t value) {
+  size_t result(1);
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+}  // unnamed namespace
+
+const unsigned int FrequencySketch::kDepth_;
+const uint8_t FrequencySketch::kMaxCount_;
+
+FrequencySketch::FrequencySketch(size_t expected_entries)
+    : kWidth_(NextPowerOfTwo(std::max<size_t>(16, expected_entries * 4))),
+      kSampleSize_(std::max<size_t>(16, expected_entries) * 10),
+      mutex_(),
+      counters_(kWidth_ * kDepth_, 0),
+      samples_(0) {}
+
+void FrequencySketch::Increment(const std::string& key) {
+  const size_t kHash(std::hash<std::string>()(key));
+  std::lock_guard<std::mutex> lock(mutex_);
+  // Conservative update: only the smallest counters are raised, which reduces over-estimation.
+  uint8_t minimum(kMaxCount_);
+  for (unsigned int row(0); row != kDepth_; ++row)
+    minimum = std::min(minimum, counters_[Index(kHash, row)]);
+  if (minimum != kMaxCount_) {
+    for (unsigned int row(0); row != kDepth_; ++row) {
+      uint8_t& counter(counters_[Index(kHash, row)]);
+      if (counter == minimum)
+        ++counter;
+    }
+  }
+  if (++samples_ == kSampleSize_)
+    Age();
+}
+
+unsigned int FrequencySketch::Frequency(const std::string& key) const {
+  const size_t kHash(std::hash<std::string>()(key));
+  std::lock_guard<std::mutex> lock(mutex_);
+  uint8_t minimum(kMaxCount_);
+  for (unsigned int row(0); row != kDepth_; ++row)
+    minimum = std::min(minimum, counters_[Index(kHash, row)]);
+  return minimum;
+}
+
+size_t FrequencySketch::Index(size_t hash, unsigned int row) const {
+  // Each row uses a different odd multiplier to derive an independent-enough index from one hash.
+  static const uint64_t kSeeds[kDepth_] = { 0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL,
+                                            0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL };
+  uint64_t mixed((static_cast<uint64_t>(hash) + row) * kSeeds[row]);
+  mixed ^= mixed >> 32;
+  return row * kWidth_ + static_cast<size_t>(mixed & (kWidth_ - 1));
+}
+
+void FrequencySketch::Age() {
+  for (auto& counter : counters_)
+    counter >>= 1;
+  samples_ /= 2;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
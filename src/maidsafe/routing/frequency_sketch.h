@@ -0,0 +1,66 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_FREQUENCY_SKETCH_H_
+#define MAIDSAFE_ROUTING_FREQUENCY_SKETCH_H_
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace maidsafe {
+
+namespace routing {
+
+// A count-min sketch estimating how often each key has been seen recently, in a fixed amount of
+// memory (one byte per counter, kDepth_ rows of 'width' counters).  Counters saturate at
+// kMaxCount_ and, once 'sample_size' keys have been recorded, all are halved so that the estimates
+// follow changes in popularity.  Used for TinyLFU-style cache admission: a new entry is only worth
+// caching if it is seen more often than the entry it would replace.
+class FrequencySketch {
+ public:
+  // 'expected_entries' is roughly the number of entries in the cache being guarded.
+  explicit FrequencySketch(size_t expected_entries);
+  FrequencySketch(const FrequencySketch&) = delete;
+  FrequencySketch(const FrequencySketch&&) = delete;
+  FrequencySketch& operator=(const FrequencySketch&) = delete;
+  FrequencySketch& operator=(const FrequencySketch&&) = delete;
+
+  void Increment(const std::string& key);
+  unsigned int Frequency(const std::string& key) const;
+  size_t size_in_bytes() const { return counters_.size(); }
+
+ private:
+  static const unsigned int kDepth_ = 4;
+  static const uint8_t kMaxCount_ = 15;
+
+  size_t Index(size_t hash, unsigned int row) const;
+  void Age();
+
+  const size_t kWidth_, kSampleSize_;
+  mutable std::mutex mutex_;
+  std::vector<uint8_t> counters_;
+  size_t samples_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_FREQUENCY_SKETCH_H_
@@ -0,0 +1,63 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/lifetime.h"
+
+#include <algorithm>
+
+namespace maidsafe {
+
+namespace routing {
+
+Lifetime::Lifetime() : mutex_(), condition_(), alive_(true), running_() {}
+
+void Lifetime::Run(const std::function<void()>& functor) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!alive_)
+      return;
+    running_.push_back(std::this_thread::get_id());
+  }
+  try {
+    functor();
+  } catch (...) {
+    Leave();
+    throw;
+  }
+  Leave();
+}
+
+void Lifetime::Close() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  alive_ = false;
+  const auto this_thread(std::this_thread::get_id());
+  condition_.wait(lock, [&] {
+    return std::all_of(running_.begin(), running_.end(),
+                       [&](const std::thread::id& id) { return id == this_thread; });
+  });
+}
+
+void Lifetime::Leave() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  running_.erase(std::find(running_.begin(), running_.end(), std::this_thread::get_id()));
+  condition_.notify_all();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,64 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_LIFETIME_H_
+#define MAIDSAFE_ROUTING_LIFETIME_H_
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace maidsafe {
+
+namespace routing {
+
+// Lets callbacks which can outlive their owner (asio handlers, the upper layer's reply functors)
+// safely call back into it.  The owner shares a Lifetime with each such callback, which does its
+// work through Run(), and calls Close() on destruction.  Close() waits for callbacks already inside
+// Run(); after it, Run() does nothing.
+class Lifetime {
+ public:
+  Lifetime();
+  Lifetime(const Lifetime&) = delete;
+  Lifetime(const Lifetime&&) = delete;
+  Lifetime& operator=(const Lifetime&) = delete;
+  Lifetime& operator=(const Lifetime&&) = delete;
+
+  // Calls 'functor' unless Close() has been called, holding off Close() until it returns.  Calls
+  // may be nested.
+  void Run(const std::function<void()>& functor);
+  // If called from within Run(), waits only for other threads' calls.
+  void Close();
+
+ private:
+  void Leave();
+
+  std::mutex mutex_;
+  std::condition_variable condition_;
+  bool alive_;
+  // One entry per call inside Run().
+  std::vector<std::thread::id> running_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_LIFETIME_H_
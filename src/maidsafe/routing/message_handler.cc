@@ -18,6 +18,10 @@
 
 #include "maidsafe/routing/message_handler.h"
 
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #include "maidsafe/common/log.h"
@@ -46,14 +50,38 @@ MessageHandler::MessageHandler(RoutingTable& routing_table,
       network_(network),
       cache_manager_(routing_table_.client_mode()
                          ? nullptr
-                         : (new CacheManager(routing_table_.kNodeId(), network_))),
+                         : (new CacheManager(routing_table_.kNodeId(), network_, asio_service))),
       timer_(timer),
       public_key_holder_(asio_service, network),
+      public_key_request_batcher_(std::make_shared<PublicKeyRequestBatcher>(asio_service)),
       response_handler_(new ResponseHandler(routing_table, client_routing_table, network_,
                                             public_key_holder_)),
       service_(new Service(routing_table, client_routing_table, network_, public_key_holder_)),
       message_received_functor_(),
-      typed_message_received_functors_() {}
+      typed_message_received_functors_(),
+      caching_(Parameters::caching),
+      post_functor_([&asio_service](std::function<void()> handler) {
+        asio_service.service().post(handler);
+      }),
+      verified_messages_mutex_(),
+      verified_messages_(),
+      draining_verified_messages_(false),
+      kPublicKey_(Parameters::verify_routing_signatures
+                      ? std::make_shared<asymm::PublicKey>(routing_table_.kPublicKey())
+                      : nullptr),
+      signature_verifier_(Parameters::verify_routing_signatures
+                              ? new SignatureVerifier(Parameters::signature_verification_threads,
+                                                      Parameters::signature_verification_cache_size)
+                              : nullptr) {
+  response_handler_->ManageConnectAttempts(asio_service);
+}
+
+MessageHandler::~MessageHandler() {
+  // A late upper-layer reply or cache timer can still resume a request in DispatchMessage(), so the
+  // verifier and then the cache go before the handlers they call into.
+  signature_verifier_.reset();
+  cache_manager_.reset();
+}
 
 void MessageHandler::HandleRoutingMessage(protobuf::Message& message) {
   bool request(message.request());
@@ -103,7 +131,7 @@ void MessageHandler::HandleRoutingMessage(protobuf::Message& message) {
     network_.SendToDirect(message, network_.bootstrap_connection_id(),
                           network_.bootstrap_connection_id());
   else
-    network_.SendToClosestNode(message);
+    network_.SendToClosestNode(std::move(message));
 }
 
 void MessageHandler::HandleNodeLevelMessageForThisNode(protobuf::Message& message) {
@@ -113,50 +141,58 @@ void MessageHandler::HandleNodeLevelMessageForThisNode(protobuf::Message& messag
                   << "] rcvd : " << MessageTypeString(message) << " from "
                   << HexSubstr(message.source_id()) << "   (id: " << message.id()
                   << ")  --NodeLevel--";
-    ReplyFunctor response_functor = [=](const std::string & reply_message) {
+    // The reply only needs the request's header, so the payload isn't kept alive by the functor.
+    std::shared_ptr<const protobuf::Message> request(CopyHeader(message));
+    std::string cache_key((IsCacheableGet(message) && message.data_size() != 0) ? message.data(0)
+                                                                              : std::string());
+    ReplyFunctor response_functor = [request, cache_key, this](const std::string& reply_message) {
       if (reply_message.empty()) {
-        LOG(kInfo) << "Empty response for message id :" << message.id();
+        LOG(kInfo) << "Empty response for message id :" << request->id();
         return;
       }
       LOG(kSuccess) << " [" << routing_table_.kNodeId() << "] repl : "
-                    << MessageTypeString(message) << " from " << HexSubstr(message.source_id())
-                    << "   (id: " << message.id() << ")  --NodeLevel Replied--";
+                    << MessageTypeString(*request) << " from " << HexSubstr(request->source_id())
+                    << "   (id: " << request->id() << ")  --NodeLevel Replied--";
       protobuf::Message message_out;
       message_out.set_request(false);
       message_out.set_ack_id(RandomUint32());
       message_out.set_hops_to_live(Parameters::hops_to_live);
-      message_out.set_destination_id(message.source_id());
-      message_out.set_type(message.type());
+      message_out.set_destination_id(request->source_id());
+      message_out.set_type(request->type());
       message_out.set_direct(true);
       message_out.clear_data();
-      message_out.set_client_node(message.client_node());
-      message_out.set_routing_message(message.routing_message());
+      message_out.set_client_node(request->client_node());
+      message_out.set_routing_message(request->routing_message());
       message_out.add_data(reply_message);
-      if (IsCacheableGet(message))
+      if (IsCacheableGet(*request)) {
         message_out.set_cacheable(static_cast<int32_t>(Cacheable::kPut));
+        message_out.set_cache_key(cache_key);
+        if (cache_manager_)
+          cache_manager_->AnswerCoalescedGets(message_out);
+      }
       message_out.set_last_id(routing_table_.kNodeId().string());
       message_out.set_source_id(routing_table_.kNodeId().string());
       message_out.set_ack_id(network_utils_.acknowledgement_.GetId());
-      if (message.has_id())
-        message_out.set_id(message.id());
+      if (request->has_id())
+        message_out.set_id(request->id());
       else
         LOG(kInfo) << "Message to be sent back had no ID.";
 
-      if (message.has_relay_id())
-        message_out.set_relay_id(message.relay_id());
+      if (request->has_relay_id())
+        message_out.set_relay_id(request->relay_id());
 
-      if (message.has_relay_connection_id()) {
-        message_out.set_relay_connection_id(message.relay_connection_id());
+      if (request->has_relay_connection_id()) {
+        message_out.set_relay_connection_id(request->relay_connection_id());
       }
       if (routing_table_.client_mode() &&
           routing_table_.kNodeId().string() == message_out.destination_id()) {
-        network_.SendToClosestNode(message_out);
+        network_.SendToClosestNode(std::move(message_out));
         return;
       }
       if (routing_table_.kNodeId().string() != message_out.destination_id()) {
-        network_.SendToClosestNode(message_out);
+        network_.SendToClosestNode(std::move(message_out));
       } else {
-        LOG(kInfo) << "Sending response to self." << " id: " << message.id();
+        LOG(kInfo) << "Sending response to self." << " id: " << request->id();
         HandleMessage(message_out);
       }
     };
@@ -226,10 +262,10 @@ void MessageHandler::HandleDirectMessageAsClosestNode(protobuf::Message& message
   if (routing_table_.IsThisNodeClosestTo(destination_node_id)) {
     if (routing_table_.Contains(destination_node_id) ||
         client_routing_table_.Contains(destination_node_id)) {
-      return network_.SendToClosestNode(message);
+      return network_.SendToClosestNode(std::move(message));
     } else if (!message.has_visited() || !message.visited()) {
       message.set_visited(true);
-      return network_.SendToClosestNode(message);
+      return network_.SendToClosestNode(std::move(message));
     } else {
       network_utils_.acknowledgement_.AdjustAckHistory(message);
       network_.SendAck(message);
@@ -247,7 +283,7 @@ void MessageHandler::HandleDirectMessageAsClosestNode(protobuf::Message& message
     // else if (IsCacheableResponse(message))
     //   StoreCacheCopy(message);  //  Upper layer should take this on seperate thread
 
-    return network_.SendToClosestNode(message);
+    return network_.SendToClosestNode(std::move(message));
   }
 }
 
@@ -265,7 +301,7 @@ void MessageHandler::HandleGroupMessageAsClosestNode(protobuf::Message& message)
     //   return HandleCacheLookup(message);  // forwarding message is done by cache manager
     // else if (IsCacheableResponse(message))
     //   StoreCacheCopy(message);  // Upper layer should take this on seperate thread
-    return network_.SendToClosestNode(message);
+    return network_.SendToClosestNode(std::move(message));
   }
 
   if (message.has_visited() && !message.visited() &&
@@ -276,20 +312,21 @@ void MessageHandler::HandleGroupMessageAsClosestNode(protobuf::Message& message)
       network_.SendAck(message);
     message.set_visited(true);
     LOG(kVerbose) << "message visited id: " << message.id();
-    return network_.SendToClosestNode(message);
+    return network_.SendToClosestNode(std::move(message));
   }
 
   auto replication(static_cast<unsigned int>(message.replication()));
 
   if (replication > 1) {
+    std::shared_ptr<const protobuf::Message> header(CopyHeader(message));
     network_utils_.acknowledgement_.AddGroup(
         message,
-        [message, this](const boost::system::error_code& error) {
+        [header, this](const boost::system::error_code& error) {
           LOG(kVerbose) << "Ack AddGroup Handler Fires";
           if (error /*&&  (NodeId(message.source_id()) != routing_table_.kNodeId())*/)
-            network_.SendAck(message);
+            network_.SendAck(*header);
           else
-            network_utils_.acknowledgement_.GroupQueueRemove(message.ack_id());
+            network_utils_.acknowledgement_.GroupQueueRemove(header->ack_id());
         }, Parameters::ack_timeout * Parameters::max_send_retry);
   } else if (message.source_id() != routing_table_.kNodeId().string()) {
     network_.SendAck(message);
@@ -369,7 +406,7 @@ void MessageHandler::HandleMessageAsFarNode(protobuf::Message& message) {
                 << "] is not in closest proximity to this message destination ID [ "
                 << HexSubstr(message.destination_id()) << " ]; sending on."
                 << " id: " << message.id();
-  network_.SendToClosestNode(message);
+  network_.SendToClosestNode(std::move(message));
 }
 
 void MessageHandler::HandleMessage(protobuf::Message& message) {
@@ -394,13 +431,85 @@ void MessageHandler::HandleMessage(protobuf::Message& message) {
   // Decrement hops_to_live
   message.set_hops_to_live(message.hops_to_live() - 1);
 
-  if (IsValidCacheableGet(message) && HandleCacheLookup(message))
-    return;  // forwarding message is done by cache manager or vault
+  if (signature_verifier_)
+    return VerifyMessage(message);
+  HandleVerifiedMessage(message);
+}
+
+void MessageHandler::VerifyMessage(protobuf::Message& message) {
+  // Responses addressed to us echo our original request and its signature.  Every Connect and
+  // FindNodes request we send is signed, so their responses must carry a valid signature; other
+  // responses are only checked if they carry one.  Anything else has nothing to check, but still
+  // passes through the verifier so that messages from each source are handled in the order they
+  // arrived; those from different sources needn't wait for one another.
+  SignatureVerifier::Check check;
+  check.order_key = message.source_id();
+  if (message.destination_id() == routing_table_.kNodeId().string() &&
+      GetEchoedRequest(message, check.data, check.signature) &&
+      (!check.signature.empty() || message.type() != static_cast<int>(MessageType::kPing))) {
+    check.signer_id = routing_table_.kNodeId().string();
+    check.public_key = kPublicKey_;
+  }
+  auto verified_message(std::make_shared<protobuf::Message>());
+  verified_message->Swap(&message);
+  const std::thread::id submitting_thread(std::this_thread::get_id());
+  signature_verifier_->Verify(check, [this, verified_message, submitting_thread](bool valid) {
+    if (!valid) {
+      LOG(kWarning) << "[" << DebugId(routing_table_.kNodeId()) << "] dropping "
+                    << MessageTypeString(*verified_message)
+                    << " with invalid signature, id: " << verified_message->id();
+      return;
+    }
+    OnMessageVerified(verified_message, std::this_thread::get_id() == submitting_thread);
+  });
+}
+
+void MessageHandler::OnMessageVerified(std::shared_ptr<protobuf::Message> message,
+                                       bool on_submitting_thread) {
+  {
+    std::lock_guard<std::mutex> lock(verified_messages_mutex_);
+    // The verifier delivers a source's results one at a time, so one handled here can't overtake
+    // an earlier one from its source unless that is still queued or being drained.
+    if (!on_submitting_thread || draining_verified_messages_) {
+      verified_messages_.push_back(std::move(message));
+      if (draining_verified_messages_)
+        return;
+      draining_verified_messages_ = true;
+    }
+  }
+  if (message)
+    return HandleVerifiedMessage(*message);
+  post_functor_([this] { DrainVerifiedMessages(); });
+}
+
+void MessageHandler::DrainVerifiedMessages() {
+  std::unique_lock<std::mutex> lock(verified_messages_mutex_);
+  for (unsigned int handled(0); !verified_messages_.empty(); ++handled) {
+    if (handled == std::max(Parameters::message_inbox_batch_size, 1U)) {
+      // Yield routing's thread to other work; still draining, so nothing overtakes these.
+      lock.unlock();
+      return post_functor_([this] { DrainVerifiedMessages(); });
+    }
+    auto message(std::move(verified_messages_.front()));
+    verified_messages_.pop_front();
+    lock.unlock();
+    HandleVerifiedMessage(*message);
+    lock.lock();
+  }
+  draining_verified_messages_ = false;
+}
+
+void MessageHandler::HandleVerifiedMessage(protobuf::Message& message) {
+  if (IsValidCacheableGet(message))
+    return HandleCacheLookup(message);  // resumes in DispatchMessage() if not answered from cache
   if (IsValidCacheablePut(message)) {
     LOG(kVerbose) << "StoreCacheCopy: " << message.id();
     StoreCacheCopy(message);  // Upper layer should take this on seperate thread
   }
+  DispatchMessage(message);
+}
 
+void MessageHandler::DispatchMessage(protobuf::Message& message) {
   // If group message request to self id
   if (IsGroupMessageRequestToSelfId(message)) {
     LOG(kInfo) << "MessageHandler::HandleMessage " << message.id() << " HandleGroupMessageToSelfId";
@@ -472,7 +581,7 @@ void MessageHandler::HandleMessageForNonRoutingNodes(protobuf::Message& message)
   }
   LOG(kInfo) << "This node has message destination in its ClientRoutingTable. Dest id : "
              << HexSubstr(message.destination_id()) << " message id: " << message.id();
-  return network_.SendToClosestNode(message);
+  return network_.SendToClosestNode(std::move(message));
 }
 
 void MessageHandler::HandleRelayRequest(protobuf::Message& message) {
@@ -501,7 +610,7 @@ void MessageHandler::HandleRelayRequest(protobuf::Message& message) {
 
   // This node is now the src ID for the relay message and will send back response to original node.
   message.set_source_id(routing_table_.kNodeId().string());
-  network_.SendToClosestNode(message);
+  network_.SendToClosestNode(std::move(message));
 }
 
 void MessageHandler::HandleDirectRelayRequestMessageAsClosestNode(protobuf::Message& message) {
@@ -513,7 +622,7 @@ void MessageHandler::HandleDirectRelayRequestMessageAsClosestNode(protobuf::Mess
     if (routing_table_.Contains(destination_node_id) ||
         client_routing_table_.Contains(destination_node_id)) {
       message.set_source_id(routing_table_.kNodeId().string());
-      return network_.SendToClosestNode(message);
+      return network_.SendToClosestNode(std::move(message));
     } else {
       LOG(kWarning) << "Dropping message. This node [" << DebugId(routing_table_.kNodeId())
                     << "] is the closest but is not connected to destination node ["
@@ -524,7 +633,7 @@ void MessageHandler::HandleDirectRelayRequestMessageAsClosestNode(protobuf::Mess
       return;
     }
   } else {
-    return network_.SendToClosestNode(message);
+    return network_.SendToClosestNode(std::move(message));
   }
 }
 
@@ -536,7 +645,7 @@ void MessageHandler::HandleGroupRelayRequestMessageAsClosestNode(protobuf::Messa
     LOG(kInfo) << "This node is not closest, passing it on."
                << " id: " << message.id();
     message.set_source_id(routing_table_.kNodeId().string());
-    return network_.SendToClosestNode(message);
+    return network_.SendToClosestNode(std::move(message));
   }
 
   // This node is closest so will send to all replicant nodes
@@ -606,7 +715,7 @@ bool MessageHandler::RelayDirectMessageIfNeeded(protobuf::Message& message) {
     message.clear_actual_destination_is_relay_id();  // so that it is picked currectly at recepient
     LOG(kVerbose) << "Relaying request to " << HexSubstr(message.relay_id())
                   << " id: " << message.id();
-    network_.SendToClosestNode(message);
+    network_.SendToClosestNode(std::move(message));
     return true;
   }
 
@@ -615,7 +724,7 @@ bool MessageHandler::RelayDirectMessageIfNeeded(protobuf::Message& message) {
     message.clear_destination_id();  // to allow network util to identify it as relay message
     LOG(kVerbose) << "Relaying response to " << HexSubstr(message.relay_id())
                   << " id: " << message.id();
-    network_.SendToClosestNode(message);
+    network_.SendToClosestNode(std::move(message));
     return true;
   }
 
@@ -658,7 +767,7 @@ void MessageHandler::HandleGroupMessageToSelfId(protobuf::Message& message) {
   assert(message.request());
   assert(!message.direct());
   LOG(kInfo) << "Sending group message to self id. Passing on to the closest peer to replicate";
-  network_.SendToClosestNode(message);
+  network_.SendToClosestNode(std::move(message));
 }
 
 void MessageHandler::InvokeTypedMessageReceivedFunctor(const protobuf::Message& proto_message) {
@@ -710,10 +819,30 @@ void MessageHandler::set_request_public_key_functor(
   service_->set_request_public_key_functor(request_public_key_functor);
 }
 
-bool MessageHandler::HandleCacheLookup(protobuf::Message& message) {
+void MessageHandler::set_post_functor(std::function<void(std::function<void()>)> post_functor) {
+  post_functor_ = post_functor;
+}
+
+void MessageHandler::set_find_nodes_response_functor(
+    FindNodesResponseFunctor find_nodes_response_functor) {
+  response_handler_->set_find_nodes_response_functor(find_nodes_response_functor);
+}
+
+void MessageHandler::set_request_public_keys_functor(
+    RequestPublicKeysFunctor request_public_keys_functor) {
+  public_key_request_batcher_->set_request_public_keys_functor(request_public_keys_functor);
+  set_request_public_key_functor(public_key_request_batcher_->GetRequestPublicKeyFunctor());
+}
+
+void MessageHandler::ConnectTo(const std::vector<NodeId>& peers) {
+  response_handler_->ConnectTo(peers);
+}
+
+void MessageHandler::HandleCacheLookup(protobuf::Message& message) {
   assert(!routing_table_.client_mode());
   assert(IsCacheableGet(message));
-  return cache_manager_->HandleGetFromCache(message);
+  cache_manager_->HandleGetFromCache(
+      message, [this](protobuf::Message& request) { DispatchMessage(request); });
 }
 
 void MessageHandler::StoreCacheCopy(const protobuf::Message& message) {
@@ -724,13 +853,13 @@ void MessageHandler::StoreCacheCopy(const protobuf::Message& message) {
 
 bool MessageHandler::IsValidCacheableGet(const protobuf::Message& message) {
   // TODO(Prakash): need to differentiate between typed and un typed api
-  return (IsCacheableGet(message) && IsNodeLevelMessage(message) && Parameters::caching &&
+  return (IsCacheableGet(message) && IsNodeLevelMessage(message) && caching_ &&
           !routing_table_.client_mode());
 }
 
 bool MessageHandler::IsValidCacheablePut(const protobuf::Message& message) {
   // TODO(Prakash): need to differentiate between typed and un typed api
-  return (IsNodeLevelMessage(message) && Parameters::caching && !routing_table_.client_mode() &&
+  return (IsNodeLevelMessage(message) && caching_ && !routing_table_.client_mode() &&
           IsCacheablePut(message));
 }
 
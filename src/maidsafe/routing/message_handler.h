@@ -19,14 +19,21 @@
 #ifndef MAIDSAFE_ROUTING_MESSAGE_HANDLER_H_
 #define MAIDSAFE_ROUTING_MESSAGE_HANDLER_H_
 
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <vector>
 
 #include "maidsafe/rudp/managed_connections.h"
 
 #include "maidsafe/routing/api_config.h"
 #include "maidsafe/routing/cache_manager.h"
+#include "maidsafe/routing/public_key_request_batcher.h"
 #include "maidsafe/routing/response_handler.h"
 #include "maidsafe/routing/service.h"
+#include "maidsafe/routing/signature_verifier.h"
 #include "maidsafe/routing/timer.h"
 #include "maidsafe/routing/utils.h"
 #include "maidsafe/routing/network_utils.h"
@@ -84,16 +91,41 @@ class MessageHandler {
   MessageHandler(RoutingTable& routing_table, ClientRoutingTable& client_routing_table,
                  Network& network, Timer<std::string>& timer,
                  NetworkUtils& network_utils, AsioService& asio_service);
+  ~MessageHandler();
   void HandleMessage(protobuf::Message& message);
   void set_typed_message_and_caching_functor(TypedMessageAndCachingFunctor functors);
   void set_message_and_caching_functor(MessageAndCachingFunctors functors);
   void set_request_public_key_functor(RequestPublicKeyFunctor request_public_key_functor);
+  // Routes this handler's public key requests through a PublicKeyRequestBatcher.
+  void set_request_public_keys_functor(RequestPublicKeysFunctor request_public_keys_functor);
+  // Must be called before messages are handled.
+  void set_find_nodes_response_functor(FindNodesResponseFunctor find_nodes_response_functor);
+  // Sets how messages which have passed signature verification on the verifier's threads are handed
+  // back to routing's own threads; by default they are posted to the AsioService.  Must be called
+  // before messages are handled.
+  void set_post_functor(std::function<void(std::function<void()>)> post_functor);
+  // Starts connecting to those of peers which would be added to the routing table.
+  void ConnectTo(const std::vector<NodeId>& peers);
+  // Overrides Parameters::caching for this handler.  Must be called before messages are handled.
+  void set_caching(bool caching) { caching_ = caching; }
 
  private:
   MessageHandler(const MessageHandler&);
   MessageHandler(const MessageHandler&&);
   MessageHandler& operator=(const MessageHandler&);
   bool CheckCacheData(protobuf::Message& message);
+  // Passes message through signature_verifier_, resuming in HandleVerifiedMessage() in arrival
+  // order if it is valid.
+  void VerifyMessage(protobuf::Message& message);
+  // Handles a verified message directly if it was verified on the submitting thread and none is
+  // queued ahead of it, otherwise queues it for DrainVerifiedMessages().
+  void OnMessageVerified(std::shared_ptr<protobuf::Message> message, bool on_submitting_thread);
+  // Handles the queued verified messages in order, run by post_functor_.
+  void DrainVerifiedMessages();
+  // The part of HandleMessage which follows signature verification.
+  void HandleVerifiedMessage(protobuf::Message& message);
+  // The part of HandleMessage which follows the cache lookup.
+  void DispatchMessage(protobuf::Message& message);
   void HandleRoutingMessage(protobuf::Message& message);
   void HandleNodeLevelMessageForThisNode(protobuf::Message& message);
   void HandleMessageForThisNode(protobuf::Message& message);
@@ -110,7 +142,7 @@ class MessageHandler {
   void HandleMessageForNonRoutingNodes(protobuf::Message& message);
   void HandleDirectRelayRequestMessageAsClosestNode(protobuf::Message& message);
   void HandleGroupRelayRequestMessageAsClosestNode(protobuf::Message& message);
-  bool HandleCacheLookup(protobuf::Message& message);
+  void HandleCacheLookup(protobuf::Message& message);
   void StoreCacheCopy(const protobuf::Message& message);
   bool IsValidCacheableGet(const protobuf::Message& message);
   bool IsValidCacheablePut(const protobuf::Message& message);
@@ -131,10 +163,23 @@ class MessageHandler {
   std::unique_ptr<CacheManager> cache_manager_;
   Timer<std::string>& timer_;
   PublicKeyHolder public_key_holder_;
+  std::shared_ptr<PublicKeyRequestBatcher> public_key_request_batcher_;
   std::shared_ptr<ResponseHandler> response_handler_;
   std::shared_ptr<Service> service_;
   MessageReceivedFunctor message_received_functor_;
   detail::TypedMessageRecievedFunctors typed_message_received_functors_;
+  bool caching_;
+  std::function<void(std::function<void()>)> post_functor_;
+  // Verified messages awaiting HandleVerifiedMessage(), in the order the verifier delivered them.
+  // A single drain at a time handles them, so each source's messages stay in order.  While any are
+  // queued, draining_verified_messages_ is set.
+  std::mutex verified_messages_mutex_;
+  std::deque<std::shared_ptr<protobuf::Message>> verified_messages_;
+  bool draining_verified_messages_;
+  // Null unless Parameters::verify_routing_signatures is set.  Declared last so that its workers
+  // are stopped before anything they might call into is destroyed.
+  const std::shared_ptr<const asymm::PublicKey> kPublicKey_;
+  std::unique_ptr<SignatureVerifier> signature_verifier_;
 };
 
 }  // namespace routing
@@ -0,0 +1,85 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_inbox.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+MessageInbox::MessageInbox(size_t ring_count, size_t ring_capacity, size_t batch_size,
+                           PostFunctor post, HandleFunctor handle, ShardFunctor shard)
+    : kBatchSize_(std::max(batch_size, static_cast<size_t>(1))),
+      post_(std::move(post)),
+      handle_(std::move(handle)),
+      shard_(std::move(shard)),
+      rings_(),
+      next_ring_(0),
+      dropped_count_(0) {
+  for (size_t i(0); i < std::max(ring_count, static_cast<size_t>(1)); ++i)
+    rings_.emplace_back(new Ring(ring_capacity));
+}
+
+void MessageInbox::Push(std::string message) {
+  Ring& ring(*rings_[shard_ ? shard_(message, rings_.size())
+                            : next_ring_.fetch_add(1, std::memory_order_relaxed) % rings_.size()]);
+  if (!ring.messages.TryPush(std::move(message))) {
+    if (dropped_count_.fetch_add(1, std::memory_order_relaxed) % 1000 == 0)
+      LOG(kWarning) << "Message inbox full; dropping received message";
+    return;
+  }
+  Schedule(ring);
+}
+
+uint64_t MessageInbox::dropped_count() const {
+  return dropped_count_.load(std::memory_order_relaxed);
+}
+
+void MessageInbox::Schedule(Ring& ring) {
+  if (!ring.scheduled.exchange(true, std::memory_order_acq_rel))
+    post_([this, &ring] { Drain(ring); });
+}
+
+void MessageInbox::Drain(Ring& ring) {
+  ring.batch.clear();
+  std::string message;
+  while (ring.batch.size() != kBatchSize_ && ring.messages.TryPop(message))
+    ring.batch.push_back(std::move(message));
+  const bool kFullBatch(ring.batch.size() == kBatchSize_);
+  if (!ring.batch.empty())
+    handle_(ring.batch);
+  if (kFullBatch) {
+    // Let other handlers run before carrying on.
+    post_([this, &ring] { Drain(ring); });
+    return;
+  }
+  ring.scheduled.store(false, std::memory_order_release);
+  // A message pushed after the last pop but before the flag was cleared would otherwise wait for
+  // the next push.
+  if (ring.messages.HasPending())
+    Schedule(ring);
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,88 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGE_INBOX_H_
+#define MAIDSAFE_ROUTING_MESSAGE_INBOX_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "maidsafe/routing/mpsc_ring.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Hands received messages from rudp's threads to routing's without a lock or an allocation per
+// message.  Producers spread messages over 'ring_count' MpscRings (one per routing worker), either
+// round-robin or, if given a ShardFunctor, by what it returns.  Only the push which finds a ring
+// idle posts a task to drain it; that task passes up to 'batch_size' messages at a time to
+// 'handle' and re-posts itself after a full batch, so other work still gets a turn under heavy
+// load.  A ring's messages are therefore handled one batch at a time and in order.  If a ring is
+// full, the message is dropped and counted: handling it out of turn would break that order, and
+// waiting for room would stall the producer (rudp's receive thread) on routing's backlog.
+class MessageInbox {
+ public:
+  typedef std::function<void(std::function<void()>)> PostFunctor;
+  typedef std::function<void(std::vector<std::string>& /*messages*/)> HandleFunctor;
+  // Returns the index, less than 'ring_count', of the ring a message belongs in.
+  typedef std::function<size_t(const std::string& /*message*/, size_t /*ring_count*/)>
+      ShardFunctor;
+
+  MessageInbox(size_t ring_count, size_t ring_capacity, size_t batch_size, PostFunctor post,
+               HandleFunctor handle, ShardFunctor shard = ShardFunctor());
+  MessageInbox(const MessageInbox&) = delete;
+  MessageInbox(const MessageInbox&&) = delete;
+  MessageInbox& operator=(const MessageInbox&) = delete;
+  MessageInbox& operator=(const MessageInbox&&) = delete;
+
+  // May be called from any thread.  The owner must keep this object alive until all tasks given
+  // to 'post' have run.
+  void Push(std::string message);
+  // Number of messages dropped because their ring was full.
+  uint64_t dropped_count() const;
+
+ private:
+  struct Ring {
+    explicit Ring(size_t capacity) : messages(capacity), scheduled(false), batch() {}
+    MpscRing<std::string> messages;
+    std::atomic<bool> scheduled;  // true while a drain task is posted or running
+    std::vector<std::string> batch;  // only used by the drain task
+  };
+
+  void Schedule(Ring& ring);
+  void Drain(Ring& ring);
+
+  const size_t kBatchSize_;
+  const PostFunctor post_;
+  const HandleFunctor handle_;
+  const ShardFunctor shard_;
+  std::vector<std::unique_ptr<Ring>> rings_;
+  std::atomic<size_t> next_ring_;
+  std::atomic<uint64_t> dropped_count_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGE_INBOX_H_
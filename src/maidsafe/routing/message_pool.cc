@@ -0,0 +1,78 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_pool.h"
+
+#include "maidsafe/routing/routing.pb.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+MessagePool::MessagePool(unsigned int capacity, uint32_t max_message_size)
+    : store_(std::make_shared<Store>(capacity, max_message_size)) {}
+
+std::shared_ptr<protobuf::Message> MessagePool::Acquire() {
+  std::unique_ptr<protobuf::Message> message;
+  {
+    std::lock_guard<std::mutex> lock(store_->mutex);
+    if (!store_->messages.empty()) {
+      message = std::move(store_->messages.back());
+      store_->messages.pop_back();
+    }
+  }
+  if (!message)
+    message.reset(new protobuf::Message);
+  std::weak_ptr<Store> weak_store(store_);
+  return std::shared_ptr<protobuf::Message>(
+      message.release(),
+      [weak_store](protobuf::Message* released) { Release(weak_store, released); });
+}
+
+std::shared_ptr<protobuf::Message> MessagePool::Copy(const protobuf::Message& message) {
+  auto copy(Acquire());
+  copy->CopyFrom(message);
+  return copy;
+}
+
+uint64_t MessagePool::PayloadSize(const protobuf::Message& message) {
+  uint64_t payload_size(0);
+  for (const auto& data : message.data())
+    payload_size += data.size();
+  return payload_size;
+}
+
+size_t MessagePool::size() const {
+  std::lock_guard<std::mutex> lock(store_->mutex);
+  return store_->messages.size();
+}
+
+void MessagePool::Release(std::weak_ptr<Store> weak_store, protobuf::Message* message) {
+  std::unique_ptr<protobuf::Message> owned(message);
+  auto store(weak_store.lock());
+  if (!store || PayloadSize(*owned) > store->max_message_size)
+    return;
+  owned->Clear();
+  std::lock_guard<std::mutex> lock(store->mutex);
+  if (store->messages.size() < store->capacity)
+    store->messages.push_back(std::move(owned));
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,77 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MESSAGE_POOL_H_
+#define MAIDSAFE_ROUTING_MESSAGE_POOL_H_
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace protobuf { class Message; }
+
+// Recycles protobuf::Message objects.  The lite protobuf runtime has no arenas, so instead a
+// released message is cleared and kept for reuse: clearing keeps the capacity of its string and
+// repeated fields, so parsing into or copying into a recycled message mostly reuses that memory
+// instead of making an allocation per field.  Messages are handed out as shared pointers and are
+// returned to the pool when the last reference is dropped, even if this has been destroyed by then
+// (in which case they are simply deleted).  Messages whose 'data' payload exceeds
+// 'max_message_size' are deleted rather than recycled, so large payloads aren't held.  Only the
+// payload is measured, as computing the full serialised size on every release would cost a pass
+// over the whole message; the other fields are small and bounded.
+class MessagePool {
+ public:
+  MessagePool(unsigned int capacity, uint32_t max_message_size);
+  MessagePool(const MessagePool&) = delete;
+  MessagePool(const MessagePool&&) = delete;
+  MessagePool& operator=(const MessagePool&) = delete;
+  MessagePool& operator=(const MessagePool&&) = delete;
+
+  // Returns an empty message.
+  std::shared_ptr<protobuf::Message> Acquire();
+  // Returns a copy of 'message'.
+  std::shared_ptr<protobuf::Message> Copy(const protobuf::Message& message);
+  // Number of messages currently available for reuse.
+  size_t size() const;
+
+ private:
+  struct Store {
+    Store(unsigned int capacity_in, uint32_t max_message_size_in)
+        : mutex(), capacity(capacity_in), max_message_size(max_message_size_in), messages() {}
+    std::mutex mutex;
+    const unsigned int capacity;
+    const uint32_t max_message_size;
+    std::vector<std::unique_ptr<protobuf::Message>> messages;
+  };
+
+  static uint64_t PayloadSize(const protobuf::Message& message);
+  static void Release(std::weak_ptr<Store> weak_store, protobuf::Message* message);
+
+  std::shared_ptr<Store> store_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MESSAGE_POOL_H_
@@ -0,0 +1,132 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_MPSC_RING_H_
+#define MAIDSAFE_ROUTING_MPSC_RING_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+namespace maidsafe {
+
+namespace routing {
+
+// A bounded lock-free queue for many producers and a single consumer (after D. Vyukov's bounded
+// MPMC queue).  Each cell carries a sequence number which tells producers whether it is free and
+// the consumer whether it has been filled, so neither side ever takes a lock.  Capacity is rounded
+// up to a power of two.  TryPop and HasPending must only be called by one thread at a time.
+template <typename T>
+class MpscRing {
+ public:
+  explicit MpscRing(size_t capacity);
+  MpscRing(const MpscRing&) = delete;
+  MpscRing(const MpscRing&&) = delete;
+  MpscRing& operator=(const MpscRing&) = delete;
+  MpscRing& operator=(const MpscRing&&) = delete;
+
+  // Returns false, leaving 'value' untouched, if the ring is full.
+  bool TryPush(T&& value);
+  bool TryPop(T& value);
+  // Returns true if TryPop would currently succeed.
+  bool HasPending() const;
+  size_t capacity() const { return kMask_ + 1; }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  static size_t RoundUpToPowerOfTwo(size_t value);
+
+  const size_t kMask_;
+  std::unique_ptr<Cell[]> cells_;
+  // Padding keeps the producers' and the consumer's positions on separate cache lines.
+  char padding0_[64];
+  std::atomic<size_t> enqueue_position_;
+  char padding1_[64];
+  std::atomic<size_t> dequeue_position_;  // only written by the consumer
+  char padding2_[64];
+};
+
+template <typename T>
+MpscRing<T>::MpscRing(size_t capacity)
+    : kMask_(RoundUpToPowerOfTwo(capacity < 2 ? 2 : capacity) - 1),
+      cells_(new Cell[kMask_ + 1]),
+      enqueue_position_(0),
+      dequeue_position_(0) {
+  for (size_t i(0); i <= kMask_; ++i)
+    cells_[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+template <typename T>
+size_t MpscRing<T>::RoundUpToPowerOfTwo(size_t value) {
+  size_t result(1);
+  while (result < value)
+    result <<= 1;
+  return result;
+}
+
+template <typename T>
+bool MpscRing<T>::TryPush(T&& value) {
+  size_t position(enqueue_position_.load(std::memory_order_relaxed));
+  for (;;) {
+    Cell& cell(cells_[position & kMask_]);
+    size_t sequence(cell.sequence.load(std::memory_order_acquire));
+    auto difference(static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position));
+    if (difference == 0) {
+      if (enqueue_position_.compare_exchange_weak(position, position + 1,
+                                                  std::memory_order_relaxed)) {
+        cell.value = std::move(value);
+        cell.sequence.store(position + 1, std::memory_order_release);
+        return true;
+      }
+    } else if (difference < 0) {
+      return false;  // full
+    } else {
+      position = enqueue_position_.load(std::memory_order_relaxed);
+    }
+  }
+}
+
+template <typename T>
+bool MpscRing<T>::TryPop(T& value) {
+  size_t position(dequeue_position_.load(std::memory_order_relaxed));
+  Cell& cell(cells_[position & kMask_]);
+  if (cell.sequence.load(std::memory_order_acquire) != position + 1)
+    return false;  // empty, or the producer which claimed this cell hasn't finished writing it
+  value = std::move(cell.value);
+  cell.sequence.store(position + kMask_ + 1, std::memory_order_release);
+  dequeue_position_.store(position + 1, std::memory_order_relaxed);
+  return true;
+}
+
+template <typename T>
+bool MpscRing<T>::HasPending() const {
+  size_t position(dequeue_position_.load(std::memory_order_relaxed));
+  return cells_[position & kMask_].sequence.load(std::memory_order_acquire) == position + 1;
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_MPSC_RING_H_
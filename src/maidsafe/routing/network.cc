@@ -18,13 +18,16 @@
 
 #include "maidsafe/routing/network.h"
 
+#include "boost/asio/steady_timer.hpp"
 #include "boost/date_time/posix_time/posix_time_config.hpp"
 #include "boost/filesystem/path.hpp"
 
 #include "maidsafe/common/log.h"
+#include "maidsafe/common/make_unique.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/rudp/return_codes.h"
 
+#include "maidsafe/routing/bootstrap_contact_store.h"
 #include "maidsafe/routing/bootstrap_file_operations.h"
 #include "maidsafe/routing/bootstrap_utils.h"
 #include "maidsafe/routing/client_routing_table.h"
@@ -50,6 +53,12 @@ namespace routing {
 
 Network::Network(RoutingTable& routing_table, ClientRoutingTable& client_routing_table,
                  Acknowledgement& acknowledgement)
+    : Network(routing_table, client_routing_table, acknowledgement,
+              Parameters::transmit_thread_count, Parameters::signing_thread_count) {}
+
+Network::Network(RoutingTable& routing_table, ClientRoutingTable& client_routing_table,
+                 Acknowledgement& acknowledgement, unsigned int transmit_thread_count,
+                 unsigned int signing_thread_count)
     : running_(true),
       running_mutex_(),
       bootstrap_attempt_(0),
@@ -59,11 +68,33 @@ Network::Network(RoutingTable& routing_table, ClientRoutingTable& client_routing
       client_routing_table_(client_routing_table),
       acknowledgement_(acknowledgement),
       nat_type_(rudp::NatType::kUnknown),
-      rudp_() {}
+      bootstrap_contact_store_(),
+      message_pool_(Parameters::message_pool_size, Parameters::max_pooled_message_size),
+      rudp_(),
+      transmit_stage_(transmit_thread_count == 0
+                          ? nullptr
+                          : maidsafe::make_unique<PipelineStage<Transmission>>(
+                                transmit_thread_count,
+                                Parameters::pipeline_queue_capacity,
+                                Parameters::pipeline_batch_size,
+                                [this](std::vector<Transmission>& batch) { Transmit(batch); })),
+      signing_stage_(!Parameters::verify_routing_signatures || signing_thread_count == 0
+                         ? nullptr
+                         : maidsafe::make_unique<PipelineStage<Signing>>(
+                               signing_thread_count, Parameters::pipeline_queue_capacity,
+                               Parameters::pipeline_batch_size,
+                               [this](std::vector<Signing>& batch) { Sign(batch); })),
+      lifetime_(std::make_shared<Lifetime>()) {}
 
 Network::~Network() {
-  std::lock_guard<std::mutex> lock(running_mutex_);
-  running_ = false;
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    running_ = false;
+  }
+  // Whatever is still queued is dropped by Sign() and Transmit().
+  signing_stage_.reset();
+  transmit_stage_.reset();
+  lifetime_->Close();
 }
 
 int Network::Bootstrap(const rudp::MessageReceivedFunctor& message_received_functor,
@@ -145,11 +176,19 @@ int Network::MarkConnectionAsValid(const NodeId& peer_id) {
   int ret_val(rudp_.MarkConnectionAsValid(peer_id, new_bootstrap_endpoint));
   if ((ret_val == kSuccess) && !new_bootstrap_endpoint.address().is_unspecified()) {
     LOG(kVerbose) << "Found usable endpoint for bootstrapping : " << new_bootstrap_endpoint;
-    InsertOrUpdateBootstrapContact(new_bootstrap_endpoint, routing_table_.client_mode());
+    if (bootstrap_contact_store_)
+      bootstrap_contact_store_->Add(new_bootstrap_endpoint);
+    else
+      InsertOrUpdateBootstrapContact(new_bootstrap_endpoint, routing_table_.client_mode());
   }
   return ret_val;
 }
 
+void Network::set_bootstrap_contact_store(
+    std::shared_ptr<BootstrapContactStore> bootstrap_contact_store) {
+  bootstrap_contact_store_ = bootstrap_contact_store;
+}
+
 void Network::Remove(const NodeId& peer_id) {
   {
     std::lock_guard<std::mutex> lock(running_mutex_);
@@ -172,6 +211,78 @@ void Network::RudpSend(const NodeId& peer_id, const protobuf::Message& message,
                 << "   (id: " << message.id() << ")" << " --To Rudp--";
 }
 
+void Network::RudpSend(const NodeId& peer_id, std::shared_ptr<const protobuf::Message> message,
+                       const rudp::MessageSentFunctor& message_sent_functor) {
+  if (transmit_stage_) {
+    Transmission transmission{ peer_id, message, message_sent_functor };
+    if (transmit_stage_->TryPush(transmission))
+      return;
+  }
+  RudpSend(peer_id, *message, message_sent_functor);
+}
+
+void Network::Transmit(std::vector<Transmission>& batch) {
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    if (!running_)
+      return;
+  }
+  for (const auto& transmission : batch) {
+    rudp_.Send(transmission.peer_id, transmission.message->SerializeAsString(),
+               transmission.message_sent_functor);
+    LOG(kVerbose) << "  [" << routing_table_.kNodeId() << "] send : "
+                  << MessageTypeString(*transmission.message) << " to " << transmission.peer_id
+                  << "   (id: " << transmission.message->id() << ")" << " --To Rudp--";
+  }
+}
+
+void Network::SignAndSend(protobuf::Message&& message,
+                          std::function<void(protobuf::Message&)> send) {
+  if (signing_stage_) {
+    Signing signing{ message_pool_.Acquire(), send };
+    signing.message->Swap(&message);
+    if (signing_stage_->TryPush(signing))
+      return;
+    message.Swap(signing.message.get());
+  }
+  SignRequest(routing_table_.kPrivateKey(), message);
+  send(message);
+}
+
+void Network::Sign(std::vector<Signing>& batch) {
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    if (!running_)
+      return;
+  }
+  for (auto& signing : batch) {
+    SignRequest(routing_table_.kPrivateKey(), *signing.message);
+    signing.send(*signing.message);
+  }
+}
+
+void Network::SignAndSendToDirect(protobuf::Message&& message, const NodeId& peer_connection_id,
+                                  const rudp::MessageSentFunctor& message_sent_functor) {
+  SignAndSend(std::move(message), [this, peer_connection_id,
+                                   message_sent_functor](protobuf::Message& signed_message) {
+    SendToDirect(signed_message, peer_connection_id, message_sent_functor);
+  });
+}
+
+void Network::SignAndSendToDirect(protobuf::Message&& message, const NodeId& peer_node_id,
+                                  const NodeId& peer_connection_id) {
+  SignAndSend(std::move(message),
+              [this, peer_node_id, peer_connection_id](protobuf::Message& signed_message) {
+                SendToDirect(signed_message, peer_node_id, peer_connection_id);
+              });
+}
+
+void Network::SignAndSendToClosestNode(protobuf::Message&& message) {
+  SignAndSend(std::move(message), [this](protobuf::Message& signed_message) {
+    SendToClosestNode(std::move(signed_message));
+  });
+}
+
 void Network::SendToDirect(const protobuf::Message& message, const NodeId& peer_connection_id,
                            const rudp::MessageSentFunctor& message_sent_functor) {
   RudpSend(peer_connection_id, message, message_sent_functor ? message_sent_functor : nullptr);
@@ -183,6 +294,15 @@ void Network::SendToDirect(protobuf::Message& message, const NodeId& peer_node_i
   SendTo(message, peer_node_id, peer_connection_id);
 }
 
+void Network::SendToDirect(protobuf::Message&& message, const NodeId& peer_node_id,
+                           const NodeId& peer_connection_id) {
+  AdjustRouteHistory(message);
+  std::shared_ptr<protobuf::Message> shared_message(message_pool_.Acquire());
+  shared_message->Swap(&message);
+  SendTo(std::shared_ptr<const protobuf::Message>(shared_message), peer_node_id,
+         peer_connection_id);
+}
+
 void Network::SendToDirectAdjustedRoute(protobuf::Message& message, const NodeId& peer_node_id,
                                              const NodeId& peer_connection_id) {
   AdjustRouteHistory(message);
@@ -190,6 +310,17 @@ void Network::SendToDirectAdjustedRoute(protobuf::Message& message, const NodeId
 }
 
 void Network::SendToClosestNode(const protobuf::Message& message) {
+  SendToClosestNode(message_pool_.Copy(message));
+}
+
+void Network::SendToClosestNode(protobuf::Message&& message) {
+  std::shared_ptr<protobuf::Message> shared_message(message_pool_.Acquire());
+  shared_message->Swap(&message);
+  SendToClosestNode(shared_message);
+}
+
+void Network::SendToClosestNode(std::shared_ptr<protobuf::Message> shared_message) {
+  const protobuf::Message& message(*shared_message);
   // Normal messages
   if (message.has_destination_id() && !message.destination_id().empty()) {
     auto client_routing_nodes(client_routing_table_.GetNodesInfo(NodeId(message.destination_id())));
@@ -209,10 +340,10 @@ void Network::SendToClosestNode(const protobuf::Message& message) {
       for (const auto& i : client_routing_nodes) {
         LOG(kVerbose) << "Sending message to NRT node with ID " << message.id() << " node_id "
                       << DebugId(i.id) << " connection id " << DebugId(i.connection_id);
-        SendTo(message, i.id, i.connection_id);
+        SendTo(std::shared_ptr<const protobuf::Message>(shared_message), i.id, i.connection_id);
       }
     } else if (routing_table_.size() > 0) {  // getting closer nodes from routing table
-      RecursiveSendOn(message);
+      RecursiveSendOn(shared_message);
     } else {
       LOG(kError) << " No endpoint to send to; aborting send.  Attempt to send a type "
                   << MessageTypeString(message) << " message to " << HexSubstr(message.source_id())
@@ -223,10 +354,10 @@ void Network::SendToClosestNode(const protobuf::Message& message) {
 
   // Relay message responses only
   if (message.has_relay_id() /*&& (IsResponse(message))*/) {
-    protobuf::Message relay_message(message);
-    relay_message.set_destination_id(message.relay_id());  // so that peer identifies it as direct
-    SendTo(relay_message, NodeId(relay_message.relay_id()),
-           NodeId(relay_message.relay_connection_id()));
+    // so that peer identifies it as direct
+    shared_message->set_destination_id(message.relay_id());
+    SendTo(std::shared_ptr<const protobuf::Message>(shared_message), NodeId(message.relay_id()),
+           NodeId(message.relay_connection_id()));
   } else {
     LOG(kError) << "Unable to work out destination; aborting send."
                 << " id: " << message.id() << " message.has_relay_id() ; " << std::boolalpha
@@ -237,22 +368,28 @@ void Network::SendToClosestNode(const protobuf::Message& message) {
 }
 
 void Network::SendTo(const protobuf::Message& message, const NodeId& peer_node_id,
-                          const NodeId& peer_connection_id,  bool no_ack_timer) {
+                     const NodeId& peer_connection_id, bool no_ack_timer) {
+  SendTo(std::shared_ptr<const protobuf::Message>(message_pool_.Copy(message)),
+         peer_node_id, peer_connection_id, no_ack_timer);
+}
+
+void Network::SendTo(std::shared_ptr<const protobuf::Message> message, const NodeId& peer_node_id,
+                     const NodeId& peer_connection_id, bool no_ack_timer) {
   const std::string kThisId(routing_table_.kNodeId().string());
   rudp::MessageSentFunctor message_sent_functor = [=](int message_sent) {
     if (rudp::kSuccess == message_sent) {
-      SendAck(message);
-      LOG(kVerbose) << "  [" << HexSubstr(kThisId) << "] sent : " << MessageTypeString(message)
-                    << " to   " << peer_node_id << "   (id: " << message.id() << ")";
+      SendAck(*message);
+      LOG(kVerbose) << "  [" << HexSubstr(kThisId) << "] sent : " << MessageTypeString(*message)
+                    << " to   " << peer_node_id << "   (id: " << message->id() << ")";
     } else {
-      LOG(kError) << "Sending type " << MessageTypeString(message) << " message from "
+      LOG(kError) << "Sending type " << MessageTypeString(*message) << " message from "
                   << HexSubstr(kThisId) << " to " << peer_node_id << " failed with code "
-                  << message_sent << " id: " << message.id();
+                  << message_sent << " id: " << message->id();
     }
   };
 
-  if (!no_ack_timer && acknowledgement_.NeedsAck(message, peer_connection_id)) {
-    acknowledgement_.Add(message,
+  if (!no_ack_timer && acknowledgement_.NeedsAck(*message, peer_connection_id)) {
+    acknowledgement_.Add(*message,
                          [=](const boost::system::error_code& error) {
                            {
                              std::lock_guard<std::mutex> lock(running_mutex_);
@@ -267,8 +404,18 @@ void Network::SendTo(const protobuf::Message& message, const NodeId& peer_node_i
   RudpSend(peer_connection_id, message, message_sent_functor);
 }
 
-void Network::RecursiveSendOn(protobuf::Message message, NodeInfo last_node_attempted,
-                                   int attempt_count) {
+void Network::RecursiveSendOn(std::shared_ptr<protobuf::Message> message) {
+  {
+    std::lock_guard<std::mutex> lock(running_mutex_);
+    if (!running_)
+      return;
+    AdjustRouteHistory(*message);
+  }
+  RecursiveSendOn(std::shared_ptr<const protobuf::Message>(message), NodeInfo(), 0);
+}
+
+void Network::RecursiveSendOn(std::shared_ptr<const protobuf::Message> message,
+                              NodeInfo last_node_attempted, int attempt_count) {
   {
     std::lock_guard<std::mutex> lock(running_mutex_);
     if (!running_)
@@ -278,7 +425,7 @@ void Network::RecursiveSendOn(protobuf::Message message, NodeInfo last_node_atte
     LOG(kWarning) << " Retry attempts failed to send to ["
                   << HexSubstr(last_node_attempted.id.string())
                   << "] will drop this node now and try with another node."
-                  << " id: " << message.id();
+                  << " id: " << message->id();
     attempt_count = 0;
     {
       std::lock_guard<std::mutex> lock(running_mutex_);
@@ -289,42 +436,54 @@ void Network::RecursiveSendOn(protobuf::Message message, NodeInfo last_node_atte
       // FIXME Should we remove this node or let rudp handle that?
       routing_table_.DropNode(last_node_attempted.connection_id, false);
       client_routing_table_.DropConnection(last_node_attempted.connection_id);
-      acknowledgement_.SetAsFailedPeer(message.ack_id(), last_node_attempted.id);
+      acknowledgement_.SetAsFailedPeer(message->ack_id(), last_node_attempted.id);
     }
   }
 
-  if (attempt_count > 0)
-    Sleep(std::chrono::milliseconds(50));
+  if (attempt_count == 0)
+    return SendToClosestPeer(message, last_node_attempted, attempt_count);
+
+  auto timer(std::make_shared<boost::asio::steady_timer>(acknowledgement_.io_service().service(),
+                                                         std::chrono::milliseconds(50)));
+  std::shared_ptr<Lifetime> lifetime(lifetime_);
+  timer->async_wait([this, lifetime, timer, message, last_node_attempted,
+                     attempt_count](const boost::system::error_code& error) {
+    if (error != boost::asio::error::operation_aborted)
+      lifetime->Run([&] { SendToClosestPeer(message, last_node_attempted, attempt_count); });
+  });
+}
 
+void Network::SendToClosestPeer(std::shared_ptr<const protobuf::Message> message,
+                                NodeInfo last_node_attempted, int attempt_count) {
   const std::string kThisId(routing_table_.kNodeId().string());
-  bool ignore_exact_match(!IsDirect(message));
-  std::vector<std::string> route_history;
+  bool ignore_exact_match(!IsDirect(*message));
+  NodeIdExclusion exclusion;
   NodeInfo peer;
   {
     std::lock_guard<std::mutex> lock(running_mutex_);
     if (!running_)
       return;
-    if (message.route_history().size() > 1)
-      route_history = std::vector<std::string>(
-          message.route_history().begin(), message.route_history().end());
-    else if ((message.route_history().size() == 1) &&
-             (message.route_history(0) != routing_table_.kNodeId().string()))
-      route_history.push_back(message.route_history(0));
-
-    auto group_target(acknowledgement_.AppendGroup(message.ack_id(), route_history));
+    if (message->route_history().size() > 1) {
+      for (const auto& route : message->route_history())
+        exclusion.push_back(NodeId(route));
+    } else if ((message->route_history().size() == 1) &&
+               (message->route_history(0) != kThisId)) {
+      exclusion.push_back(NodeId(message->route_history(0)));
+    }
+
+    auto group_target(acknowledgement_.AppendGroup(message->ack_id(), exclusion));
     if (!group_target.IsZero())
       ignore_exact_match = true;
 
-    peer = routing_table_.GetClosestNode(NodeId(message.destination_id()), ignore_exact_match,
-                                         route_history);
-    if (peer.id == NodeId() && routing_table_.size() != 0) {
-      peer = routing_table_.GetClosestNode(NodeId(message.destination_id()), ignore_exact_match);
+    const NodeId kDestinationId(message->destination_id());
+    if (!routing_table_.GetClosestNode(kDestinationId, ignore_exact_match, exclusion, peer) &&
+        routing_table_.size() != 0) {
+      peer = routing_table_.GetClosestNode(kDestinationId, ignore_exact_match);
     }
     if (peer.id == NodeId()) {
       LOG(kError) << "This node's routing table is empty now.  Need to re-bootstrap.";
       return;
     }
-    AdjustRouteHistory(message);
   }
 
   rudp::MessageSentFunctor message_sent_functor = [=](int message_sent) {
@@ -334,25 +493,25 @@ void Network::RecursiveSendOn(protobuf::Message message, NodeInfo last_node_atte
         return;
     }
     if (rudp::kSuccess == message_sent) {
-      LOG(kVerbose) << "  [" << HexSubstr(kThisId) << "] sent : " << MessageTypeString(message)
-                    << " to   " << HexSubstr(peer.id.string()) << "   (id: " << message.id()
-                    << ")"
-                    << " dst : " << HexSubstr(message.destination_id());
-      SendAck(message);
+      LOG(kVerbose) << "  [" << HexSubstr(kThisId) << "] sent : "
+                    << MessageTypeString(*message) << " to   " << HexSubstr(peer.id.string())
+                    << "   (id: " << message->id() << ")"
+                    << " dst : " << HexSubstr(message->destination_id());
+      SendAck(*message);
     } else if (rudp::kSendFailure == message_sent) {
-      LOG(kError) << "Sending type " << MessageTypeString(message) << " message from "
+      LOG(kError) << "Sending type " << MessageTypeString(*message) << " message from "
                   << HexSubstr(routing_table_.kNodeId().string()) << " to "
                   << HexSubstr(peer.id.string()) << " with destination ID "
-                  << HexSubstr(message.destination_id()) << " failed with code " << message_sent
-                  << ".  Will retry to Send.  Attempt count = " << attempt_count + 1
-                  << " id: " << message.id();
+                  << HexSubstr(message->destination_id()) << " failed with code "
+                  << message_sent << ".  Will retry to Send.  Attempt count = "
+                  << attempt_count + 1 << " id: " << message->id();
       RecursiveSendOn(message, peer, attempt_count + 1);
     } else {
-      LOG(kError) << "Sending type " << MessageTypeString(message) << " message from "
+      LOG(kError) << "Sending type " << MessageTypeString(*message) << " message from "
                   << HexSubstr(kThisId) << " to " << HexSubstr(peer.id.string())
-                  << " with destination ID " << HexSubstr(message.destination_id())
+                  << " with destination ID " << HexSubstr(message->destination_id())
                   << " failed with code " << message_sent << "  Will remove node."
-                  << " message id: " << message.id();
+                  << " message id: " << message->id();
       {
         std::lock_guard<std::mutex> lock(running_mutex_);
         if (!running_)
@@ -362,15 +521,15 @@ void Network::RecursiveSendOn(protobuf::Message message, NodeInfo last_node_atte
       LOG(kWarning) << " Routing-> removing connection " << DebugId(peer.connection_id);
       routing_table_.DropNode(peer.id, false);
       client_routing_table_.DropConnection(peer.connection_id);
-      RecursiveSendOn(message);
+      RecursiveSendOn(message, NodeInfo(), 0);
     }
   };
 
-  if (acknowledgement_.NeedsAck(message, peer.id)) {
-    acknowledgement_.Add(message,
+  if (acknowledgement_.NeedsAck(*message, peer.id)) {
+    acknowledgement_.Add(*message,
                         [=](const boost::system::error_code& error) {
                           if (error.value() == boost::system::errc::success)
-                            RecursiveSendOn(message);
+                            RecursiveSendOn(message, NodeInfo(), 0);
                         }, Parameters::ack_timeout);
   }
   LOG(kVerbose) << "Rudp recursive send message to " << peer.connection_id;
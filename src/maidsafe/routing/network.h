@@ -19,6 +19,8 @@
 #ifndef MAIDSAFE_ROUTING_NETWORK_H_
 #define MAIDSAFE_ROUTING_NETWORK_H_
 
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -30,7 +32,10 @@
 
 #include "maidsafe/routing/api_config.h"
 #include "maidsafe/routing/bootstrap_file_operations.h"
+#include "maidsafe/routing/lifetime.h"
+#include "maidsafe/routing/message_pool.h"
 #include "maidsafe/routing/node_info.h"
+#include "maidsafe/routing/pipeline_stage.h"
 #include "maidsafe/routing/timer.h"
 
 namespace maidsafe {
@@ -44,6 +49,7 @@ class Message;
 class ClientRoutingTable;
 class RoutingTable;
 class Acknowledgement;
+class BootstrapContactStore;
 
 namespace test {
 class GenericNode;
@@ -54,6 +60,11 @@ class Network {
  public:
   Network(RoutingTable& routing_table, ClientRoutingTable& client_routing_table,
           Acknowledgement& acknowledgement);
+  // As above, but with the number of transmit_stage_ and signing_stage_ threads given rather than
+  // taken from Parameters.
+  Network(RoutingTable& routing_table, ClientRoutingTable& client_routing_table,
+          Acknowledgement& acknowledgement, unsigned int transmit_thread_count,
+          unsigned int signing_thread_count);
   virtual ~Network();
   int Bootstrap(const rudp::MessageReceivedFunctor& message_received_functor,
                 const rudp::ConnectionLostFunctor& connection_lost_functor);
@@ -76,13 +87,30 @@ class Network {
   void AdjustAckHistory(protobuf::Message& message);
   virtual void SendToDirect(protobuf::Message& message, const NodeId& peer_node_id,
                             const NodeId& peer_connection_id);
+  // Takes the contents of 'message', so that neither it nor its payload is copied.
+  void SendToDirect(protobuf::Message&& message, const NodeId& peer_node_id,
+                    const NodeId& peer_connection_id);
   void SendToDirectAdjustedRoute(protobuf::Message& message, const NodeId& peer_node_id,
                                  const NodeId& peer_connection_id);
   // Handles relay response messages.  Also leave destination ID empty if needs to send as a relay
   // response message
   virtual void SendToClosestNode(const protobuf::Message& message);
+  // Takes the contents of 'message', so that neither it nor its payload is copied.
+  virtual void SendToClosestNode(protobuf::Message&& message);
   void SendToClosestNode(protobuf::Message& message, const std::vector<NodeId>& exclude);
+  // These sign 'message' (see SignRequest) before sending it as the corresponding SendToDirect or
+  // SendToClosestNode overload does.  If signing_stage_ is set, signing and sending are done on its
+  // threads, so the caller (usually an asio thread) isn't held up by RSA.
+  void SignAndSendToDirect(protobuf::Message&& message, const NodeId& peer_connection_id,
+                           const rudp::MessageSentFunctor& message_sent_functor);
+  void SignAndSendToDirect(protobuf::Message&& message, const NodeId& peer_node_id,
+                           const NodeId& peer_connection_id);
+  void SignAndSendToClosestNode(protobuf::Message&& message);
   void AddToBootstrapFile(const boost::asio::ip::udp::endpoint& endpoint);
+  // Bootstrap contacts found by MarkConnectionAsValid() are added to bootstrap_contact_store rather
+  // than written to the bootstrap file one at a time.  Must be called before Bootstrap().
+  void set_bootstrap_contact_store(
+      std::shared_ptr<BootstrapContactStore> bootstrap_contact_store);
   void clear_bootstrap_connection_info();
   NodeId bootstrap_connection_id() const;
   NodeId this_node_relay_connection_id() const;
@@ -92,6 +120,19 @@ class Network {
   friend class test::MockNetwork;
 
  private:
+  // A request waiting in signing_stage_ to be signed and then passed to 'send'.
+  struct Signing {
+    std::shared_ptr<protobuf::Message> message;
+    std::function<void(protobuf::Message&)> send;
+  };
+
+  // A message waiting in transmit_stage_ to be serialised and handed to rudp.
+  struct Transmission {
+    NodeId peer_id;
+    std::shared_ptr<const protobuf::Message> message;
+    rudp::MessageSentFunctor message_sent_functor;
+  };
+
   Network(const Network&);
   Network(const Network&&);
   Network& operator=(const Network&);
@@ -103,10 +144,28 @@ class Network {
                   boost::asio::ip::udp::endpoint local_endpoint = boost::asio::ip::udp::endpoint());
   void RudpSend(const NodeId& peer_id, const protobuf::Message& message,
                 const rudp::MessageSentFunctor& message_sent_functor);
+  // Queues the send on transmit_stage_ if it has room, else sends directly.
+  void RudpSend(const NodeId& peer_id, std::shared_ptr<const protobuf::Message> message,
+                const rudp::MessageSentFunctor& message_sent_functor);
+  void Transmit(std::vector<Transmission>& batch);
+  void SignAndSend(protobuf::Message&& message, std::function<void(protobuf::Message&)> send);
+  void Sign(std::vector<Signing>& batch);
+  void SendToClosestNode(std::shared_ptr<protobuf::Message> message);
   void SendTo(const protobuf::Message& message, const NodeId& peer_node_id,
               const NodeId& peer_connection_id, bool no_ack_timer = false);
-  void RecursiveSendOn(protobuf::Message message, NodeInfo last_node_attempted = NodeInfo(),
-                       int attempt_count = 0);
+  // The sent functor and ack handler (and any resend they trigger) share 'message' rather than
+  // each holding its own copy of it.
+  void SendTo(std::shared_ptr<const protobuf::Message> message, const NodeId& peer_node_id,
+              const NodeId& peer_connection_id, bool no_ack_timer = false);
+  // 'message' is adjusted in place, so must not already be shared with a pending continuation.
+  void RecursiveSendOn(std::shared_ptr<protobuf::Message> message);
+  // Sends an already adjusted 'message'.  It is only read from here on, so every attempt and
+  // continuation shares it; retries don't adjust it again.  A retry (non-zero 'attempt_count') is
+  // made after a short pause, on a timer rather than by blocking the calling thread.
+  void RecursiveSendOn(std::shared_ptr<const protobuf::Message> message,
+                       NodeInfo last_node_attempted, int attempt_count);
+  void SendToClosestPeer(std::shared_ptr<const protobuf::Message> message,
+                         NodeInfo last_node_attempted, int attempt_count);
   void AdjustRouteHistory(protobuf::Message& message);
 
   bool running_;
@@ -118,7 +177,17 @@ class Network {
   ClientRoutingTable& client_routing_table_;
   Acknowledgement& acknowledgement_;
   rudp::NatType nat_type_;
+  std::shared_ptr<BootstrapContactStore> bootstrap_contact_store_;
+  MessagePool message_pool_;
   rudp::ManagedConnections rudp_;
+  // The encode and transmit stage of the message pipeline; declared after rudp_ so that it's
+  // stopped first.  Null if its thread count is 0.
+  std::unique_ptr<PipelineStage<Transmission>> transmit_stage_;
+  // Signs outgoing requests, feeding transmit_stage_, so it's stopped before that.  Null unless
+  // Parameters::verify_routing_signatures is set and its thread count is non-zero.
+  std::unique_ptr<PipelineStage<Signing>> signing_stage_;
+  // Shared with pending retry timers, which may fire after this has been destroyed.
+  std::shared_ptr<Lifetime> lifetime_;
 };
 
 }  // namespace routing
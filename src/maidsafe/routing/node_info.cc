@@ -26,6 +26,21 @@ namespace maidsafe {
 
 namespace routing {
 
+namespace {
+
+bool IsEmpty(const asymm::PublicKey& key) { return key.GetModulus().IsZero(); }
+
+// The handle a copy of a record holds: the original's, or if only the deprecated member has been
+// set (by the upper layer), a new one holding that.
+NodeInfo::PublicKeyPtr CopiedKey(const NodeInfo::PublicKeyPtr& shared_public_key,
+                                 const asymm::PublicKey& public_key) {
+  if (shared_public_key || IsEmpty(public_key))
+    return shared_public_key;
+  return std::make_shared<const asymm::PublicKey>(public_key);
+}
+
+}  // unnamed namespace
+
 NodeInfo::NodeInfo()
     : id(),
       connection_id(),
@@ -33,25 +48,28 @@ NodeInfo::NodeInfo()
       rank(),
       bucket(kInvalidBucket),
       nat_type(rudp::NatType::kUnknown),
-      dimension_list() {}
+      dimension_list(),
+      shared_public_key_() {}
 
 NodeInfo::NodeInfo(const NodeInfo& other)
     : id(other.id),
       connection_id(other.connection_id),
-      public_key(other.public_key),
+      public_key(),
       rank(other.rank),
       bucket(other.bucket),
       nat_type(other.nat_type),
-      dimension_list(other.dimension_list) {}
+      dimension_list(other.dimension_list),
+      shared_public_key_(CopiedKey(other.shared_public_key_, other.public_key)) {}
 
 NodeInfo::NodeInfo(NodeInfo&& other)
     : id(std::move(other.id)),
       connection_id(std::move(other.connection_id)),
-      public_key(std::move(other.public_key)),
+      public_key(),
       rank(std::move(other.rank)),
       bucket(std::move(other.bucket)),
       nat_type(std::move(other.nat_type)),
-      dimension_list(std::move(other.dimension_list)) {}
+      dimension_list(std::move(other.dimension_list)),
+      shared_public_key_(CopiedKey(other.shared_public_key_, other.public_key)) {}
 
 NodeInfo& NodeInfo::operator=(NodeInfo other) {
   swap(*this, other);
@@ -59,7 +77,11 @@ NodeInfo& NodeInfo::operator=(NodeInfo other) {
 }
 
 NodeInfo::NodeInfo(const serialised_type& serialised_message)
-    : connection_id(), public_key(), bucket(kInvalidBucket), nat_type(rudp::NatType::kUnknown) {
+    : connection_id(),
+      public_key(),
+      bucket(kInvalidBucket),
+      nat_type(rudp::NatType::kUnknown),
+      shared_public_key_() {
   protobuf::NodeInfo proto_node_info;
   if (!proto_node_info.ParseFromString(serialised_message->string()))
     BOOST_THROW_EXCEPTION(MakeError(CommonErrors::parsing_error));
@@ -88,17 +110,26 @@ NodeInfo::serialised_type NodeInfo::Serialise() const {
   return serialised_message;
 }
 
+void NodeInfo::set_public_key(const asymm::PublicKey& key) {
+  shared_public_key_ = std::make_shared<const asymm::PublicKey>(key);
+}
+
+void NodeInfo::set_public_key(PublicKeyPtr key) { shared_public_key_ = std::move(key); }
+
 const int32_t NodeInfo::kInvalidBucket(std::numeric_limits<int32_t>::max());
 
 void swap(NodeInfo& lhs, NodeInfo& rhs) MAIDSAFE_NOEXCEPT {
   using std::swap;
   swap(lhs.id, rhs.id);
   swap(lhs.connection_id, rhs.connection_id);
-  swap(lhs.public_key, rhs.public_key);
+  // Swapping keys copies them, so is skipped in the usual case of neither being set.
+  if (!IsEmpty(lhs.public_key) || !IsEmpty(rhs.public_key))
+    swap(lhs.public_key, rhs.public_key);
   swap(lhs.rank, rhs.rank);
   swap(lhs.bucket, rhs.bucket);
   swap(lhs.nat_type, rhs.nat_type);
   swap(lhs.dimension_list, rhs.dimension_list);
+  swap(lhs.shared_public_key_, rhs.shared_public_key_);
 }
 
 }  // namespace routing
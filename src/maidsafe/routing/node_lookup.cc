@@ -0,0 +1,192 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/node_lookup.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+NodeLookup::NodeLookup(AsioService& asio_service, const NodeId& target, unsigned int parallelism,
+                       unsigned int shortlist_size,
+                       std::chrono::steady_clock::duration response_timeout, QueryFunctor query,
+                       DoneFunctor done)
+    : kTarget_(target),
+      kParallelism_(std::max(parallelism, 1U)),
+      kShortlistSize_(std::max(shortlist_size, 1U)),
+      kResponseTimeout_(response_timeout),
+      query_(std::move(query)),
+      done_(std::move(done)),
+      mutex_(),
+      shortlist_(),
+      started_(false),
+      finished_(false),
+      timer_(asio_service.service()) {
+  assert(query_);
+}
+
+NodeLookup::~NodeLookup() {
+  boost::system::error_code error_code;
+  timer_.cancel(error_code);
+}
+
+void NodeLookup::Start(const std::vector<NodeId>& seeds) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  assert(!started_);
+  started_ = true;
+  AddCandidates(seeds, lock);
+  Advance(lock);
+}
+
+void NodeLookup::OnResponse(const NodeId& peer, const std::vector<NodeId>& nodes) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (finished_)
+    return;
+  auto itr(std::find_if(std::begin(shortlist_), std::end(shortlist_),
+                        [&peer](const Candidate& candidate) { return candidate.id == peer; }));
+  if (itr == std::end(shortlist_) || itr->state != State::kQueried)
+    return;
+  itr->state = State::kResponded;
+  AddCandidates(nodes, lock);
+  Advance(lock);
+}
+
+void NodeLookup::Cancel() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  finished_ = true;
+  boost::system::error_code error_code;
+  timer_.cancel(error_code);
+}
+
+bool NodeLookup::done() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return finished_;
+}
+
+void NodeLookup::AddCandidates(const std::vector<NodeId>& nodes,
+                               std::unique_lock<std::mutex>& lock) {
+  assert(lock.owns_lock());
+  static_cast<void>(lock);
+  for (const auto& node : nodes) {
+    if (node.IsZero() || node == kTarget_ ||
+        std::any_of(std::begin(shortlist_), std::end(shortlist_),
+                    [&node](const Candidate& candidate) { return candidate.id == node; })) {
+      continue;
+    }
+    shortlist_.emplace_back(node);
+  }
+  std::sort(std::begin(shortlist_), std::end(shortlist_),
+            [this](const Candidate& lhs, const Candidate& rhs) {
+              return NodeId::CloserToTarget(lhs.id, rhs.id, kTarget_);
+            });
+  // Candidates beyond the shortlist are dropped, unless still being queried; these are kept so
+  // that they continue to count against the parallelism limit until they answer or time out.
+  if (shortlist_.size() > kShortlistSize_) {
+    shortlist_.erase(std::remove_if(std::begin(shortlist_) + kShortlistSize_, std::end(shortlist_),
+                                    [](const Candidate& candidate) {
+                                      return candidate.state != State::kQueried;
+                                    }),
+                     std::end(shortlist_));
+  }
+}
+
+std::vector<NodeId> NodeLookup::NextQueries(std::unique_lock<std::mutex>& lock) {
+  assert(lock.owns_lock());
+  static_cast<void>(lock);
+  auto outstanding(static_cast<unsigned int>(std::count_if(
+      std::begin(shortlist_), std::end(shortlist_),
+      [](const Candidate& candidate) { return candidate.state == State::kQueried; })));
+  std::vector<NodeId> queries;
+  const auto kNow(std::chrono::steady_clock::now());
+  for (auto& candidate : shortlist_) {
+    if (outstanding >= kParallelism_)
+      break;
+    if (candidate.state != State::kNotQueried)
+      continue;
+    candidate.state = State::kQueried;
+    candidate.query_time = kNow;
+    queries.push_back(candidate.id);
+    ++outstanding;
+  }
+  finished_ = (outstanding == 0);
+  return queries;
+}
+
+void NodeLookup::ArmTimer(std::unique_lock<std::mutex>& lock) {
+  assert(lock.owns_lock());
+  static_cast<void>(lock);
+  auto earliest(std::chrono::steady_clock::time_point::max());
+  for (const auto& candidate : shortlist_) {
+    if (candidate.state == State::kQueried)
+      earliest = std::min(earliest, candidate.query_time);
+  }
+  std::weak_ptr<NodeLookup> this_weak_ptr(shared_from_this());
+  timer_.expires_at(earliest + kResponseTimeout_);
+  timer_.async_wait([this_weak_ptr](const boost::system::error_code& error) {
+    if (auto this_ptr = this_weak_ptr.lock())
+      this_ptr->OnTimeout(error);
+  });
+}
+
+void NodeLookup::OnTimeout(const boost::system::error_code& error) {
+  if (error == boost::asio::error::operation_aborted)
+    return;
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (finished_)
+    return;
+  const auto kNow(std::chrono::steady_clock::now());
+  for (auto& candidate : shortlist_) {
+    if (candidate.state == State::kQueried && candidate.query_time + kResponseTimeout_ <= kNow) {
+      LOG(kVerbose) << "FindNodes query to " << DebugId(candidate.id) << " timed out.";
+      candidate.state = State::kFailed;
+    }
+  }
+  Advance(lock);
+}
+
+void NodeLookup::Advance(std::unique_lock<std::mutex>& lock) {
+  auto queries(NextQueries(lock));
+  if (finished_) {
+    boost::system::error_code error_code;
+    timer_.cancel(error_code);
+    std::vector<NodeId> closest_nodes;
+    for (const auto& candidate : shortlist_) {
+      if (candidate.state == State::kResponded && closest_nodes.size() < kShortlistSize_)
+        closest_nodes.push_back(candidate.id);
+    }
+    lock.unlock();
+    LOG(kVerbose) << "Lookup for " << DebugId(kTarget_) << " done with "
+                  << closest_nodes.size() << " responsive nodes.";
+    if (done_)
+      done_(closest_nodes);
+    return;
+  }
+  ArmTimer(lock);
+  lock.unlock();
+  for (const auto& peer : queries)
+    query_(peer);
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,97 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_NODE_LOOKUP_H_
+#define MAIDSAFE_ROUTING_NODE_LOOKUP_H_
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "boost/asio/steady_timer.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/node_id.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// A Kademlia-style iterative lookup for the nodes closest to a target.  Up to 'parallelism'
+// FindNodes queries are kept outstanding to the closest not-yet-queried candidates in a shortlist
+// of 'shortlist_size' nodes.  Each response merges its nodes into the shortlist and tops the
+// outstanding queries back up, so that later queries go to ever closer candidates.  A query which
+// gets no response within 'response_timeout' is abandoned.  The lookup is done once every
+// candidate in the shortlist has answered or been abandoned, i.e. once responses stop turning up
+// closer nodes; the done functor is then invoked once with the final shortlist, closest first.
+class NodeLookup : public std::enable_shared_from_this<NodeLookup> {
+ public:
+  typedef std::function<void(const NodeId& peer)> QueryFunctor;
+  typedef std::function<void(const std::vector<NodeId>& closest_nodes)> DoneFunctor;
+
+  NodeLookup(AsioService& asio_service, const NodeId& target, unsigned int parallelism,
+             unsigned int shortlist_size, std::chrono::steady_clock::duration response_timeout,
+             QueryFunctor query, DoneFunctor done);
+  NodeLookup(const NodeLookup&) = delete;
+  NodeLookup(const NodeLookup&&) = delete;
+  NodeLookup& operator=(const NodeLookup&) = delete;
+  NodeLookup& operator=(const NodeLookup&&) = delete;
+  ~NodeLookup();
+
+  void Start(const std::vector<NodeId>& seeds);
+  // Responses from nodes which weren't queried (or whose query was abandoned) are ignored.
+  void OnResponse(const NodeId& peer, const std::vector<NodeId>& nodes);
+  // Abandons the lookup without invoking the done functor.
+  void Cancel();
+  bool done() const;
+  const NodeId& target() const { return kTarget_; }
+
+ private:
+  enum class State { kNotQueried, kQueried, kResponded, kFailed };
+  struct Candidate {
+    explicit Candidate(const NodeId& id_in) : id(id_in), state(State::kNotQueried), query_time() {}
+    NodeId id;
+    State state;
+    std::chrono::steady_clock::time_point query_time;
+  };
+
+  void AddCandidates(const std::vector<NodeId>& nodes, std::unique_lock<std::mutex>& lock);
+  // Returns the candidates to be queried now, and sets finished_ if there are none left.
+  std::vector<NodeId> NextQueries(std::unique_lock<std::mutex>& lock);
+  void ArmTimer(std::unique_lock<std::mutex>& lock);
+  void OnTimeout(const boost::system::error_code& error);
+  void Advance(std::unique_lock<std::mutex>& lock);
+
+  const NodeId kTarget_;
+  const unsigned int kParallelism_, kShortlistSize_;
+  const std::chrono::steady_clock::duration kResponseTimeout_;
+  const QueryFunctor query_;
+  const DoneFunctor done_;
+  mutable std::mutex mutex_;
+  std::vector<Candidate> shortlist_;
+  bool started_, finished_;
+  boost::asio::steady_timer timer_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_NODE_LOOKUP_H_
@@ -61,6 +61,53 @@ bptime::time_duration Parameters::connect_rpc_prune_timeout(
 uint32_t Parameters::max_data_size(rudp::ManagedConnections::kMaxMessageSize() - 10240);
 // TODO(Prakash): BEFORE_RELEASE enable caching after persona tests are passing
 bool Parameters::caching(true);
+unsigned int Parameters::message_pool_size(256);
+uint32_t Parameters::max_pooled_message_size(64 * 1024);
+uint64_t Parameters::max_cache_size_in_bytes(0);
+unsigned int Parameters::cache_shard_count(8);
+bool Parameters::cache_admission(false);
+unsigned int Parameters::cache_admission_threshold(2);
+boost::filesystem::path Parameters::disk_cache_directory;
+uint64_t Parameters::max_disk_cache_size_in_bytes(1024 * 1024 * 1024);
+uint32_t Parameters::disk_cache_segment_size(64 * 1024 * 1024);
+size_t Parameters::disk_cache_write_queue_size(1024);
+bool Parameters::coalesce_cacheable_gets(false);
+unsigned int Parameters::max_coalesced_gets(64);
+std::chrono::steady_clock::duration Parameters::coalesced_get_timeout(std::chrono::seconds(1));
+unsigned int Parameters::validated_public_key_cache_size(1024);
+std::chrono::steady_clock::duration Parameters::public_key_request_batch_window(
+    std::chrono::milliseconds(20));
+unsigned int Parameters::max_public_key_request_batch_size(64);
+bool Parameters::verify_routing_signatures(false);
+unsigned int Parameters::signing_thread_count(1);
+unsigned int Parameters::signature_verification_threads(2);
+unsigned int Parameters::signature_verification_cache_size(4096);
+unsigned int Parameters::callback_thread_count(2);
+unsigned int Parameters::callback_queue_capacity(4096);
+unsigned int Parameters::message_inbox_capacity(4096);
+unsigned int Parameters::message_inbox_batch_size(64);
+unsigned int Parameters::state_shard_count(16);
+unsigned int Parameters::decode_thread_count(1);
+unsigned int Parameters::transmit_thread_count(1);
+unsigned int Parameters::pipeline_queue_capacity(4096);
+unsigned int Parameters::pipeline_batch_size(64);
+std::chrono::steady_clock::duration Parameters::connection_loss_batch_window(
+    std::chrono::milliseconds(100));
+std::chrono::steady_clock::duration Parameters::close_nodes_change_quiet_period(
+    std::chrono::steady_clock::duration::zero());
+std::chrono::steady_clock::duration Parameters::close_nodes_change_max_hold(
+    std::chrono::seconds(5));
+unsigned int Parameters::find_nodes_parallelism(3);
+std::chrono::steady_clock::duration Parameters::find_nodes_response_timeout(
+    std::chrono::seconds(2));
+unsigned int Parameters::max_concurrent_connect_attempts(8);
+std::chrono::steady_clock::duration Parameters::connect_attempt_timeout(std::chrono::seconds(10));
+bool Parameters::request_routing_table_on_join(true);
+std::chrono::steady_clock::duration Parameters::routing_table_save_interval(
+    std::chrono::seconds(10));
+std::chrono::system_clock::duration Parameters::max_saved_contact_age(std::chrono::hours(1));
+std::chrono::steady_clock::duration Parameters::bootstrap_contact_flush_interval(
+    std::chrono::seconds(5));
 }  // namespace routing
 
 }  // namespace maidsafe
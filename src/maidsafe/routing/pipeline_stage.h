@@ -0,0 +1,153 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_PIPELINE_STAGE_H_
+#define MAIDSAFE_ROUTING_PIPELINE_STAGE_H_
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// One stage of a processing pipeline: a bounded queue of items, worked through in batches of up to
+// 'batch_size' by the stage's own 'thread_count' threads.  A full queue (or a stage with no
+// threads) refuses further items, leaving the caller to process them itself; this bounds the
+// memory held by a backed-up stage, and avoids blocking - or deadlocking - a caller which is
+// itself one of this stage's workers.  On destruction, queued items are processed before the
+// threads are joined.
+template <typename Item>
+class PipelineStage {
+ public:
+  typedef std::function<void(std::vector<Item>& /*batch*/)> BatchFunctor;
+
+  PipelineStage(unsigned int thread_count, size_t capacity, size_t batch_size,
+                BatchFunctor process_batch);
+  PipelineStage(const PipelineStage&) = delete;
+  PipelineStage(const PipelineStage&&) = delete;
+  PipelineStage& operator=(const PipelineStage&) = delete;
+  PipelineStage& operator=(const PipelineStage&&) = delete;
+  ~PipelineStage();
+
+  // Returns false, leaving 'item' untouched, if the queue is full or the stage has no threads.
+  bool TryPush(Item& item);
+  size_t queue_depth() const;
+
+ private:
+  void Run();
+
+  const size_t kCapacity_, kBatchSize_;
+  const BatchFunctor process_batch_;
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::deque<Item> items_;
+  bool stopped_;
+  std::vector<std::thread> threads_;
+};
+
+// ==================== Implementation =============================================================
+template <typename Item>
+PipelineStage<Item>::PipelineStage(unsigned int thread_count, size_t capacity, size_t batch_size,
+                                   BatchFunctor process_batch)
+    : kCapacity_(capacity),
+      kBatchSize_(std::max(batch_size, static_cast<size_t>(1))),
+      process_batch_(std::move(process_batch)),
+      mutex_(),
+      condition_(),
+      items_(),
+      stopped_(false),
+      threads_() {
+  for (unsigned int i(0); i < thread_count; ++i)
+    threads_.emplace_back([this] { Run(); });
+}
+
+template <typename Item>
+PipelineStage<Item>::~PipelineStage() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  condition_.notify_all();
+  for (auto& thread : threads_) {
+    if (thread.get_id() == std::this_thread::get_id()) {
+      LOG(kError) << "PipelineStage destroyed from one of its own workers";
+      thread.detach();
+    } else {
+      thread.join();
+    }
+  }
+}
+
+template <typename Item>
+bool PipelineStage<Item>::TryPush(Item& item) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (threads_.empty() || stopped_ || items_.size() >= kCapacity_)
+      return false;
+    items_.push_back(std::move(item));
+  }
+  condition_.notify_one();
+  return true;
+}
+
+template <typename Item>
+size_t PipelineStage<Item>::queue_depth() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return items_.size();
+}
+
+template <typename Item>
+void PipelineStage<Item>::Run() {
+  std::vector<Item> batch;
+  batch.reserve(kBatchSize_);
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    condition_.wait(lock, [this] { return stopped_ || !items_.empty(); });
+    if (items_.empty())
+      return;  // stopped and drained
+    while (!items_.empty() && batch.size() != kBatchSize_) {
+      batch.push_back(std::move(items_.front()));
+      items_.pop_front();
+    }
+    lock.unlock();
+    try {
+      process_batch_(batch);
+    }
+    catch (const std::exception& e) {
+      LOG(kError) << "Pipeline stage failed to process a batch: " << e.what();
+    }
+    batch.clear();
+    lock.lock();
+  }
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_PIPELINE_STAGE_H_
@@ -18,76 +18,101 @@
 
 #include "maidsafe/routing/public_key_holder.h"
 
+#include <vector>
+
+#include "maidsafe/common/log.h"
+
 #include "maidsafe/routing/network.h"
 
 namespace maidsafe {
 
 namespace routing {
 
-PublicKeyHolder::PublicKeyHolder(AsioService& io_service, Network &network)
-    : mutex_(), io_service_(io_service), network_(network), elements_() {}
+PublicKeyHolder::PublicKeyHolder(AsioService& io_service, Network& network)
+    : state_(std::make_shared<State>(io_service.service(), network)) {}
 
 PublicKeyHolder::~PublicKeyHolder() {
-  std::for_each(std::begin(elements_), std::end(elements_),
-                [](const PublicKeyInfo& info) {
-                  info.timer->cancel();
-                });
-  while (!elements_.empty()) {}
+  {
+    std::lock_guard<std::mutex> network_lock(state_->network_mutex);
+    state_->network = nullptr;
+  }
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->timer.cancel();
+  state_->elements.clear();
+  state_->expiry_queue.clear();
 }
 
 bool PublicKeyHolder::Add(const NodeId& peer, const asymm::PublicKey& public_key) {
-  std::lock_guard<std::mutex> lock(mutex_);
-  if (std::any_of(std::begin(elements_), std::end(elements_),
-                  [&](const PublicKeyInfo& info) {
-                    return info.peer == peer;
-                  }))
+  auto expiry_time(std::chrono::steady_clock::now() +
+                   std::chrono::seconds(Parameters::public_key_holding_time));
+  Entry entry(std::make_shared<const asymm::PublicKey>(public_key), expiry_time);
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  if (!state_->elements.emplace(peer.string(), std::move(entry)).second)
     return false;
-  auto timer(std::make_shared<boost::asio::deadline_timer>(
-      io_service_.service(), boost::posix_time::seconds(Parameters::public_key_holding_time)));
-  timer->async_wait([peer, this](const boost::system::error_code& error) {
-                      {
-                        std::lock_guard<std::mutex> lock(mutex_);
-                        this->elements_.erase(std::remove_if(
-                            std::begin(this->elements_), std::end(this->elements_),
-                            [peer](const PublicKeyInfo& info) {
-                              return info.peer == peer;
-                            }), std::end(this->elements_));
-                      }
-                      if (!error) {
-                        this->network_.Remove(peer);
-                      }
-                    });
-  elements_.emplace_back(PublicKeyInfo(peer, public_key, timer));
+  // If the queue was empty, no wait is outstanding; otherwise the pending wait is for an earlier
+  // expiry and the handler re-arms the timer for this one in due course.
+  bool arm_timer(state_->expiry_queue.empty());
+  state_->expiry_queue.emplace_back(expiry_time, peer);
+  if (arm_timer)
+    ArmTimer(state_);
   return true;
 }
 
-boost::optional<asymm::PublicKey> PublicKeyHolder::Find(const NodeId& peer) const {
-  boost::optional<asymm::PublicKey> public_key;
-
-  std::lock_guard<std::mutex> lock(mutex_);
-  auto iter(std::find_if(std::begin(elements_), std::end(elements_),
-                         [&](const PublicKeyInfo& info) {
-                           return info.peer == peer;
-                         }));
-  if (iter != std::end(elements_))
-    public_key.reset(iter->public_key);
-  return public_key;
+NodeInfo::PublicKeyPtr PublicKeyHolder::Find(const NodeId& peer) const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  auto itr(state_->elements.find(peer.string()));
+  return itr == std::end(state_->elements) ? nullptr : itr->second.public_key;
 }
 
 void PublicKeyHolder::Remove(const NodeId& peer) {
-  TimerPointer timer;
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  state_->elements.erase(peer.string());
+}
+
+size_t PublicKeyHolder::size() const {
+  std::lock_guard<std::mutex> lock(state_->mutex);
+  return state_->elements.size();
+}
+
+void PublicKeyHolder::ArmTimer(const std::shared_ptr<State>& state) {
+  // Must be called with state->mutex held and a non-empty expiry queue.
+  state->timer.expires_at(state->expiry_queue.front().first);
+  state->timer.async_wait([state](const boost::system::error_code& error) {
+    HandleTimeout(state, error);
+  });
+}
+
+void PublicKeyHolder::HandleTimeout(const std::shared_ptr<State>& state,
+                                    const boost::system::error_code& error) {
+  if (error == boost::asio::error::operation_aborted)
+    return;
+  if (error)
+    LOG(kWarning) << "Public key holder timer error: " << error.message();
+
+  std::vector<NodeId> expired_peers;
   {
-    std::lock_guard<std::mutex> lock(mutex_);
-    auto element(std::find_if(std::begin(elements_), std::end(elements_),
-                              [&](const PublicKeyInfo& info) {
-                                return info.peer == peer;
-                              }));
-
-    if (element != std::end(elements_)) {
-      timer = element->timer;
+    std::lock_guard<std::mutex> lock(state->mutex);
+    auto now(std::chrono::steady_clock::now());
+    while (!state->expiry_queue.empty() && state->expiry_queue.front().first <= now) {
+      const auto& expiry(state->expiry_queue.front());
+      auto itr(state->elements.find(expiry.second.string()));
+      if (itr != std::end(state->elements) && itr->second.expiry_time == expiry.first) {
+        state->elements.erase(itr);
+        expired_peers.push_back(expiry.second);
+      }
+      state->expiry_queue.pop_front();
     }
+    if (!state->expiry_queue.empty())
+      ArmTimer(state);
   }
-  timer->cancel();
+
+  if (expired_peers.empty())
+    return;
+  std::lock_guard<std::mutex> network_lock(state->network_mutex);
+  if (!state->network)
+    return;
+  for (const auto& peer : expired_peers)
+    state->network->Remove(peer);
 }
 
 }  // namespace routing
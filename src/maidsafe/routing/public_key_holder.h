@@ -19,15 +19,20 @@
 #ifndef MAIDSAFE_ROUTING_PUBLIC_KEY_HOLDER_H_
 #define MAIDSAFE_ROUTING_PUBLIC_KEY_HOLDER_H_
 
-#include <vector>
+#include <chrono>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
 
-#include "boost/asio/deadline_timer.hpp"
-#include "boost/optional.hpp"
+#include "boost/asio/steady_timer.hpp"
 
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/common/asio_service.h"
 
+#include "maidsafe/routing/node_info.h"
 #include "maidsafe/routing/parameters.h"
 
 
@@ -37,17 +42,11 @@ namespace routing {
 
 class Network;
 
-typedef std::shared_ptr<boost::asio::deadline_timer> TimerPointer;
-typedef std::function<void(const boost::system::error_code& error)> Handler;
-
-struct PublicKeyInfo {
-  PublicKeyInfo(const NodeId& peer_in, const asymm::PublicKey public_key_in, TimerPointer timer_in)
-      : peer(peer_in), public_key(public_key_in), timer(timer_in) {}
-  NodeId peer;
-  asymm::PublicKey public_key;
-  TimerPointer timer;
-};
-
+// Holds the public keys of peers which are part way through a connect handshake.  Entries are
+// indexed by the peer's ID and all expire through a single shared timer: since every entry is held
+// for the same Parameters::public_key_holding_time, the expiry queue is ordered by insertion and
+// the timer only ever needs to be armed for the entry at its front.  An expired entry is dropped
+// and the peer removed from the network; an entry removed via Remove is dropped silently.
 class PublicKeyHolder {
  public:
   explicit PublicKeyHolder(AsioService& asio_service, Network& network);
@@ -57,14 +56,49 @@ class PublicKeyHolder {
   PublicKeyHolder& operator=(const PublicKeyHolder&&) = delete;
   ~PublicKeyHolder();
   bool Add(const NodeId& peer, const asymm::PublicKey& public_key);
-  boost::optional<asymm::PublicKey> Find(const NodeId& peer) const;
+  // Returns the handle made for the key by Add(), which the peer's NodeInfo can then share, or null
+  // if there is none.
+  NodeInfo::PublicKeyPtr Find(const NodeId& peer) const;
   void Remove(const NodeId& peer);
+  size_t size() const;
 
  private:
-  mutable std::mutex mutex_;
-  AsioService& io_service_;
-  Network& network_;
-  std::vector<PublicKeyInfo> elements_;
+  typedef std::chrono::steady_clock::time_point TimePoint;
+
+  struct Entry {
+    Entry(NodeInfo::PublicKeyPtr public_key_in, TimePoint expiry_time_in)
+        : public_key(std::move(public_key_in)), expiry_time(expiry_time_in) {}
+    NodeInfo::PublicKeyPtr public_key;
+    TimePoint expiry_time;
+  };
+
+  // Shared with the pending timer handler so that the handler never outlives the state it touches.
+  struct State {
+    State(boost::asio::io_service& io_service, Network& network_in)
+        : mutex(),
+          network_mutex(),
+          network(&network_in),
+          elements(),
+          expiry_queue(),
+          timer(io_service) {}
+    std::mutex mutex;
+    // Held while 'network' is used, so that the holder's destructor (which nulls it) waits for any
+    // expired peers being removed from the network.  Separate from 'mutex' since Network::Remove
+    // may call back into this holder.
+    std::mutex network_mutex;
+    Network* network;  // null once the holder has been destroyed
+    std::unordered_map<std::string, Entry> elements;  // keyed by NodeId::string()
+    // Oldest first.  May hold stale items for entries which have since been removed or re-added;
+    // these are skipped when their expiry time no longer matches the entry in 'elements'.
+    std::deque<std::pair<TimePoint, NodeId>> expiry_queue;
+    boost::asio::steady_timer timer;
+  };
+
+  static void ArmTimer(const std::shared_ptr<State>& state);
+  static void HandleTimeout(const std::shared_ptr<State>& state,
+                            const boost::system::error_code& error);
+
+  std::shared_ptr<State> state_;
 };
 
 }  // namespace routing
@@ -72,4 +106,3 @@ class PublicKeyHolder {
 }  // namespace maidsafe
 
 #endif  // MAIDSAFE_ROUTING_PUBLIC_KEY_HOLDER_H_
-
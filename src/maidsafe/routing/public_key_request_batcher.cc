@@ -0,0 +1,124 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/public_key_request_batcher.h"
+
+#include <atomic>
+#include <utility>
+
+#include "maidsafe/common/log.h"
+
+#include "maidsafe/routing/parameters.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+PublicKeyRequestBatcher::PublicKeyRequestBatcher(AsioService& asio_service)
+    : request_public_keys_(), mutex_(), pending_(), timer_(asio_service.service()) {}
+
+PublicKeyRequestBatcher::~PublicKeyRequestBatcher() {
+  boost::system::error_code error_code;
+  timer_.cancel(error_code);
+}
+
+void PublicKeyRequestBatcher::set_request_public_keys_functor(
+    RequestPublicKeysFunctor request_public_keys) {
+  request_public_keys_ = request_public_keys;
+}
+
+void PublicKeyRequestBatcher::Request(const NodeId& peer, GivePublicKeyFunctor give_public_key) {
+  assert(request_public_keys_);
+  PendingRequests batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool first_in_batch(pending_.empty());
+    pending_[peer].push_back(give_public_key);
+    if (pending_.size() >= Parameters::max_public_key_request_batch_size) {
+      batch.swap(pending_);
+    } else if (first_in_batch) {
+      std::weak_ptr<PublicKeyRequestBatcher> this_weak_ptr(shared_from_this());
+      timer_.expires_from_now(Parameters::public_key_request_batch_window);
+      timer_.async_wait([this_weak_ptr](const boost::system::error_code& error) {
+        if (auto this_ptr = this_weak_ptr.lock())
+          this_ptr->OnTimeout(error);
+      });
+    }
+  }
+  if (!batch.empty())
+    SendBatch(std::move(batch));
+}
+
+RequestPublicKeyFunctor PublicKeyRequestBatcher::GetRequestPublicKeyFunctor() {
+  std::weak_ptr<PublicKeyRequestBatcher> this_weak_ptr(shared_from_this());
+  return [this_weak_ptr](NodeId peer, GivePublicKeyFunctor give_public_key) {
+    if (auto this_ptr = this_weak_ptr.lock())
+      this_ptr->Request(peer, give_public_key);
+  };
+}
+
+void PublicKeyRequestBatcher::OnTimeout(const boost::system::error_code& error) {
+  if (error == boost::asio::error::operation_aborted)
+    return;
+  PendingRequests batch;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    batch.swap(pending_);
+  }
+  if (!batch.empty())
+    SendBatch(std::move(batch));
+}
+
+void PublicKeyRequestBatcher::SendBatch(PendingRequests batch) {
+  std::vector<NodeId> peers;
+  peers.reserve(batch.size());
+  for (const auto& request : batch)
+    peers.push_back(request.first);
+  LOG(kVerbose) << "Requesting public keys for " << peers.size() << " nodes";
+
+  struct Waiting {
+    explicit Waiting(PendingRequests requests_in)
+        : answered(false), requests(std::move(requests_in)) {}
+    std::atomic<bool> answered;
+    PendingRequests requests;
+  };
+  auto waiting(std::make_shared<Waiting>(std::move(batch)));
+  request_public_keys_(peers,
+                       [waiting](std::vector<std::pair<NodeId, asymm::PublicKey>> public_keys) {
+    if (waiting->answered.exchange(true)) {
+      LOG(kWarning) << "Public keys for a batch have already been given";
+      return;
+    }
+    for (const auto& public_key : public_keys) {
+      auto itr(waiting->requests.find(public_key.first));
+      if (itr == std::end(waiting->requests))
+        continue;
+      for (const auto& give_public_key : itr->second)
+        give_public_key(boost::optional<asymm::PublicKey>(public_key.second));
+      waiting->requests.erase(itr);
+    }
+    for (const auto& request : waiting->requests) {
+      for (const auto& give_public_key : request.second)
+        give_public_key(boost::optional<asymm::PublicKey>());
+    }
+  });
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,75 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_PUBLIC_KEY_REQUEST_BATCHER_H_
+#define MAIDSAFE_ROUTING_PUBLIC_KEY_REQUEST_BATCHER_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "boost/asio/steady_timer.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/node_id.h"
+
+#include "maidsafe/routing/api_config.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Adapts a user-supplied RequestPublicKeysFunctor to the per-node RequestPublicKeyFunctor used
+// during connect handshakes.  Requests are gathered for Parameters::public_key_request_batch_window
+// (or until Parameters::max_public_key_request_batch_size distinct nodes are waiting) and then
+// passed to the user in one call.  Concurrent requests for the same node share a single entry in
+// the batch.  Each waiting GivePublicKeyFunctor is invoked exactly once, with no key if the node
+// was omitted from the user's reply.
+class PublicKeyRequestBatcher : public std::enable_shared_from_this<PublicKeyRequestBatcher> {
+ public:
+  explicit PublicKeyRequestBatcher(AsioService& asio_service);
+  PublicKeyRequestBatcher(const PublicKeyRequestBatcher&) = delete;
+  PublicKeyRequestBatcher(const PublicKeyRequestBatcher&&) = delete;
+  PublicKeyRequestBatcher& operator=(const PublicKeyRequestBatcher&) = delete;
+  PublicKeyRequestBatcher& operator=(const PublicKeyRequestBatcher&&) = delete;
+  ~PublicKeyRequestBatcher();
+
+  // Must be called before any requests are made.
+  void set_request_public_keys_functor(RequestPublicKeysFunctor request_public_keys);
+  void Request(const NodeId& peer, GivePublicKeyFunctor give_public_key);
+  // Returns a functor which forwards to Request for as long as this object exists.
+  RequestPublicKeyFunctor GetRequestPublicKeyFunctor();
+
+ private:
+  typedef std::map<NodeId, std::vector<GivePublicKeyFunctor>> PendingRequests;
+
+  void OnTimeout(const boost::system::error_code& error);
+  void SendBatch(PendingRequests batch);
+
+  RequestPublicKeysFunctor request_public_keys_;
+  std::mutex mutex_;
+  PendingRequests pending_;
+  boost::asio::steady_timer timer_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_PUBLIC_KEY_REQUEST_BATCHER_H_
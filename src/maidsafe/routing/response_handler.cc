@@ -22,6 +22,7 @@
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <utility>
 
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/node_id.h"
@@ -29,6 +30,7 @@
 #include "maidsafe/rudp/return_codes.h"
 
 #include "maidsafe/routing/client_routing_table.h"
+#include "maidsafe/routing/connection_manager.h"
 #include "maidsafe/routing/network.h"
 #include "maidsafe/routing/return_codes.h"
 #include "maidsafe/routing/routing.pb.h"
@@ -52,7 +54,8 @@ ResponseHandler::ResponseHandler(
     RoutingTable& routing_table, ClientRoutingTable& client_routing_table, Network& network,
     PublicKeyHolder& public_key_holder)
     : mutex_(), routing_table_(routing_table), client_routing_table_(client_routing_table),
-      network_(network), request_public_key_functor_(), public_key_holder_(public_key_holder)  {}
+      network_(network), request_public_key_functor_(), public_key_holder_(public_key_holder),
+      find_nodes_response_functor_(), connection_manager_() {}
 
 ResponseHandler::~ResponseHandler() {}
 
@@ -67,33 +70,41 @@ void ResponseHandler::Ping(protobuf::Message& message) {
 }
 
 void ResponseHandler::Connect(protobuf::Message& message) {
+  // Every return which doesn't hand the peer to rudp must release its connect attempt slot, or the
+  // ConnectionManager will never start another attempt in its place.
+  const NodeId source_id(message.has_source_id() ? NodeId(message.source_id()) : NodeId());
   protobuf::ConnectResponse connect_response;
   protobuf::ConnectRequest connect_request;
   if (!connect_response.ParseFromString(message.data(0))) {
     LOG(kError) << "Could not parse connect response";
+    FinishConnectAttempt(source_id);
     return;
   }
 
   if (!connect_request.ParseFromString(connect_response.original_request())) {
     LOG(kError) << "Could not parse original connect request"
                 << " id: " << message.id();
+    FinishConnectAttempt(source_id);
     return;
   }
 
   if (connect_response.answer() == protobuf::ConnectResponseType::kRejected) {
     LOG(kInfo) << "Peer rejected this node's connection request."
                << " id: " << message.id();
+    FinishConnectAttempt(source_id);
     return;
   }
 
   if (connect_response.answer() == protobuf::ConnectResponseType::kConnectAttemptAlreadyRunning) {
     LOG(kInfo) << "Already ongoing connection attempt with : "
                << HexSubstr(connect_response.contact().node_id());
+    FinishConnectAttempt(source_id);
     return;
   }
 
   if (NodeId(connect_response.contact().node_id()).IsZero()) {
     LOG(kError) << "Invalid contact details";
+    FinishConnectAttempt(source_id);
     return;
   }
 
@@ -110,6 +121,7 @@ void ResponseHandler::Connect(protobuf::Message& message) {
     if (peer_endpoint_pair.external.address().is_unspecified() &&
         peer_endpoint_pair.local.address().is_unspecified()) {
       LOG(kError) << "Invalid peer endpoint details";
+      FinishConnectAttempt(node_to_add.id);
       return;
     }
 
@@ -123,14 +135,20 @@ void ResponseHandler::Connect(protobuf::Message& message) {
     if (!public_key_holder_.Find(peer_node_id)) {
       LOG(kError)  << "missing public key ";
       message.Clear();
+      FinishConnectAttempt(peer_node_id);
       return;
     }
 
     auto result(AddToRudp(network_, routing_table_.kNodeId(), routing_table_.kConnectionId(),
                           peer_node_id, peer_connection_id, peer_endpoint_pair, true,  // requestor
                           routing_table_.client_mode()));
-    if (result != kSuccess)
+    if (result != kSuccess) {
       LOG(kVerbose) << "Already added node";
+      FinishConnectAttempt(peer_node_id);
+    }
+  } else {
+    LOG(kVerbose) << "No longer want to connect to " << node_to_add.id;
+    FinishConnectAttempt(node_to_add.id);
   }
 }
 
@@ -154,12 +172,8 @@ void ResponseHandler::FindNodes(const protobuf::Message& message) {
       return;
     }
   }
-  //  if (asymm::CheckSignature(find_nodes.original_request(),
-  //                            find_nodes.original_signature(),
-  //                            routing_table.kKeys().public_key) != kSuccess) {
-  //    LOG(kError) << " find node request was not signed by us";
-  //    return;  // we never requested this
-  //  }
+  // If Parameters::verify_routing_signatures is set, original_signature has already been checked
+  // against our public key by MessageHandler's SignatureVerifier.
 
   LOG(kVerbose) << "[" << routing_table_.kNodeId() << "] received FindNodes response from "
                 << HexSubstr(message.source_id()) << " id: " << message.id();
@@ -171,16 +185,28 @@ void ResponseHandler::FindNodes(const protobuf::Message& message) {
 
   LOG(kVerbose) << find_node_result;
 
+  std::vector<NodeId> nodes;
   for (int i = 0; i < find_nodes_response.nodes_size(); ++i) {
-    if (!find_nodes_response.nodes(i).empty())
-      CheckAndSendConnectRequest(NodeId(find_nodes_response.nodes(i)));
+    if (!find_nodes_response.nodes(i).empty()) {
+      nodes.push_back(NodeId(find_nodes_response.nodes(i)));
+      CheckAndSendConnectRequest(nodes.back());
+    }
   }
+  if (find_nodes_response_functor_ && message.has_source_id())
+    find_nodes_response_functor_(NodeId(message.source_id()), nodes);
 }
 
-void ResponseHandler::SendConnectRequest(const NodeId peer_node_id) {
+void ResponseHandler::ConnectTo(const std::vector<NodeId>& peers) {
+  // Queued with the connection manager (if any), these are connected to close group and empty
+  // buckets first, several at a time.
+  for (const auto& peer : peers)
+    CheckAndSendConnectRequest(peer);
+}
+
+bool ResponseHandler::SendConnectRequest(const NodeId peer_node_id) {
   if (network_.bootstrap_connection_id().IsZero() && (routing_table_.size() == 0)) {
     LOG(kWarning) << "Need to re bootstrap !";
-    return;
+    return false;
   }
   bool send_to_bootstrap_connection((routing_table_.size() < Parameters::closest_nodes_size) &&
                                     !network_.bootstrap_connection_id().IsZero());
@@ -189,7 +215,7 @@ void ResponseHandler::SendConnectRequest(const NodeId peer_node_id) {
 
   if (peer.id == NodeId(routing_table_.kNodeId())) {
     //    LOG(kInfo) << "Can't send connect request to self !";
-    return;
+    return false;
   }
 
   if (routing_table_.CheckNode(peer)) {
@@ -209,7 +235,7 @@ void ResponseHandler::SendConnectRequest(const NodeId peer_node_id) {
       } else {
         LOG(kVerbose) << "Already ongoing attempt to : " << DebugId(peer.id);
       }
-      return;
+      return false;
     }
     assert((!this_endpoint_pair.external.address().is_unspecified() ||
             !this_endpoint_pair.local.address().is_unspecified()) &&
@@ -227,11 +253,13 @@ void ResponseHandler::SendConnectRequest(const NodeId peer_node_id) {
     LOG(kVerbose) << "Sending Connect RPC to " << peer.id
                   << " message id : " << connect_rpc.id();
     if (send_to_bootstrap_connection)
-      network_.SendToDirect(connect_rpc, network_.bootstrap_connection_id(),
-                            network_.bootstrap_connection_id());
+      network_.SignAndSendToDirect(std::move(connect_rpc), network_.bootstrap_connection_id(),
+                                   network_.bootstrap_connection_id());
     else
-      network_.SendToClosestNode(connect_rpc);
+      network_.SignAndSendToClosestNode(std::move(connect_rpc));
+    return true;
   }
+  return false;
 }
 
 void ResponseHandler::ConnectSuccess(protobuf::Message& message) {
@@ -282,8 +310,9 @@ void ResponseHandler::ConnectSuccessAcknowledgement(protobuf::Message& message)
 void ResponseHandler::ValidateAndCompleteConnectionToClient(const NodeInfo& peer,
                                                             bool from_requestor,
                                                             const std::vector<NodeId>& close_ids) {
+  FinishConnectAttempt(peer.id);
   if (ValidateAndAddToRoutingTable(network_, routing_table_, client_routing_table_, peer.id,
-                                   peer.connection_id, asymm::PublicKey(), true)) {
+                                   peer.connection_id, nullptr, true)) {
     if (from_requestor) {
       HandleSuccessAcknowledgementAsReponder(peer, true);
     } else {
@@ -294,6 +323,7 @@ void ResponseHandler::ValidateAndCompleteConnectionToClient(const NodeInfo& peer
 
 void ResponseHandler::ValidateAndCompleteConnectionToNonClient(
     const NodeInfo& peer, bool from_requestor, const std::vector<NodeId>& close_ids) {
+  FinishConnectAttempt(peer.id);
   auto peer_public_key(public_key_holder_.Find(peer.id));
   if (!peer_public_key) {
     LOG(kVerbose) << "missing public key for " << peer.id;
@@ -301,7 +331,7 @@ void ResponseHandler::ValidateAndCompleteConnectionToNonClient(
   }
   public_key_holder_.Remove(peer.id);
   if (ValidateAndAddToRoutingTable(network_, routing_table_, client_routing_table_, peer.id,
-                                   peer.connection_id, *peer_public_key, false)) {
+                                   peer.connection_id, peer_public_key, false)) {
     if (from_requestor) {
       HandleSuccessAcknowledgementAsReponder(peer, false);
     } else {
@@ -349,27 +379,52 @@ void ResponseHandler::CheckAndSendConnectRequest(const NodeId& node_id) {
   if ((routing_table_.size() < routing_table_.kMaxSize()) ||
       NodeId::CloserToTarget(
           node_id, routing_table_.GetNthClosestNode(routing_table_.kNodeId(), limit).id,
-          routing_table_.kNodeId()))
-    ValidateAndSendConnectRequest(node_id);
+          routing_table_.kNodeId())) {
+    if (connection_manager_)
+      connection_manager_->Add(node_id);
+    else
+      ValidateAndSendConnectRequest(node_id);
+  }
 }
 
 void ResponseHandler::ValidateAndSendConnectRequest(const NodeId& peer_id) {
   std::weak_ptr<ResponseHandler> response_handler_weak_ptr = shared_from_this();
   if (request_public_key_functor_) {
     auto validate_node([=](boost::optional<asymm::PublicKey> public_key) {
+      std::shared_ptr<ResponseHandler> response_handler = response_handler_weak_ptr.lock();
+      if (!response_handler)
+        return;
       if (!public_key) {
         LOG(kError) << "Failed to retrieve public key for: " << peer_id;
+        response_handler->FinishConnectAttempt(peer_id);
         return;
       }
-      if (std::shared_ptr<ResponseHandler> response_handler = response_handler_weak_ptr.lock()) {
-        response_handler->public_key_holder_.Add(peer_id, *public_key);
-        response_handler->SendConnectRequest(peer_id);
-      }
+      response_handler->public_key_holder_.Add(peer_id, *public_key);
+      if (!response_handler->SendConnectRequest(peer_id))
+        response_handler->FinishConnectAttempt(peer_id);
     });
     request_public_key_functor_(peer_id, validate_node);
+  } else {
+    FinishConnectAttempt(peer_id);
   }
 }
 
+int ResponseHandler::ConnectPriority(const NodeId& peer) const {
+  if ((routing_table_.size() < Parameters::closest_nodes_size) ||
+      NodeId::CloserToTarget(
+          peer,
+          routing_table_.GetNthClosestNode(routing_table_.kNodeId(),
+                                           Parameters::closest_nodes_size).id,
+          routing_table_.kNodeId()))
+    return 2;
+  return routing_table_.NodesInBucketOf(peer) == 0 ? 1 : 0;
+}
+
+void ResponseHandler::FinishConnectAttempt(const NodeId& peer) {
+  if (connection_manager_)
+    connection_manager_->Finished(peer);
+}
+
 void ResponseHandler::CloseNodeUpdateForClient(protobuf::Message& message) {
   assert(routing_table_.client_mode());
   if (message.destination_id() != routing_table_.kNodeId().string()) {
@@ -443,6 +498,26 @@ RequestPublicKeyFunctor ResponseHandler::request_public_key_functor() const {
   return request_public_key_functor_;
 }
 
+void ResponseHandler::set_find_nodes_response_functor(
+    FindNodesResponseFunctor find_nodes_response) {
+  find_nodes_response_functor_ = find_nodes_response;
+}
+
+void ResponseHandler::ManageConnectAttempts(AsioService& asio_service) {
+  std::weak_ptr<ResponseHandler> response_handler_weak_ptr(shared_from_this());
+  connection_manager_ = std::make_shared<ConnectionManager>(
+      asio_service, routing_table_.kNodeId(), Parameters::max_concurrent_connect_attempts,
+      routing_table_.kMaxSize(), Parameters::connect_attempt_timeout,
+      [response_handler_weak_ptr](const NodeId& peer) {
+        std::shared_ptr<ResponseHandler> response_handler = response_handler_weak_ptr.lock();
+        return response_handler ? response_handler->ConnectPriority(peer) : 0;
+      },
+      [response_handler_weak_ptr](const NodeId& peer) {
+        if (std::shared_ptr<ResponseHandler> response_handler = response_handler_weak_ptr.lock())
+          response_handler->ValidateAndSendConnectRequest(peer);
+      });
+}
+
 }  // namespace routing
 
 }  // namespace maidsafe
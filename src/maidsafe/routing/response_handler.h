@@ -29,6 +29,7 @@
 #include "boost/asio/deadline_timer.hpp"
 #include "boost/date_time/posix_time/ptime.hpp"
 
+#include "maidsafe/common/asio_service.h"
 #include "maidsafe/common/rsa.h"
 #include "maidsafe/rudp/managed_connections.h"
 
@@ -48,11 +49,16 @@ namespace test {
 class ResponseHandlerTest_BEH_ConnectAttempts_Test;
 }  // namespace test
 
+class ConnectionManager;
 class Network;
 class ClientRoutingTable;
 class RoutingTable;
 class GroupChangeHandler;
 
+// Invoked with the sender and contents of each FindNodes response (see NodeLookup).
+typedef std::function<void(const NodeId& /*responder*/, const std::vector<NodeId>& /*nodes*/)>
+    FindNodesResponseFunctor;
+
 class ResponseHandler : public std::enable_shared_from_this<ResponseHandler> {
  public:
   ResponseHandler(RoutingTable& routing_table, ClientRoutingTable& client_routing_table,
@@ -64,17 +70,28 @@ class ResponseHandler : public std::enable_shared_from_this<ResponseHandler> {
   virtual void ConnectSuccessAcknowledgement(protobuf::Message& message);
   void set_request_public_key_functor(RequestPublicKeyFunctor request_public_key);
   RequestPublicKeyFunctor request_public_key_functor() const;
+  void set_find_nodes_response_functor(FindNodesResponseFunctor find_nodes_response);
+  // Runs this handler's outgoing connect handshakes through a ConnectionManager rather than
+  // starting them all at once.  Must be called before messages are handled.
+  void ManageConnectAttempts(AsioService& asio_service);
   void GetGroup(Timer<std::string>& timer, protobuf::Message& message);
   void CloseNodeUpdateForClient(protobuf::Message& message);
   void InformClientOfNewCloseNode(protobuf::Message& message);
   void ConnectSuccess(protobuf::Message& message);
+  // Starts connect handshakes to those of peers which would be added to the routing table (queued
+  // by the connection manager if there is one).
+  void ConnectTo(const std::vector<NodeId>& peers);
 
   friend class test::ResponseHandlerTest_BEH_ConnectAttempts_Test;
 
  private:
-  void SendConnectRequest(const NodeId peer_node_id);
+  // Returns false if no request was sent.
+  bool SendConnectRequest(const NodeId peer_node_id);
   void CheckAndSendConnectRequest(const NodeId& node_id);
   void ValidateAndSendConnectRequest(const NodeId& peer_id);
+  // 2 if peer would be one of this node's close nodes, 1 if it would fill an empty bucket, else 0.
+  int ConnectPriority(const NodeId& peer) const;
+  void FinishConnectAttempt(const NodeId& peer);
   void HandleSuccessAcknowledgementAsRequestor(const std::vector<NodeId>& close_ids);
   void HandleSuccessAcknowledgementAsReponder(NodeInfo peer, bool client);
   void ValidateAndCompleteConnectionToClient(const NodeInfo& peer, bool from_requestor,
@@ -88,6 +105,8 @@ class ResponseHandler : public std::enable_shared_from_this<ResponseHandler> {
   Network& network_;
   RequestPublicKeyFunctor request_public_key_functor_;
   PublicKeyHolder& public_key_holder_;
+  FindNodesResponseFunctor find_nodes_response_functor_;
+  std::shared_ptr<ConnectionManager> connection_manager_;
 };
 
 }  // namespace routing
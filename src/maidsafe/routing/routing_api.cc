@@ -28,15 +28,21 @@ typedef boost::asio::ip::udp::endpoint Endpoint;
 }
 
 Routing::Routing() : pimpl_() {
-  InitialisePimpl(true, NodeId(NodeId::IdType::kRandomId), asymm::GenerateKeyPair());
+  InitialisePimpl(true, NodeId(NodeId::IdType::kRandomId), asymm::GenerateKeyPair(),
+                  RoutingOptions());
+}
+
+Routing::Routing(const RoutingOptions& options) : pimpl_() {
+  InitialisePimpl(true, NodeId(NodeId::IdType::kRandomId), asymm::GenerateKeyPair(), options);
 }
 
 Routing::~Routing() {
   pimpl_->Stop();
 }
 
-void Routing::InitialisePimpl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys) {
-  pimpl_.reset(new Impl(client_mode, node_id, keys));
+void Routing::InitialisePimpl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys,
+                              const RoutingOptions& options) {
+  pimpl_.reset(new Impl(client_mode, node_id, keys, options));
 }
 
 void Routing::Join(Functors functors) {
@@ -103,6 +109,12 @@ bool Routing::IsConnectedClient(const NodeId& node_id) {
   return pimpl_->IsConnectedClient(node_id);
 }
 
+size_t Routing::callback_queue_depth() const { return pimpl_->callback_queue_depth(); }
+
+uint64_t Routing::callback_queue_overflow_count() const {
+  return pimpl_->callback_queue_overflow_count();
+}
+
 void UpdateNetworkHealth(int updated_health, int& current_health, std::mutex& mutex,
                          std::condition_variable& cond_var, const NodeId& this_node_id) {
   {
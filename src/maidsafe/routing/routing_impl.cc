@@ -19,7 +19,9 @@
 #include "maidsafe/routing/routing_impl.h"
 
 #include <cstdint>
+#include <set>
 #include <type_traits>
+#include <utility>
 
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/make_unique.h"
@@ -30,6 +32,7 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/routing/bootstrap_file_operations.h"
+#include "maidsafe/routing/bootstrap_utils.h"
 #include "maidsafe/routing/message.h"
 #include "maidsafe/routing/message_handler.h"
 #include "maidsafe/routing/node_info.h"
@@ -48,6 +51,30 @@ namespace {
 
 typedef boost::asio::ip::udp::endpoint Endpoint;
 
+// Threads of an AsioService owned by a Routing object, each given an inbox ring of its own.
+const unsigned int kOwnedAsioServiceThreads(2);
+
+// Routing objects given a shared AsioService also share one executor, so that a process running
+// many of them doesn't start Parameters::callback_thread_count threads for each.
+std::shared_ptr<CallbackExecutor> MakeCallbackExecutor(bool shared) {
+  if (Parameters::callback_thread_count == 0)
+    return nullptr;
+  if (!shared) {
+    return std::make_shared<CallbackExecutor>(Parameters::callback_thread_count,
+                                              Parameters::callback_queue_capacity);
+  }
+  static std::mutex mutex;
+  static std::weak_ptr<CallbackExecutor> shared_executor;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto executor(shared_executor.lock());
+  if (!executor) {
+    executor = std::make_shared<CallbackExecutor>(Parameters::callback_thread_count,
+                                                  Parameters::callback_queue_capacity);
+    shared_executor = executor;
+  }
+  return executor;
+}
+
 }  // unnamed namespace
 
 namespace detail {}  // namespace detail
@@ -90,28 +117,104 @@ protobuf::Message Routing::Impl::CreateNodeLevelMessage(const GroupToSingleRelay
   return proto_message;
 }
 
-Routing::Impl::Impl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys)
+Routing::Impl::Impl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys,
+                    const RoutingOptions& options)
     : network_status_mutex_(),
       network_status_(kNotJoined),
-      routing_table_(maidsafe::make_unique<RoutingTable>(client_mode, node_id, keys)),
+      routing_table_(maidsafe::make_unique<RoutingTable>(
+          client_mode, node_id, keys,
+          client_mode ? options.max_routing_table_size_for_client.get_value_or(
+                            Parameters::max_routing_table_size_for_client)
+                      : options.max_routing_table_size.get_value_or(
+                            Parameters::max_routing_table_size),
+          client_mode ? options.max_routing_table_size_for_client.get_value_or(
+                            Parameters::max_routing_table_size_for_client)
+                      : options.routing_table_size_threshold.get_value_or(
+                            Parameters::routing_table_size_threshold))),
       kNodeId_(node_id),
       running_(true),
       running_mutex_(),
+      lost_connections_mutex_(),
+      lost_connections_(),
+      routing_table_save_pending_(false),
+      last_contact_mutex_(),
+      last_contact_(),
+      node_lookup_mutex_(),
       functors_(),
       random_node_helper_(),
       // TODO(Prakash) : don't create client_routing_table for client nodes (wrap both)
       client_routing_table_(node_id),
+      message_pool_(Parameters::message_pool_size, Parameters::max_pooled_message_size),
+      // One ring per thread of an owned AsioService; a shared service runs this node's handlers
+      // serially on strand_, so more would only split the batches.  Messages are steered by source
+      // to a ring.  A ring has one drain at a time, and its decoded batches are handled in order on
+      // its own strand, so each source's messages are handled in order and its Firewall shard by
+      // one thread at a time.
+      message_inbox_(options.asio_service ? 1 : kOwnedAsioServiceThreads,
+                     Parameters::message_inbox_capacity, Parameters::message_inbox_batch_size,
+                     [this](std::function<void()> drain) {
+                       if (!running_)
+                         return;
+                       if (decode_stage_ && decode_stage_->TryPush(drain))
+                         return;
+                       std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
+                       Post([this_ptr, drain]() { drain(); });
+                     },
+                     [this](std::vector<std::string>& messages) {
+                       DoOnMessagesReceived(messages);
+                     },
+                     &MessageShardIndex),
+      decode_stage_(options.decode_thread_count.get_value_or(Parameters::decode_thread_count) == 0
+                        ? nullptr
+                        : maidsafe::make_unique<PipelineStage<std::function<void()>>>(
+                              options.decode_thread_count.get_value_or(
+                                  Parameters::decode_thread_count),
+                              Parameters::pipeline_queue_capacity, 1,
+                              [](std::vector<std::function<void()>>& drains) {
+                                for (auto& drain : drains)
+                                  drain();
+                              })),
+      callback_executor_(MakeCallbackExecutor(static_cast<bool>(options.asio_service))),
+      callback_lifetime_(std::make_shared<Lifetime>()),
+      kCloseNodesChangeQuietPeriod_(options.close_nodes_change_quiet_period.get_value_or(
+          Parameters::close_nodes_change_quiet_period)),
       message_handler_(),
-      asio_service_(2),
-      network_utils_(node_id, asio_service_),
-      network_(maidsafe::make_unique<Network>(*routing_table_, client_routing_table_,
-                                              network_utils_.acknowledgement_)),
-      timer_(asio_service_),
-      re_bootstrap_timer_(asio_service_.service()),
-      recovery_timer_(asio_service_.service()),
-      setup_timer_(asio_service_.service()) {
+      kSharedAsioService_(static_cast<bool>(options.asio_service)),
+      asio_service_(kSharedAsioService_
+                        ? options.asio_service
+                        : std::make_shared<AsioService>(kOwnedAsioServiceThreads)),
+      strand_(kSharedAsioService_ ? maidsafe::make_unique<boost::asio::io_service::strand>(
+                                        asio_service_->service())
+                                  : std::unique_ptr<boost::asio::io_service::strand>()),
+      inbox_strands_(),
+      network_utils_(node_id, *asio_service_),
+      network_(maidsafe::make_unique<Network>(
+          *routing_table_, client_routing_table_, network_utils_.acknowledgement_,
+          options.transmit_thread_count.get_value_or(Parameters::transmit_thread_count),
+          options.signing_thread_count.get_value_or(Parameters::signing_thread_count))),
+      timer_(*asio_service_),
+      re_bootstrap_timer_(asio_service_->service()),
+      recovery_timer_(asio_service_->service()),
+      setup_timer_(asio_service_->service()),
+      connection_lost_timer_(asio_service_->service()),
+      routing_table_save_timer_(asio_service_->service()),
+      bootstrap_contact_store_(std::make_shared<BootstrapContactStore>(
+          *asio_service_, client_mode ? detail::GetCurrentBootstrapFilePath<true>()
+                                      : detail::GetCurrentBootstrapFilePath<false>(),
+          Parameters::bootstrap_contact_flush_interval)),
+      routing_table_writer_(MakeRoutingTableWriter(kSharedAsioService_)),
+      close_nodes_change_coalescer_(),
+      node_lookup_() {
+  if (!kSharedAsioService_) {
+    for (unsigned int i(0); i != kOwnedAsioServiceThreads; ++i) {
+      inbox_strands_.push_back(
+          maidsafe::make_unique<boost::asio::io_service::strand>(asio_service_->service()));
+    }
+  }
   message_handler_.reset(new MessageHandler(*routing_table_, client_routing_table_, *network_,
-                                            timer_, network_utils_, asio_service_));
+                                            timer_, network_utils_, *asio_service_));
+  message_handler_->set_caching(options.caching.get_value_or(Parameters::caching));
+  network_->set_bootstrap_contact_store(bootstrap_contact_store_);
   LOG(kInfo) << (client_mode ? "client " : "non-client ") << "node. Id : " << kNodeId_;
   assert((client_mode || !node_id.IsZero()) && "Server Nodes cannot be created without valid keys");
 }
@@ -124,25 +227,43 @@ void Routing::Impl::Stop() {
     running_ = false;
   }
 
-  // below is a work-around and not a fix for routing destruction issues.
-  // this must be replaced with an appropriate fix as soon as possible.
-  // TOBE FIXED  {
-  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-  while (this_ptr.use_count() > 6) {
-    Sleep(std::chrono::seconds(1));
-    LOG(kVerbose) << "Waiting for pending operations to complete";
-  }
-
-  // }  // TOBE FIXED
-
   network_utils_.acknowledgement_.RemoveAll();
   timer_.CancelAll();
   re_bootstrap_timer_.cancel();
   recovery_timer_.cancel();
   setup_timer_.cancel();
-  asio_service_.Stop();
-  // Need to destroy network_ & routing_table_ as they hold a lambda capture (functor) of
-  // shared_from_this()
+  connection_lost_timer_.cancel();
+  routing_table_save_timer_.cancel();
+  if (routing_table_writer_)
+    SaveRoutingTable();
+  bootstrap_contact_store_->Flush();
+  if (close_nodes_change_coalescer_)
+    close_nodes_change_coalescer_->Cancel();
+  {
+    std::lock_guard<std::mutex> lock(node_lookup_mutex_);
+    if (node_lookup_)
+      node_lookup_->Cancel();
+  }
+
+  // Handlers already queued, including the cancelled timers' ones, hold shared_from_this() and may
+  // still use any member, so the members are only destroyed in ~Impl(), once the last of them has
+  // run.  Nothing owned by this object holds it strongly (rudp's functors hold it weakly), so this
+  // doesn't wait for them.  A shared service is owned by the application, which keeps it running,
+  // so they run there in due course.  An owned one is stopped here; handlers still queued once its
+  // threads have been joined are run on this thread, so that none is left holding this object.
+  if (!kSharedAsioService_) {
+    asio_service_->Stop();
+    asio_service_->service().reset();
+    asio_service_->service().poll();
+  }
+}
+
+Routing::Impl::~Impl() {
+  // decode_stage_ first so that no drain is still posting to the strands, then callback_lifetime_
+  // so that no callback is still running when the objects it may call into are destroyed, then the
+  // objects which use asio_service_, network_ and routing_table_.
+  decode_stage_.reset();
+  callback_lifetime_->Close();
   message_handler_.reset();
   network_.reset();
   routing_table_.reset();
@@ -154,11 +275,18 @@ void Routing::Impl::Join(const Functors& functors) {
   Bootstrap();
 }
 
-void Routing::Impl::ConnectFunctors(const Functors& functors) {
-  functors_ = functors;
-  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-  routing_table_->InitialiseFunctors([this_ptr](const RoutingTableChange& routing_table_change) {
-                                      this_ptr->OnRoutingTableChange(routing_table_change);
+void Routing::Impl::ConnectFunctors(const Functors& functors_in) {
+  functors_ = WrapFunctors(functors_in);
+  const Functors& functors(functors_);
+  if (functors.close_nodes_change &&
+      kCloseNodesChangeQuietPeriod_ != std::chrono::steady_clock::duration::zero()) {
+    close_nodes_change_coalescer_ = std::make_shared<CloseNodesChangeCoalescer>(
+        *asio_service_, kCloseNodesChangeQuietPeriod_, Parameters::close_nodes_change_max_hold,
+        functors.close_nodes_change);
+  }
+  // routing_table_ is owned by this object and only calls this functor while routing is using it.
+  routing_table_->InitialiseFunctors([this](const RoutingTableChange& routing_table_change) {
+                                      OnRoutingTableChange(routing_table_change);
                                     });
   // only one of MessageAndCachingFunctors or TypedMessageAndCachingFunctor should be provided
   assert(!functors.message_and_caching.message_received !=
@@ -178,24 +306,108 @@ void Routing::Impl::ConnectFunctors(const Functors& functors) {
   else
     message_handler_->set_typed_message_and_caching_functor(functors.typed_message_and_caching);
 
-  message_handler_->set_request_public_key_functor(functors.request_public_key);
+  if (functors.request_public_keys)
+    message_handler_->set_request_public_keys_functor(functors.request_public_keys);
+  else
+    message_handler_->set_request_public_key_functor(functors.request_public_key);
+
+  message_handler_->set_find_nodes_response_functor([this](const NodeId& responder,
+                                                           const std::vector<NodeId>& nodes) {
+    std::shared_ptr<NodeLookup> node_lookup;
+    {
+      std::lock_guard<std::mutex> lock(node_lookup_mutex_);
+      node_lookup = node_lookup_;
+    }
+    if (node_lookup)
+      node_lookup->OnResponse(responder, nodes);
+  });
+  // Messages verified on the signature verifier's threads resume here, as received ones do.  Held
+  // weakly, as message_handler_ is owned by this object.
+  std::weak_ptr<Routing::Impl> this_weak_ptr(shared_from_this());
+  message_handler_->set_post_functor([this_weak_ptr](std::function<void()> handler) {
+    if (std::shared_ptr<Routing::Impl> this_ptr = this_weak_ptr.lock())
+      this_ptr->Post([this_ptr, handler]() { handler(); });
+  });
+}
+
+std::shared_ptr<PipelineStage<Routing::Impl::RoutingTableSave>>
+    Routing::Impl::MakeRoutingTableWriter(bool shared) {
+  if (Parameters::routing_table_save_interval == std::chrono::steady_clock::duration::zero())
+    return nullptr;
+  auto write([](std::vector<RoutingTableSave>& saves) {
+    // Only the latest of any queued snapshots of a node's routing table is worth writing.
+    std::set<std::pair<NodeId, bool>> written;
+    for (auto itr(saves.rbegin()); itr != saves.rend(); ++itr) {
+      if (written.insert(std::make_pair(itr->owner_id, itr->client_mode)).second)
+        SaveRoutingTableContacts(itr->owner_id, itr->contacts, itr->client_mode);
+    }
+  });
+  if (!shared)
+    return std::make_shared<PipelineStage<RoutingTableSave>>(1, 2, 2, write);
+  static std::mutex mutex;
+  static std::weak_ptr<PipelineStage<RoutingTableSave>> shared_writer;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto writer(shared_writer.lock());
+  if (!writer) {
+    writer = std::make_shared<PipelineStage<RoutingTableSave>>(
+        1, Parameters::pipeline_queue_capacity, Parameters::pipeline_batch_size, write);
+    shared_writer = writer;
+  }
+  return writer;
+}
+
+Functors Routing::Impl::WrapFunctors(Functors functors) const {
+  if (!callback_executor_)
+    return functors;
+  auto& executor(*callback_executor_);
+  const auto& lifetime(callback_lifetime_);
+  functors.message_and_caching.message_received =
+      executor.Wrap(functors.message_and_caching.message_received, lifetime);
+  functors.message_and_caching.have_cache_data =
+      executor.Wrap(functors.message_and_caching.have_cache_data, lifetime);
+  functors.message_and_caching.store_cache_data =
+      executor.Wrap(functors.message_and_caching.store_cache_data, lifetime);
+  // get_cache_data returns its result synchronously, so stays on routing's threads.
+  auto& typed(functors.typed_message_and_caching);
+  typed.single_to_single.message_received =
+      executor.Wrap(typed.single_to_single.message_received, lifetime);
+  typed.single_to_single.put_cache_data =
+      executor.Wrap(typed.single_to_single.put_cache_data, lifetime);
+  typed.single_to_group.message_received =
+      executor.Wrap(typed.single_to_group.message_received, lifetime);
+  typed.single_to_group.put_cache_data =
+      executor.Wrap(typed.single_to_group.put_cache_data, lifetime);
+  typed.group_to_single.message_received =
+      executor.Wrap(typed.group_to_single.message_received, lifetime);
+  typed.group_to_single.put_cache_data =
+      executor.Wrap(typed.group_to_single.put_cache_data, lifetime);
+  typed.group_to_group.message_received =
+      executor.Wrap(typed.group_to_group.message_received, lifetime);
+  typed.group_to_group.put_cache_data =
+      executor.Wrap(typed.group_to_group.put_cache_data, lifetime);
+  typed.single_to_group_relay.message_received =
+      executor.Wrap(typed.single_to_group_relay.message_received, lifetime);
+  // Each of these describes the latest state, so must be seen in the order it was reported.
+  functors.network_status = executor.WrapOrdered(functors.network_status, lifetime);
+  functors.close_nodes_change = executor.WrapOrdered(functors.close_nodes_change, lifetime);
+  functors.set_public_key = executor.Wrap(functors.set_public_key, lifetime);
+  functors.request_public_key = executor.Wrap(functors.request_public_key, lifetime);
+  functors.request_public_keys = executor.Wrap(functors.request_public_keys, lifetime);
+  return functors;
 }
 
 void Routing::Impl::Bootstrap() {
-  {
-    std::lock_guard<std::mutex>  lock(running_mutex_);
-    if (!running_)
-      return;
-  }
+  if (!running_)
+    return;
   int return_value(DoBootstrap());
   if (kSuccess != return_value) {
     re_bootstrap_timer_.expires_from_now(Parameters::re_bootstrap_time_lag);
     std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-    re_bootstrap_timer_.async_wait(
+    re_bootstrap_timer_.async_wait(Wrap(
         [this_ptr](boost::system::error_code error_code) {
           if (error_code != boost::asio::error::operation_aborted)
             this_ptr->Bootstrap();
-        });
+        }));
     NotifyNetworkStatus(return_value);
     return;
   }
@@ -220,20 +432,22 @@ int Routing::Impl::DoBootstrap() {
     network_->Remove(network_->bootstrap_connection_id());
     network_->clear_bootstrap_connection_info();
   }
-  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
+  // network_ is owned by this object, so holds it weakly; see Stop().
+  std::weak_ptr<Routing::Impl> this_weak_ptr(shared_from_this());
   return network_->Bootstrap(
-      [this_ptr](const std::string& message) { this_ptr->OnMessageReceived(message); },
-      [this_ptr](const NodeId& lost_connection_id) {
-        this_ptr->OnConnectionLost(lost_connection_id);
+      [this_weak_ptr](const std::string& message) {
+        if (std::shared_ptr<Routing::Impl> this_ptr = this_weak_ptr.lock())
+          this_ptr->OnMessageReceived(message);
+      },
+      [this_weak_ptr](const NodeId& lost_connection_id) {
+        if (std::shared_ptr<Routing::Impl> this_ptr = this_weak_ptr.lock())
+          this_ptr->OnConnectionLost(lost_connection_id);
       });
 }
 
 void Routing::Impl::FindClosestNode(const boost::system::error_code& error_code, int attempts) {
-  {
-    std::lock_guard<std::mutex> lock(running_mutex_);
-    if (!running_)
-      return;
-  }
+  if (!running_)
+    return;
   if (error_code == boost::asio::error::operation_aborted)
     return;
 
@@ -243,6 +457,9 @@ void Routing::Impl::FindClosestNode(const boost::system::error_code& error_code,
            "Relay connection id should be set after bootstrapping succeeds");
   } else {
     if (routing_table_->size() > 0) {
+      // Fill the routing table straight away rather than waiting for the first recovery round.
+      if (Parameters::find_nodes_parallelism != 0)
+        StartNodeLookup(static_cast<int>(routing_table_->kMaxSize()));
       std::lock_guard<std::mutex> lock(running_mutex_);
       if (!running_)
         return;
@@ -251,10 +468,10 @@ void Routing::Impl::FindClosestNode(const boost::system::error_code& error_code,
                     << " Terminating setup loop & Scheduling recovery loop.";
       recovery_timer_.expires_from_now(Parameters::find_node_interval);
       std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-      recovery_timer_.async_wait([this_ptr](const boost::system::error_code& error_code) {
+      recovery_timer_.async_wait(Wrap([this_ptr](const boost::system::error_code& error_code) {
         if (error_code != boost::asio::error::operation_aborted)
           this_ptr->ReSendFindNodeRequest(error_code, false);
-      });
+      }));
       return;
     }
 
@@ -272,7 +489,12 @@ void Routing::Impl::FindClosestNode(const boost::system::error_code& error_code,
   LOG(kVerbose) << "   [" << kNodeId_ << "] (attempt " << attempts << ")  requesting "
                 << num_nodes_requested << " nodes (id: " << find_node_rpc.id() << ")";
   std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-  rudp::MessageSentFunctor message_sent_functor([this_ptr, find_node_rpc](int message_sent) {
+  // Held weakly: rudp, which holds this functor, is owned by this object.
+  std::weak_ptr<Routing::Impl> this_weak_ptr(this_ptr);
+  rudp::MessageSentFunctor message_sent_functor([this_weak_ptr, find_node_rpc](int message_sent) {
+    std::shared_ptr<Routing::Impl> this_ptr(this_weak_ptr.lock());
+    if (!this_ptr)
+      return;
     if (message_sent == kSuccess)
       LOG(kVerbose) << "   [" << this_ptr->kNodeId_ << "] sent : "
                     << MessageTypeString(find_node_rpc)
@@ -283,17 +505,35 @@ void Routing::Impl::FindClosestNode(const boost::system::error_code& error_code,
                   << this_ptr->network_->bootstrap_connection_id();
   });
 
+  if (attempts == 0 &&
+      Parameters::routing_table_save_interval != std::chrono::steady_clock::duration::zero())
+    ReconnectToSavedContacts();
+
+  if (attempts == 0 && Parameters::request_routing_table_on_join) {
+    // The node closest to this one answers with a routing table's worth of its closest nodes (plus
+    // itself), all of which are handed to the connection manager at once.
+    protobuf::Message fill_rpc(rpcs::FindNodes(kNodeId_, kNodeId_,
+                                               static_cast<int>(routing_table_->kMaxSize()) + 1,
+                                               true, network_->this_node_relay_connection_id()));
+    network_->SignAndSendToDirect(std::move(fill_rpc), network_->bootstrap_connection_id(),
+                                  [](int message_sent) {
+                                    if (message_sent != kSuccess)
+                                      LOG(kWarning) << "Failed to send routing table FindNodes.";
+                                  });
+  }
+
   ++attempts;
-  network_->SendToDirect(find_node_rpc, network_->bootstrap_connection_id(), message_sent_functor);
+  network_->SignAndSendToDirect(std::move(find_node_rpc), network_->bootstrap_connection_id(),
+                                message_sent_functor);
 
   std::lock_guard<std::mutex> lock(running_mutex_);
   if (!running_)
     return;
   setup_timer_.expires_from_now(Parameters::find_close_node_interval);
-  setup_timer_.async_wait([this_ptr, attempts](boost::system::error_code error_code_local) {
+  setup_timer_.async_wait(Wrap([this_ptr, attempts](boost::system::error_code error_code_local) {
     if (error_code_local != boost::asio::error::operation_aborted)
       this_ptr->FindClosestNode(error_code_local, attempts);
-  });
+  }));
 }
 
 void Routing::Impl::ReBootstrap() {
@@ -305,11 +545,15 @@ int Routing::Impl::ZeroStateJoin(const Functors& functors, const Endpoint& local
                                  const Endpoint& peer_endpoint, const NodeInfo& peer_info) {
   assert((!routing_table_->client_mode()) && "no client nodes allowed in zero state network");
   ConnectFunctors(functors);
-  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
+  std::weak_ptr<Routing::Impl> this_weak_ptr(shared_from_this());
   int result(network_->ZeroStateBootstrap(
-      [this_ptr](const std::string& message) { this_ptr->OnMessageReceived(message); },
-      [this_ptr](const NodeId& lost_connection_id) {
-        this_ptr->OnConnectionLost(lost_connection_id);
+      [this_weak_ptr](const std::string& message) {
+        if (std::shared_ptr<Routing::Impl> this_ptr = this_weak_ptr.lock())
+          this_ptr->OnMessageReceived(message);
+      },
+      [this_weak_ptr](const NodeId& lost_connection_id) {
+        if (std::shared_ptr<Routing::Impl> this_ptr = this_weak_ptr.lock())
+          this_ptr->OnConnectionLost(lost_connection_id);
       },
       local_endpoint));
 
@@ -345,8 +589,12 @@ int Routing::Impl::ZeroStateJoin(const Functors& functors, const Endpoint& local
     return result;
   }
 
-  ValidateAndAddToRoutingTable(*network_, *routing_table_, client_routing_table_, peer_info.id,
-                               peer_info.id, peer_info.public_key, false);
+  ValidateAndAddToRoutingTable(
+      *network_, *routing_table_, client_routing_table_, peer_info.id, peer_info.id,
+      peer_info.shared_public_key()
+          ? peer_info.shared_public_key()
+          : std::make_shared<const asymm::PublicKey>(peer_info.public_key),
+      false);
   // Now poll for routing table size to have other zero state peer.
   uint8_t poll_count(0);
   do {
@@ -362,10 +610,10 @@ int Routing::Impl::ZeroStateJoin(const Functors& functors, const Endpoint& local
       return kNetworkShuttingDown;
     recovery_timer_.expires_from_now(Parameters::find_node_interval);
     std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-    recovery_timer_.async_wait([this_ptr](const boost::system::error_code& error_code) {
+    recovery_timer_.async_wait(Wrap([this_ptr](const boost::system::error_code& error_code) {
       if (error_code != boost::asio::error::operation_aborted)
         this_ptr->ReSendFindNodeRequest(error_code, false);
-    });
+    }));
     return kSuccess;
   } else {
     LOG(kError) << "Failed to join zero state network, with bootstrap_endpoint " << peer_endpoint;
@@ -399,8 +647,11 @@ void Routing::Impl::Send(const NodeId& destination_id, const std::string& data,
     if (DestinationType::kGroup == destination_type)
       expected_response_count = 4;
     proto_message.set_id(timer_.NewTaskId());
-    timer_.AddTask(Parameters::default_response_timeout, response_functor, expected_response_count,
-                   proto_message.id());
+    timer_.AddTask(Parameters::default_response_timeout,
+                   callback_executor_
+                       ? callback_executor_->Wrap(response_functor, callback_lifetime_)
+                       : response_functor,
+                   expected_response_count, proto_message.id());
   } else {
     proto_message.set_id(0);
   }
@@ -413,10 +664,10 @@ void Routing::Impl::SendMessage(const NodeId& destination_id, protobuf::Message&
   } else {  // Normal node
     proto_message.set_source_id(kNodeId_.string());
     if (kNodeId_ != destination_id) {
-      network_->SendToClosestNode(proto_message);
+      network_->SendToClosestNode(std::move(proto_message));
     } else if (routing_table_->client_mode()) {
       LOG(kVerbose) << "Client sending request to self id";
-      network_->SendToClosestNode(proto_message);
+      network_->SendToClosestNode(std::move(proto_message));
     } else {
       LOG(kInfo) << "Sending request to self";
       OnMessageReceived(proto_message.SerializeAsString());
@@ -430,14 +681,14 @@ void Routing::Impl::PartiallyJoinedSend(protobuf::Message& proto_message) {
   proto_message.set_relay_connection_id(network_->this_node_relay_connection_id().string());
   NodeId bootstrap_connection_id(network_->bootstrap_connection_id());
   assert(proto_message.has_relay_connection_id() && "did not set this_node_relay_connection_id");
-  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-  rudp::MessageSentFunctor message_sent([this_ptr, bootstrap_connection_id,
+  // Held weakly: rudp, which holds this functor, is owned by this object.
+  std::weak_ptr<Routing::Impl> this_weak_ptr(shared_from_this());
+  rudp::MessageSentFunctor message_sent([this_weak_ptr, bootstrap_connection_id,
                                         proto_message](int result) {
-    std::lock_guard<std::mutex> lock(this_ptr->running_mutex_);
-    if (!this_ptr->running_)
+    std::shared_ptr<Routing::Impl> this_ptr(this_weak_ptr.lock());
+    if (!this_ptr || !this_ptr->running_)
       return;
-    this_ptr->asio_service_.service().post([this_ptr, result, proto_message,
-                                           bootstrap_connection_id]() {
+    this_ptr->Post([this_ptr, result, proto_message, bootstrap_connection_id]() {
       if (rudp::kSuccess != result) {
         if (proto_message.id() != 0) {
           try {
@@ -539,16 +790,63 @@ std::future<std::vector<NodeId>> Routing::Impl::GetGroup(const NodeId& group_id)
 }
 
 void Routing::Impl::OnMessageReceived(const std::string& message) {
-  std::lock_guard<std::mutex> lock(running_mutex_);
-  if (running_) {
-    std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-    asio_service_.service().post([this_ptr, message]() { this_ptr->DoOnMessageReceived(message); });
+  // Called on rudp's threads for every datagram, so neither locks nor posts; message_inbox_ hands
+  // messages over in batches to DoOnMessagesReceived.
+  if (running_)
+    message_inbox_.Push(message);
+}
+
+void Routing::Impl::DoOnMessagesReceived(std::vector<std::string>& messages) {
+  if (!running_)
+    return;
+  auto batch(std::make_shared<std::vector<std::shared_ptr<protobuf::Message>>>(
+      DecodeMessages(messages)));
+  if (batch->empty())
+    return;
+  if (!decode_stage_)
+    return HandleMessages(*batch);
+  // All of a drain's messages are from one ring, and a ring's drains run one at a time, so its
+  // batches reach its strand in order.
+  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
+  std::function<void()> handle([this_ptr, batch]() { this_ptr->HandleMessages(*batch); });
+  if (inbox_strands_.empty())
+    Post(handle);
+  else
+    inbox_strands_[MessageShardIndex(messages.front(), inbox_strands_.size())]->post(handle);
+}
+
+void Routing::Impl::HandleMessages(std::vector<std::shared_ptr<protobuf::Message>>& batch) {
+  // These passes aren't threaded stages: each runs over the whole batch on this thread before the
+  // next starts, so that its code and data stay warm in cache.  Routing re-reads routing table
+  // state which earlier messages in the batch may have changed, so it isn't handed to another
+  // thread.
+  ClassifyMessages(batch);
+  for (auto& message : batch) {
+    if (!running_)
+      return;
+    message_handler_->HandleMessage(*message);
   }
 }
 
-void Routing::Impl::DoOnMessageReceived(const std::string& message) {
-  protobuf::Message pb_message;
-  if (pb_message.ParseFromString(message)) {
+std::vector<std::shared_ptr<protobuf::Message>> Routing::Impl::DecodeMessages(
+    const std::vector<std::string>& messages) {
+  std::vector<std::shared_ptr<protobuf::Message>> batch;
+  batch.reserve(messages.size());
+  for (const auto& message : messages) {
+    // Parsing into a recycled message reuses the memory of previously handled ones.
+    auto pooled_message(message_pool_.Acquire());
+    if (pooled_message->ParseFromString(message))
+      batch.push_back(std::move(pooled_message));
+    else
+      LOG(kWarning) << "Message received, failed to parse";
+  }
+  return batch;
+}
+
+void Routing::Impl::ClassifyMessages(std::vector<std::shared_ptr<protobuf::Message>>& batch) {
+  std::vector<NodeId> sources;
+  for (auto& message : batch) {
+    protobuf::Message& pb_message(*message);
     bool relay_message(!pb_message.has_source_id());
     LOG(kVerbose) << "   [" << kNodeId_ << "] rcvd : " << MessageTypeString(pb_message)
                   << " from " << (relay_message ? HexSubstr(pb_message.relay_id())
@@ -561,56 +859,73 @@ void Routing::Impl::DoOnMessageReceived(const std::string& message) {
       if (!source_id.IsZero())
         random_node_helper_.Add(source_id);
     }
-    {
-      std::lock_guard<std::mutex> lock(running_mutex_);
-      if (!running_)
-        return;
-    }
+    if (pb_message.has_source_id() && CheckId(pb_message.source_id()))
+      sources.push_back(NodeId(pb_message.source_id()));
+    if (!running_)
+      return;
     if (network_utils_.acknowledgement_.IsSendingAckRequired(pb_message, kNodeId())) {
       network_->SendAck(pb_message);
       pb_message.clear_ack_node_ids();
     }
-    message_handler_->HandleMessage(pb_message);
-  } else {
-    LOG(kWarning) << "Message received, failed to parse";
   }
+  RecordContacts(sources);
 }
 
 void Routing::Impl::OnConnectionLost(const NodeId& lost_connection_id) {
-  std::lock_guard<std::mutex> lock(running_mutex_);
-  if (running_) {
-    std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-    asio_service_.service().post([this_ptr, lost_connection_id]() {
-      this_ptr->DoOnConnectionLost(lost_connection_id);
+  if (!running_)
+    return;
+  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
+  if (Parameters::connection_loss_batch_window == std::chrono::steady_clock::duration::zero()) {
+    Post([this_ptr, lost_connection_id]() {
+      this_ptr->DoOnConnectionsLost(std::vector<NodeId>(1, lost_connection_id));
     });
+    return;
   }
-}
 
-void Routing::Impl::DoOnConnectionLost(const NodeId& lost_connection_id) {
-  LOG(kVerbose) << DebugId(kNodeId_) << "  Routing::ConnectionLost with -----------"
-                << DebugId(lost_connection_id);
   {
-    std::lock_guard<std::mutex> lock(running_mutex_);
-    if (!running_)
+    std::lock_guard<std::mutex> lock(lost_connections_mutex_);
+    lost_connections_.push_back(lost_connection_id);
+    if (lost_connections_.size() > 1)  // Timer already armed for this batch
       return;
   }
+  std::lock_guard<std::mutex> lock(running_mutex_);
+  if (!running_)
+    return;
+  connection_lost_timer_.expires_from_now(Parameters::connection_loss_batch_window);
+  connection_lost_timer_.async_wait(Wrap([this_ptr](const boost::system::error_code& error_code) {
+    if (error_code != boost::asio::error::operation_aborted)
+      this_ptr->FlushLostConnections();
+  }));
+}
 
-  NodeInfo dropped_node;
-  bool resend(
-      routing_table_->GetNodeInfo(lost_connection_id, dropped_node) &&
-      routing_table_->IsThisNodeInRange(dropped_node.id, Parameters::closest_nodes_size));
-
-  // Checking routing table
-  dropped_node = routing_table_->DropNode(lost_connection_id, true);
-  if (!dropped_node.id.IsZero()) {
-    LOG(kWarning) << "[" << DebugId(kNodeId_) << "]"
-                  << "Lost connection with routing node " << DebugId(dropped_node.id);
-    random_node_helper_.Remove(dropped_node.id);
+void Routing::Impl::FlushLostConnections() {
+  std::vector<NodeId> lost_connection_ids;
+  {
+    std::lock_guard<std::mutex> lock(lost_connections_mutex_);
+    lost_connection_ids.swap(lost_connections_);
   }
+  DoOnConnectionsLost(lost_connection_ids);
+}
+
+void Routing::Impl::DoOnConnectionsLost(const std::vector<NodeId>& lost_connection_ids) {
+  if (!running_)
+    return;
+
+  std::vector<NodeId> routing_nodes;
+  bool resend(false), lost_bootstrap_connection(false);
+  for (const auto& lost_connection_id : lost_connection_ids) {
+    LOG(kVerbose) << DebugId(kNodeId_) << "  Routing::ConnectionLost with -----------"
+                  << DebugId(lost_connection_id);
+    // Checking routing table
+    NodeInfo dropped_node;
+    if (routing_table_->GetNodeInfo(lost_connection_id, dropped_node)) {
+      resend = resend ||
+               routing_table_->IsThisNodeInRange(dropped_node.id, Parameters::closest_nodes_size);
+      routing_nodes.push_back(lost_connection_id);
+      continue;
+    }
 
-  // Checking non-routing table
-  if (dropped_node.id.IsZero()) {
-    resend = false;
+    // Checking non-routing table
     dropped_node = client_routing_table_.DropConnection(lost_connection_id);
     if (!dropped_node.id.IsZero()) {
       LOG(kWarning) << "[" << DebugId(kNodeId_) << "]"
@@ -621,15 +936,10 @@ void Routing::Impl::DoOnConnectionLost(const NodeId& lost_connection_id) {
       LOG(kWarning) << "[" << DebugId(kNodeId_) << "]"
                     << "Lost temporary connection with bootstrap node. connection id :"
                     << DebugId(lost_connection_id);
-      {
-        std::lock_guard<std::mutex> lock(running_mutex_);
-        if (!running_)
-          return;
-      }
+      if (!running_)
+        return;
       network_->clear_bootstrap_connection_info();
-
-      if (routing_table_->size() == 0)
-        resend = true;  // This will trigger rebootstrap
+      lost_bootstrap_connection = true;
     } else {
       LOG(kWarning) << "[" << DebugId(kNodeId_) << "]"
                     << "Lost connection with unknown/internal connection id "
@@ -637,30 +947,33 @@ void Routing::Impl::DoOnConnectionLost(const NodeId& lost_connection_id) {
     }
   }
 
+  if (!routing_nodes.empty()) {
+    for (const auto& dropped_node : routing_table_->DropNodes(routing_nodes, true)) {
+      LOG(kWarning) << "[" << DebugId(kNodeId_) << "]"
+                    << "Lost connection with routing node " << DebugId(dropped_node.id);
+      random_node_helper_.Remove(dropped_node.id);
+    }
+  }
+
+  if (lost_bootstrap_connection && routing_table_->size() == 0)
+    resend = true;  // This will trigger rebootstrap
+
   if (resend) {
-    std::lock_guard<std::mutex> lock(running_mutex_);
-    if (!running_)
-      return;
     // Close node lost, get more nodes
     LOG(kWarning) << "Lost close node, getting more.";
-    recovery_timer_.expires_from_now(Parameters::recovery_time_lag);
-    std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-    recovery_timer_.async_wait([this_ptr](const boost::system::error_code& error_code) {
-      if (error_code != boost::asio::error::operation_aborted)
-        this_ptr->ReSendFindNodeRequest(error_code, true);
-    });
+    ScheduleRecovery();
   }
 }
 
-void Routing::Impl::RemoveNode(const NodeInfo& node, bool internal_rudp_only) {
+bool Routing::Impl::RemoveNode(const NodeInfo& node, bool internal_rudp_only) {
   if (node.connection_id.IsZero() || node.id.IsZero())
-    return;
+    return false;
 
   network_->Remove(node.connection_id);
   if (internal_rudp_only) {  // No recovery
     LOG(kInfo) << "Routing: removed node : " << DebugId(node.id)
                << ". Removed internal rudp connection id : " << DebugId(node.connection_id);
-    return;
+    return false;
   }
 
   LOG(kInfo) << "Routing: removed node : " << DebugId(node.id)
@@ -668,21 +981,97 @@ void Routing::Impl::RemoveNode(const NodeInfo& node, bool internal_rudp_only) {
 
   // TODO(Prakash): Handle pseudo connection removal here and NRT node removal
 
-  bool resend(routing_table_->IsThisNodeInRange(node.id, Parameters::closest_nodes_size));
-  if (resend) {
-    std::lock_guard<std::mutex> lock(running_mutex_);
-    if (!running_)
-      return;
-    // Close node removed by routing, get more nodes
-    LOG(kWarning) << "[" << DebugId(kNodeId_)
-                  << "] Removed close node, sending find node to get more nodes.";
-    recovery_timer_.expires_from_now(Parameters::recovery_time_lag);
-    std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-    recovery_timer_.async_wait([this_ptr](const boost::system::error_code& error_code) {
-      if (error_code != boost::asio::error::operation_aborted)
-        this_ptr->ReSendFindNodeRequest(error_code, true);
-    });
+  return routing_table_->IsThisNodeInRange(node.id, Parameters::closest_nodes_size);
+}
+
+void Routing::Impl::ScheduleRecovery() {
+  std::lock_guard<std::mutex> lock(running_mutex_);
+  if (!running_)
+    return;
+  recovery_timer_.expires_from_now(Parameters::recovery_time_lag);
+  std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
+  recovery_timer_.async_wait(Wrap([this_ptr](const boost::system::error_code& error_code) {
+    if (error_code != boost::asio::error::operation_aborted)
+      this_ptr->ReSendFindNodeRequest(error_code, true);
+  }));
+}
+
+void Routing::Impl::ScheduleRoutingTableSave() {
+  std::lock_guard<std::mutex> lock(running_mutex_);
+  if (!running_ || routing_table_save_pending_)
+    return;
+  routing_table_save_pending_ = true;
+  routing_table_save_timer_.expires_from_now(Parameters::routing_table_save_interval);
+  // Held weakly so that a pending save doesn't hold up Stop(), which saves anyway.
+  std::weak_ptr<Routing::Impl> this_weak_ptr(shared_from_this());
+  routing_table_save_timer_.async_wait(
+      Wrap([this_weak_ptr](const boost::system::error_code& error) {
+        if (error == boost::asio::error::operation_aborted)
+          return;
+        if (std::shared_ptr<Routing::Impl> this_ptr = this_weak_ptr.lock()) {
+          {
+            std::lock_guard<std::mutex> lock(this_ptr->running_mutex_);
+            if (!this_ptr->running_)
+              return;
+            this_ptr->routing_table_save_pending_ = false;
+          }
+          this_ptr->SaveRoutingTable();
+        }
+      }));
+}
+
+void Routing::Impl::SaveRoutingTable() {
+  if (!routing_table_writer_)
+    return;
+  auto nodes(routing_table_->GetClosestNodes(kNodeId_, routing_table_->kMaxSize()));
+  // Keep what was saved last time rather than replacing it with nothing.
+  if (nodes.empty())
+    return;
+  RoutingTableSave save{kNodeId_, routing_table_->client_mode(), RoutingTableContacts()};
+  auto& contacts(save.contacts);
+  {
+    std::lock_guard<std::mutex> lock(last_contact_mutex_);
+    std::map<NodeId, std::chrono::system_clock::time_point> members_last_contact;
+    for (const auto& node : nodes) {
+      // Every member's contact is recorded as it's added, so this is only a fallback.
+      auto last_contact(last_contact_.insert(std::make_pair(node.id,
+                                                            std::chrono::system_clock::now())));
+      contacts.push_back(RoutingTableContact{node.id, last_contact.first->second});
+      members_last_contact.insert(*last_contact.first);
+    }
+    last_contact_.swap(members_last_contact);
+  }
+  if (routing_table_writer_->TryPush(save)) {
+    LOG(kVerbose) << "[" << kNodeId_ << "] saving " << nodes.size() << " routing table contacts.";
+  } else if (!running_) {
+    // This is the final save, made by Stop(), so write it here rather than lose it.
+    SaveRoutingTableContacts(kNodeId_, contacts, routing_table_->client_mode());
+  } else {
+    LOG(kWarning) << "[" << kNodeId_ << "] routing table saves backed up, skipping this one.";
+  }
+}
+
+void Routing::Impl::RecordContacts(const std::vector<NodeId>& node_ids) {
+  if (!routing_table_writer_ || node_ids.empty())
+    return;
+  const auto kNow(std::chrono::system_clock::now());
+  std::lock_guard<std::mutex> lock(last_contact_mutex_);
+  for (const auto& node_id : node_ids)
+    last_contact_[node_id] = kNow;
+}
+
+void Routing::Impl::ReconnectToSavedContacts() {
+  const auto kOldest(std::chrono::system_clock::now() - Parameters::max_saved_contact_age);
+  std::vector<NodeId> peers;
+  for (const auto& contact : GetRoutingTableContacts(kNodeId_, routing_table_->client_mode())) {
+    if (contact.last_seen >= kOldest)
+      peers.push_back(contact.node_id);
   }
+  if (peers.empty())
+    return;
+  LOG(kInfo) << "[" << kNodeId_ << "] reconnecting to " << peers.size()
+             << " saved routing table contacts.";
+  message_handler_->ConnectTo(peers);
 }
 
 bool Routing::Impl::ConfirmGroupMembers(const NodeId& node1, const NodeId& node2) {
@@ -691,11 +1080,8 @@ bool Routing::Impl::ConfirmGroupMembers(const NodeId& node1, const NodeId& node2
 
 void Routing::Impl::ReSendFindNodeRequest(const boost::system::error_code& error_code,
                                           bool ignore_size) {
-  {
-    std::lock_guard<std::mutex> lock(running_mutex_);
-    if (error_code == boost::asio::error::operation_aborted || !running_)
-      return;
-  }
+  if (error_code == boost::asio::error::operation_aborted || !running_)
+    return;
 
   if (routing_table_->size() == 0) {
     LOG(kError) << "[" << kNodeId_ << "]'s' Routing table is empty. Scheduling Re-Bootstrap.. !!!";
@@ -715,18 +1101,59 @@ void Routing::Impl::ReSendFindNodeRequest(const boost::system::error_code& error
     if (ignore_size && (routing_table_->size() > routing_table_->kThresholdSize()))
       num_nodes_requested = static_cast<int>(Parameters::closest_nodes_size);
     else
-      num_nodes_requested = static_cast<int>(Parameters::max_routing_table_size);
+      num_nodes_requested = static_cast<int>(routing_table_->kMaxSize());
 
-    protobuf::Message find_node_rpc(rpcs::FindNodes(kNodeId_, kNodeId_, num_nodes_requested));
-    network_->SendToClosestNode(find_node_rpc);
+    if (Parameters::find_nodes_parallelism != 0) {
+      StartNodeLookup(num_nodes_requested);
+    } else {
+      protobuf::Message find_node_rpc(rpcs::FindNodes(kNodeId_, kNodeId_, num_nodes_requested));
+      network_->SignAndSendToClosestNode(std::move(find_node_rpc));
+    }
 
     recovery_timer_.expires_from_now(Parameters::find_node_interval);
     std::shared_ptr<Routing::Impl> this_ptr(shared_from_this());
-    recovery_timer_.async_wait([this_ptr, error_code](boost::system::error_code error_code_local) {
-      if (error_code != boost::asio::error::operation_aborted)
-        this_ptr->ReSendFindNodeRequest(error_code_local, false);
-    });
+    recovery_timer_.async_wait(
+        Wrap([this_ptr, error_code](boost::system::error_code error_code_local) {
+          if (error_code != boost::asio::error::operation_aborted)
+            this_ptr->ReSendFindNodeRequest(error_code_local, false);
+        }));
+  }
+}
+
+void Routing::Impl::StartNodeLookup(int num_nodes_requested) {
+  std::vector<NodeId> seeds;
+  for (const auto& node : routing_table_->GetClosestNodes(kNodeId_,
+                                                          Parameters::closest_nodes_size)) {
+    seeds.push_back(node.id);
+  }
+  std::shared_ptr<NodeLookup> node_lookup;
+  {
+    std::lock_guard<std::mutex> lock(node_lookup_mutex_);
+    if (!running_ || (node_lookup_ && !node_lookup_->done()))
+      return;
+    std::weak_ptr<Routing::Impl> this_weak_ptr(shared_from_this());
+    node_lookup_ = std::make_shared<NodeLookup>(
+        *asio_service_, kNodeId_, Parameters::find_nodes_parallelism,
+        Parameters::closest_nodes_size, Parameters::find_nodes_response_timeout,
+        [this_weak_ptr, num_nodes_requested](const NodeId& peer) {
+          std::shared_ptr<Routing::Impl> this_ptr(this_weak_ptr.lock());
+          if (!this_ptr || !this_ptr->running_)
+            return;
+          protobuf::Message find_node_rpc(rpcs::FindNodesFromPeer(
+              peer, this_ptr->kNodeId_, this_ptr->kNodeId_, num_nodes_requested));
+          this_ptr->network_->SignAndSendToClosestNode(std::move(find_node_rpc));
+        },
+        [this_weak_ptr](const std::vector<NodeId>& closest_nodes) {
+          if (std::shared_ptr<Routing::Impl> this_ptr = this_weak_ptr.lock()) {
+            LOG(kInfo) << "[" << this_ptr->kNodeId_ << "] lookup finished with "
+                       << closest_nodes.size() << " responsive close nodes.  Routing table size : "
+                       << this_ptr->routing_table_->size();
+          }
+        });
+    node_lookup = node_lookup_;
   }
+  LOG(kVerbose) << "[" << kNodeId_ << "] starting lookup from " << seeds.size() << " nodes.";
+  node_lookup->Start(seeds);
 }
 
 void Routing::Impl::NotifyNetworkStatus(int return_code) const {
@@ -741,6 +1168,14 @@ int Routing::Impl::network_status() {
   return network_status_;
 }
 
+size_t Routing::Impl::callback_queue_depth() const {
+  return callback_executor_ ? callback_executor_->queue_depth() : 0;
+}
+
+uint64_t Routing::Impl::callback_queue_overflow_count() const {
+  return callback_executor_ ? callback_executor_->dropped_count() : 0;
+}
+
 std::vector<NodeInfo> Routing::Impl::ClosestNodes() {
   return routing_table_->GetClosestNodes(kNodeId(), Parameters::closest_nodes_size);
 }
@@ -776,22 +1211,44 @@ void Routing::Impl::OnRoutingTableChange(const RoutingTableChange& routing_table
   NotifyNetworkStatus(routing_table_change.health);
   LOG(kVerbose) << kNodeId_ << " Updating network status !!! " << routing_table_change.health;
 
+  if (routing_table_change.insertion)
+    RecordContacts(std::vector<NodeId>(1, routing_table_change.added_node.id));
+
+  bool recover(false);
   if (routing_table_change.removed.node.id != NodeId()) {
-    RemoveNode(routing_table_change.removed.node,
-               routing_table_change.removed.routing_only_removal);
+    recover = RemoveNode(routing_table_change.removed.node,
+                         routing_table_change.removed.routing_only_removal);
     LOG(kVerbose) << "Routing table removed node id : " << routing_table_change.removed.node.id
                   << ", connection id : " << routing_table_change.removed.node.connection_id;
   }
+  for (const auto& removed : routing_table_change.removed_nodes) {
+    recover = RemoveNode(removed.node, removed.routing_only_removal) || recover;
+    LOG(kVerbose) << "Routing table removed node id : " << removed.node.id
+                  << ", connection id : " << removed.node.connection_id;
+  }
+  if (recover) {
+    // Close node removed by routing, get more nodes
+    LOG(kWarning) << "[" << DebugId(kNodeId_)
+                  << "] Removed close node, sending find node to get more nodes.";
+    ScheduleRecovery();
+  }
+
+  if (Parameters::routing_table_save_interval != std::chrono::steady_clock::duration::zero())
+    ScheduleRoutingTableSave();
 
   if (routing_table_->client_mode()) {
-    if (routing_table_->size() < Parameters::max_routing_table_size_for_client)
-      network_->SendToClosestNode(rpcs::FindNodes(kNodeId_, kNodeId_,
-                                 Parameters::max_routing_table_size_for_client));
+    if (routing_table_->size() < routing_table_->kMaxSize()) {
+      protobuf::Message find_node_rpc(
+          rpcs::FindNodes(kNodeId_, kNodeId_, static_cast<int>(routing_table_->kMaxSize())));
+      network_->SignAndSendToClosestNode(std::move(find_node_rpc));
+    }
     return;
   }
 
   if (routing_table_change.close_nodes_change != nullptr) {
-    if (functors_.close_nodes_change)
+    if (close_nodes_change_coalescer_)
+      close_nodes_change_coalescer_->Add(routing_table_change.close_nodes_change);
+    else if (functors_.close_nodes_change)
       functors_.close_nodes_change(routing_table_change.close_nodes_change);
     network_utils_.statistics_.UpdateLocalAverageDistance(
         routing_table_change.close_nodes_change->new_close_nodes());
@@ -804,9 +1261,11 @@ void Routing::Impl::OnRoutingTableChange(const RoutingTableChange& routing_table
       InformClientOfNewCloseNode(*network_, client, routing_table_change.added_node, kNodeId());
   }
 
-  if (routing_table_->size() > Parameters::routing_table_size_threshold)
-    network_->SendToClosestNode(rpcs::FindNodes(kNodeId_, kNodeId_,
-                                               Parameters::max_routing_table_size));
+  if (routing_table_->size() > routing_table_->kThresholdSize()) {
+    protobuf::Message find_node_rpc(
+        rpcs::FindNodes(kNodeId_, kNodeId_, static_cast<int>(routing_table_->kMaxSize())));
+    network_->SignAndSendToClosestNode(std::move(find_node_rpc));
+  }
 }
 
 }  // namespace routing
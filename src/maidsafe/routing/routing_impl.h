@@ -19,12 +19,18 @@
 #ifndef MAIDSAFE_ROUTING_ROUTING_IMPL_H_
 #define MAIDSAFE_ROUTING_ROUTING_IMPL_H_
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include "boost/asio/steady_timer.hpp"
+#include "boost/asio/strand.hpp"
 #include "boost/asio/ip/udp.hpp"
 #include "boost/system/error_code.hpp"
 
@@ -34,9 +40,17 @@
 #include "maidsafe/common/rsa.h"
 
 #include "maidsafe/routing/api_config.h"
+#include "maidsafe/routing/bootstrap_contact_store.h"
+#include "maidsafe/routing/callback_executor.h"
 #include "maidsafe/routing/client_routing_table.h"
+#include "maidsafe/routing/close_nodes_change_coalescer.h"
+#include "maidsafe/routing/lifetime.h"
 #include "maidsafe/routing/message_handler.h"
+#include "maidsafe/routing/message_inbox.h"
+#include "maidsafe/routing/message_pool.h"
 #include "maidsafe/routing/network.h"
+#include "maidsafe/routing/node_lookup.h"
+#include "maidsafe/routing/pipeline_stage.h"
 #include "maidsafe/routing/random_node_helper.h"
 #include "maidsafe/routing/routing_api.h"
 #include "maidsafe/routing/routing.pb.h"
@@ -97,7 +111,9 @@ class GenericNode;
 
 class Routing::Impl : public std::enable_shared_from_this<Routing::Impl> {
  public:
-  Impl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys);
+  Impl(bool client_mode, const NodeId& node_id, const asymm::Keys& keys,
+       const RoutingOptions& options);
+  ~Impl();
 
   void Join(const Functors& functors);
 
@@ -133,6 +149,9 @@ class Routing::Impl : public std::enable_shared_from_this<Routing::Impl> {
   bool IsConnectedVault(const NodeId& node_id);
   bool IsConnectedClient(const NodeId& node_id);
 
+  size_t callback_queue_depth() const;
+  uint64_t callback_queue_overflow_count() const;
+
   friend class test::GenericNode;
 
  private:
@@ -140,7 +159,20 @@ class Routing::Impl : public std::enable_shared_from_this<Routing::Impl> {
   Impl(const Impl&&);
   Impl& operator=(const Impl&);
 
+  // A snapshot of a node's routing table waiting to be written to the bootstrap file.
+  struct RoutingTableSave {
+    NodeId owner_id;
+    bool client_mode;
+    RoutingTableContacts contacts;
+  };
+
+  // Returns null if Parameters::routing_table_save_interval is zero.  If 'shared', returns the
+  // writer shared by all Routing objects given a shared AsioService, so that a process running many
+  // of them doesn't start a thread for each.
+  static std::shared_ptr<PipelineStage<RoutingTableSave>> MakeRoutingTableWriter(bool shared);
   void ConnectFunctors(const Functors& functors);
+  // Returns a copy of functors whose (non-blocking) members run on callback_executor_.
+  Functors WrapFunctors(Functors functors) const;
   void BootstrapFromTheseEndpoints(const BootstrapContacts& bootstrap_contacts);
   void DoJoin();
   void Bootstrap();
@@ -148,17 +180,52 @@ class Routing::Impl : public std::enable_shared_from_this<Routing::Impl> {
   void ReBootstrap();
   void FindClosestNode(const boost::system::error_code& error_code, int attempts);
   void ReSendFindNodeRequest(const boost::system::error_code& error_code, bool ignore_size);
+  // Starts a NodeLookup for this node's own id, seeded from the routing table, unless one is
+  // already running.  Each node queried is asked for num_nodes_requested nodes.
+  void StartNodeLookup(int num_nodes_requested);
+  template <typename Handler>
+  void Post(Handler handler);
+  // Returns 'handler' wrapped so that it runs on strand_, for the completion handlers of this
+  // object's timers.
+  template <typename Handler>
+  std::function<void(const boost::system::error_code&)> Wrap(Handler handler);
   void OnMessageReceived(const std::string& message);
-  void DoOnMessageReceived(const std::string& message);
+  // Parses a batch of received messages from one message_inbox_ ring, on decode_stage_'s thread if
+  // there is one, then hands them to HandleMessages() on that ring's strand.  Without a
+  // decode_stage_, both run on the calling routing thread.
+  void DoOnMessagesReceived(std::vector<std::string>& messages);
+  std::vector<std::shared_ptr<protobuf::Message>> DecodeMessages(
+      const std::vector<std::string>& messages);
+  // Handles parsed messages in two passes on the calling routing thread: ClassifyMessages (source
+  // bookkeeping and acks), then routing by message_handler_.  Whatever is forwarded or replied is
+  // serialised and sent by the Network's transmit stage.
+  void HandleMessages(std::vector<std::shared_ptr<protobuf::Message>>& batch);
+  void ClassifyMessages(std::vector<std::shared_ptr<protobuf::Message>>& batch);
+  // Lost connections are collected for Parameters::connection_loss_batch_window, then handled
+  // together by DoOnConnectionsLost() so that a storm of losses updates the routing table once.
   void OnConnectionLost(const NodeId& lost_connection_id);
-  void DoOnConnectionLost(const NodeId& lost_connection_id);
+  void FlushLostConnections();
+  void DoOnConnectionsLost(const std::vector<NodeId>& lost_connection_ids);
   void OnRoutingTableChange(const RoutingTableChange& routing_table_change);
-  void RemoveNode(const NodeInfo& node, bool internal_rudp_only);
+  // Returns true if the removed node was a close one, in which case recovery should be scheduled.
+  bool RemoveNode(const NodeInfo& node, bool internal_rudp_only);
+  void ScheduleRecovery();
+  // Saves the routing table's members (see Parameters::routing_table_save_interval) once the save
+  // interval has passed, unless a save is already pending.
+  void ScheduleRoutingTableSave();
+  // Snapshots the routing table's members with their last contact times for routing_table_writer_
+  // to write.
+  void SaveRoutingTable();
+  // Records that each of 'node_ids' has been heard from just now.
+  void RecordContacts(const std::vector<NodeId>& node_ids);
+  // Starts connecting to the members of the routing table saved when this node last ran.
+  void ReconnectToSavedContacts();
   bool ConfirmGroupMembers(const NodeId& node1, const NodeId& node2);
   void NotifyNetworkStatus(int return_code) const;
   void Send(const NodeId& destination_id, const std::string& data,
             const DestinationType& destination_type, bool cacheable,
             ResponseFunctor response_functor);
+  // Hands the contents of 'proto_message' on to network_ rather than copying them.
   void SendMessage(const NodeId& destination_id, protobuf::Message& proto_message);
   void PartiallyJoinedSend(protobuf::Message& proto_message);
   protobuf::Message CreateNodeLevelPartialMessage(const NodeId& destination_id,
@@ -182,20 +249,63 @@ class Routing::Impl : public std::enable_shared_from_this<Routing::Impl> {
   int network_status_;
   std::unique_ptr<RoutingTable> routing_table_;
   const NodeId kNodeId_;
-  bool running_;
+  // Read without running_mutex_ by checks which only decide whether to carry on.  The mutex is held
+  // when it is cleared and by code which arms timers, so that Stop() can't interleave with those.
+  std::atomic<bool> running_;
   std::mutex running_mutex_;
+  std::mutex lost_connections_mutex_;
+  std::vector<NodeId> lost_connections_;
+  bool routing_table_save_pending_;  // Guarded by running_mutex_
+  // When each routing table member, or other recent message source, was last heard from.  Only kept
+  // if Parameters::routing_table_save_interval is non-zero, and pruned to the routing table's
+  // members on each save.
+  std::mutex last_contact_mutex_;
+  std::map<NodeId, std::chrono::system_clock::time_point> last_contact_;
+  std::mutex node_lookup_mutex_;
   Functors functors_;
   RandomNodeHelper random_node_helper_;
   ClientRoutingTable client_routing_table_;
+  MessagePool message_pool_;
+  MessageInbox message_inbox_;
+  // Runs message_inbox_'s drains, and so parses received messages, off routing's threads.  Null if
+  // the decode thread count (see RoutingOptions) is 0, in which case the drains are posted like
+  // other handlers.  Reset first in ~Impl().
+  std::unique_ptr<PipelineStage<std::function<void()>>> decode_stage_;
+  // Null if Parameters::callback_thread_count is 0.  Shared with other Routing objects if the
+  // AsioService is, in which case callback_queue_depth() etc. count all of their callbacks.
+  const std::shared_ptr<CallbackExecutor> callback_executor_;
+  // Every callback run by callback_executor_ goes through this, which is closed in ~Impl() before
+  // message_handler_ is destroyed so that no callback is still running when the objects it may
+  // call into are destroyed.
+  const std::shared_ptr<Lifetime> callback_lifetime_;
+  // If non-zero, close_nodes_change notifications are coalesced by close_nodes_change_coalescer_.
+  const std::chrono::steady_clock::duration kCloseNodesChangeQuietPeriod_;
   // The following variables' declarations should remain the last ones in this class and should stay
   // in the order: message_handler_, asio_service_, network_, all timers.  This is important for the
   // proper destruction of the routing library, i.e. to avoid segmentation faults.
   std::unique_ptr<MessageHandler> message_handler_;
-  AsioService asio_service_;
+  // Either owned by this object or shared with other Routing objects (see RoutingOptions).  In the
+  // shared case, strand_ keeps this object's events in order and the service is never stopped here.
+  const bool kSharedAsioService_;
+  std::shared_ptr<AsioService> asio_service_;
+  std::unique_ptr<boost::asio::io_service::strand> strand_;
+  // One per message_inbox_ ring if asio_service_ is owned, so that each ring's decoded batches are
+  // handled in order while different rings' are handled in parallel.  Empty for a shared service,
+  // whose single ring's batches are handled on strand_.
+  std::vector<std::unique_ptr<boost::asio::io_service::strand>> inbox_strands_;
   NetworkUtils network_utils_;
   std::unique_ptr<Network> network_;
   Timer<std::string> timer_;
-  boost::asio::steady_timer re_bootstrap_timer_, recovery_timer_, setup_timer_;
+  boost::asio::steady_timer re_bootstrap_timer_, recovery_timer_, setup_timer_,
+      connection_lost_timer_, routing_table_save_timer_;
+  // Shared with network_, which adds the bootstrap contacts it finds.  Flushed in Stop().
+  std::shared_ptr<BootstrapContactStore> bootstrap_contact_store_;
+  // Writes routing table snapshots to the bootstrap file, keeping the transaction off the routing
+  // threads.  Null if Parameters::routing_table_save_interval is zero.  Snapshots still queued are
+  // written when it's destroyed, which for a shared writer is when its last user is.
+  std::shared_ptr<PipelineStage<RoutingTableSave>> routing_table_writer_;
+  std::shared_ptr<CloseNodesChangeCoalescer> close_nodes_change_coalescer_;
+  std::shared_ptr<NodeLookup> node_lookup_;
 };
 
 template <>
@@ -205,6 +315,21 @@ template <>
 protobuf::Message Routing::Impl::CreateNodeLevelMessage(const GroupToSingleRelayMessage& message);
 
 // Implementations
+template <typename Handler>
+void Routing::Impl::Post(Handler handler) {
+  if (strand_)
+    strand_->post(handler);
+  else
+    asio_service_->service().post(handler);
+}
+
+template <typename Handler>
+std::function<void(const boost::system::error_code&)> Routing::Impl::Wrap(Handler handler) {
+  if (strand_)
+    return strand_->wrap(handler);
+  return handler;
+}
+
 template <typename T>
 void Routing::Impl::Send(const T& message) {  // FIXME(Fix caching)
   assert(!functors_.message_and_caching.message_received &&
@@ -22,6 +22,7 @@
 #include <bitset>
 #include <limits>
 #include <map>
+#include <set>
 #include <sstream>
 
 #include "maidsafe/common/log.h"
@@ -39,17 +40,26 @@ namespace maidsafe {
 namespace routing {
 
 RoutingTable::RoutingTable(bool client_mode, const NodeId& node_id, const asymm::Keys& keys)
+    : RoutingTable(client_mode, node_id, keys,
+                   client_mode ? Parameters::max_routing_table_size_for_client
+                               : Parameters::max_routing_table_size,
+                   client_mode ? Parameters::max_routing_table_size_for_client
+                               : Parameters::routing_table_size_threshold) {}
+
+RoutingTable::RoutingTable(bool client_mode, const NodeId& node_id, const asymm::Keys& keys,
+                           unsigned int max_size, unsigned int threshold_size)
     : kClientMode_(client_mode),
       kNodeId_(node_id),
       kConnectionId_(kClientMode_ ? NodeId(NodeId::IdType::kRandomId) : kNodeId_),
       kKeys_(keys),
-      kMaxSize_(kClientMode_ ? Parameters::max_routing_table_size_for_client
-                             : Parameters::max_routing_table_size),
-      kThresholdSize_(kClientMode_ ? Parameters::max_routing_table_size_for_client
-                                   : Parameters::routing_table_size_threshold),
+      kMaxSize_(max_size),
+      kThresholdSize_(threshold_size),
       mutex_(),
       routing_table_change_functor_(),
       nodes_(),
+      public_key_index_(),
+      key_fingerprints_(),
+      validated_public_keys_(Parameters::validated_public_key_cache_size),
       ipc_message_queue_() {
 #ifdef TESTING
   try {
@@ -90,7 +100,8 @@ bool RoutingTable::AddOrCheckNode(NodeInfo peer, bool remove) {
     LOG(kError) << "Attempt to add an invalid node " << peer.id;
     return false;
   }
-  if (remove && !asymm::ValidateKey(peer.public_key)) {
+  std::string key_fingerprint;
+  if (remove && !ValidatePublicKey(peer, key_fingerprint)) {
     LOG(kInfo) << "Invalid public key for node " << DebugId(peer.id);
     return false;
   }
@@ -111,10 +122,9 @@ bool RoutingTable::AddOrCheckNode(NodeInfo peer, bool remove) {
       return false;
     }
 
-    auto close_nodes_size(PartialSortFromTarget(kNodeId_, Parameters::max_routing_table_size,
-                                                lock));
+    auto close_nodes_size(PartialSortFromTarget(kNodeId_, kMaxSize_, lock));
 
-    if (MakeSpaceForNodeToBeAdded(peer, remove, removed_node, lock)) {
+    if (MakeSpaceForNodeToBeAdded(peer, key_fingerprint, remove, removed_node, lock)) {
       if (remove) {
         assert(peer.bucket != NodeInfo::kInvalidBucket);
         if (!client_mode() &&
@@ -135,6 +145,8 @@ bool RoutingTable::AddOrCheckNode(NodeInfo peer, bool remove) {
                                                         new_close_nodes));
         }
         nodes_.push_back(peer);
+        public_key_index_.insert(key_fingerprint);
+        key_fingerprints_.emplace(peer.id.string(), key_fingerprint);
       }
       return_value = true;
     }
@@ -180,6 +192,7 @@ NodeInfo RoutingTable::DropNode(const NodeId& node_to_drop, bool routing_only) {
         close_nodes_change.reset(new CloseNodesChange(kNodeId(), old_close_nodes, new_close_nodes));
       }
       dropped_node = *found.second;
+      EraseFromPublicKeyIndex(dropped_node, lock);
       nodes_.erase(found.second);
       routing_table_size = static_cast<unsigned int>(nodes_.size());
     }
@@ -196,6 +209,54 @@ NodeInfo RoutingTable::DropNode(const NodeId& node_to_drop, bool routing_only) {
   return dropped_node;
 }
 
+std::vector<NodeInfo> RoutingTable::DropNodes(const std::vector<NodeId>& nodes_to_drop,
+                                              bool routing_only) {
+  std::vector<NodeInfo> dropped_nodes;
+  unsigned int routing_table_size(0);
+  std::shared_ptr<CloseNodesChange> close_nodes_change;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    std::vector<NodeId> old_close_nodes, new_close_nodes;
+    auto close_nodes_size(PartialSortFromTarget(kNodeId_, Parameters::closest_nodes_size, lock));
+    for (unsigned int i(0); i != close_nodes_size; ++i)
+      old_close_nodes.push_back(nodes_.at(i).id);
+
+    const std::set<NodeId> kToDrop(std::begin(nodes_to_drop), std::end(nodes_to_drop));
+    auto itr(std::begin(nodes_));
+    while (itr != std::end(nodes_)) {
+      if (kToDrop.count(itr->id) == 0) {
+        ++itr;
+        continue;
+      }
+      dropped_nodes.push_back(*itr);
+      EraseFromPublicKeyIndex(*itr, lock);
+      itr = nodes_.erase(itr);
+    }
+
+    if (!dropped_nodes.empty() && !client_mode()) {
+      close_nodes_size = PartialSortFromTarget(kNodeId_, Parameters::closest_nodes_size, lock);
+      for (unsigned int i(0); i != close_nodes_size; ++i)
+        new_close_nodes.push_back(nodes_.at(i).id);
+      if (new_close_nodes != old_close_nodes) {
+        close_nodes_change.reset(
+            new CloseNodesChange(kNodeId(), old_close_nodes, new_close_nodes));
+      }
+    }
+    routing_table_size = static_cast<unsigned int>(nodes_.size());
+  }
+
+  if (!dropped_nodes.empty() && routing_table_change_functor_) {
+    RoutingTableChange routing_table_change(NodeInfo(), RoutingTableChange::Remove(), false,
+                                            close_nodes_change,
+                                            NetworkStatus(routing_table_size));
+    for (auto& dropped_node : dropped_nodes)
+      routing_table_change.removed_nodes.emplace_back(dropped_node, routing_only);
+    routing_table_change_functor_(routing_table_change);
+  }
+  LOG(kInfo) << PrintRoutingTable();
+  return dropped_nodes;
+}
+
 NodeId RoutingTable::RandomConnectedNode() {
   std::unique_lock<std::mutex> lock(mutex_);
 // Commenting out assert as peer starts treating this node as joined as soon as it adds
@@ -259,6 +320,17 @@ bool RoutingTable::Contains(const NodeId& node_id) const {
   return Find(node_id, lock).first;
 }
 
+size_t RoutingTable::NodesInBucketOf(const NodeId& node_id) const {
+  NodeInfo node_info;
+  node_info.id = node_id;
+  SetBucketIndex(node_info);
+  std::lock_guard<std::mutex> lock(mutex_);
+  return static_cast<size_t>(std::count_if(std::begin(nodes_), std::end(nodes_),
+                                           [&node_info](const NodeInfo& held) {
+                                             return held.bucket == node_info.bucket;
+                                           }));
+}
+
 bool RoutingTable::ConfirmGroupMembers(const NodeId& node1, const NodeId& node2) {
   NodeId difference =
       kNodeId_ ^ GetNthClosestNode(
@@ -291,14 +363,31 @@ void RoutingTable::SetBucketIndex(NodeInfo& node_info) const {
   node_info.bucket = 0;
 }
 
-bool RoutingTable::CheckPublicKeyIsUnique(const NodeInfo& node,
+bool RoutingTable::ValidatePublicKey(const NodeInfo& peer, std::string& key_fingerprint) {
+  if (!peer.shared_public_key())
+    return false;
+  try {
+    key_fingerprint = PublicKeyFingerprint(*peer.shared_public_key());
+  }
+  catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to encode public key for node " << DebugId(peer.id) << ": "
+                  << e.what();
+    return false;
+  }
+  if (validated_public_keys_.Contains(key_fingerprint))
+    return true;
+  if (!asymm::ValidateKey(*peer.shared_public_key()))
+    return false;
+  validated_public_keys_.Insert(key_fingerprint);
+  return true;
+}
+
+bool RoutingTable::CheckPublicKeyIsUnique(const std::string& key_fingerprint,
                                           std::unique_lock<std::mutex>& lock) const {
   assert(lock.owns_lock());
   static_cast<void>(lock);
   // If we already have a duplicate public key return false
-  if (std::find_if(nodes_.begin(), nodes_.end(), [node](const NodeInfo & node_info) {
-        return asymm::MatchingKeys(node_info.public_key, node.public_key);
-      }) != nodes_.end()) {
+  if (public_key_index_.count(key_fingerprint) != 0) {
     LOG(kInfo) << "Already have node with this public key";
     return false;
   }
@@ -319,14 +408,27 @@ bool RoutingTable::CheckPublicKeyIsUnique(const NodeInfo& node,
   return true;
 }
 
-bool RoutingTable::MakeSpaceForNodeToBeAdded(const NodeInfo& node, bool remove,
+void RoutingTable::EraseFromPublicKeyIndex(const NodeInfo& node,
+                                           std::unique_lock<std::mutex>& lock) {
+  assert(lock.owns_lock());
+  static_cast<void>(lock);
+  auto itr(key_fingerprints_.find(node.id.string()));
+  assert(itr != std::end(key_fingerprints_));
+  if (itr == std::end(key_fingerprints_))
+    return;
+  public_key_index_.erase(itr->second);
+  key_fingerprints_.erase(itr);
+}
+
+bool RoutingTable::MakeSpaceForNodeToBeAdded(const NodeInfo& node,
+                                             const std::string& key_fingerprint, bool remove,
                                              NodeInfo& removed_node,
                                              std::unique_lock<std::mutex>& lock) {
   assert(lock.owns_lock());
 
   std::map<uint32_t, unsigned int> bucket_rank_map;
 
-  if (remove && !CheckPublicKeyIsUnique(node, lock))
+  if (remove && !CheckPublicKeyIsUnique(key_fingerprint, lock))
     return false;
 
   if (nodes_.size() < kMaxSize_)
@@ -336,6 +438,7 @@ bool RoutingTable::MakeSpaceForNodeToBeAdded(const NodeInfo& node, bool remove,
     assert(nodes_.size() == kMaxSize_);
     if (NodeId::CloserToTarget(node.id, nodes_.at(kMaxSize_ - 1).id, kNodeId())) {
       removed_node = *nodes_.rbegin();
+      EraseFromPublicKeyIndex(removed_node, lock);
       nodes_.pop_back();
       return true;
     } else {
@@ -374,6 +477,7 @@ bool RoutingTable::MakeSpaceForNodeToBeAdded(const NodeInfo& node, bool remove,
       if ((it->bucket != node.bucket) || NodeId::CloserToTarget(node.id, it->id, kNodeId())) {
         if (remove) {
           removed_node = *it;
+          EraseFromPublicKeyIndex(removed_node, lock);
           nodes_.erase(--(it.base()));
           LOG(kVerbose) << kNodeId_ << " Proposed removable " << removed_node.id;
         }
@@ -426,30 +530,38 @@ NodeInfo RoutingTable::GetClosestNode(const NodeId& target_id, bool ignore_exact
   return NodeInfo();
 }
 
+bool RoutingTable::GetClosestNode(const NodeId& target_id, bool ignore_exact_match,
+                                  const NodeIdExclusion& exclude, NodeInfo& closest_node) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto range(ClosestRange(target_id, Parameters::closest_nodes_size, ignore_exact_match, lock));
+  for (auto index(range.first); index != range.second; ++index) {
+    if (std::find(exclude.begin(), exclude.end(), nodes_[index].id) == exclude.end()) {
+      closest_node = nodes_[index];
+      return true;
+    }
+  }
+  return false;
+}
+
 std::vector<NodeInfo> RoutingTable::GetClosestNodes(
     const NodeId& target_id, unsigned int number_to_get, bool ignore_exact_match) {
   std::unique_lock<std::mutex> lock(mutex_);
-  if (number_to_get == 0)
-    return std::vector<NodeInfo>();
+  auto range(ClosestRange(target_id, number_to_get, ignore_exact_match, lock));
+  return std::vector<NodeInfo>(std::begin(nodes_) + range.first, std::begin(nodes_) + range.second);
+}
 
-  int sorted_count(PartialSortFromTarget(target_id, number_to_get + 1, lock));
+std::pair<size_t, size_t> RoutingTable::ClosestRange(const NodeId& target_id, unsigned int number,
+                                                     bool ignore_exact_match,
+                                                     std::unique_lock<std::mutex>& lock) {
+  if (number == 0)
+    return std::make_pair(0, 0);
+
+  size_t sorted_count(PartialSortFromTarget(target_id, number + 1, lock));
   if (sorted_count == 0)
-    return std::vector<NodeInfo>();
-
-  if (sorted_count == 1) {
-    if (ignore_exact_match)
-      return (nodes_.begin()->id == target_id)
-                  ? std::vector<NodeInfo>()
-                  : std::vector<NodeInfo>(std::begin(nodes_), std::end(nodes_));
-    else
-      return std::vector<NodeInfo>(std::begin(nodes_), std::end(nodes_));
-  }
+    return std::make_pair(0, 0);
 
-  unsigned int index(ignore_exact_match && nodes_.begin()->id == target_id);
-  return std::vector<NodeInfo>(std::begin(nodes_) + index,
-                               std::begin(nodes_) +
-                                   std::min(nodes_.size(),
-                                            static_cast<size_t>(number_to_get + index)));
+  size_t index(ignore_exact_match && nodes_.begin()->id == target_id);
+  return std::make_pair(index, std::min(sorted_count, static_cast<size_t>(number) + index));
 }
 
 NodeInfo RoutingTable::GetNthClosestNode(const NodeId& target_id, unsigned int index) {
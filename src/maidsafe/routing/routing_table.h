@@ -23,6 +23,8 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 #include <vector>
 
@@ -36,6 +38,8 @@
 #include "maidsafe/passport/types.h"
 
 #include "maidsafe/routing/api_config.h"
+#include "maidsafe/routing/bounded_key_set.h"
+#include "maidsafe/routing/fixed_capacity_buffer.h"
 #include "maidsafe/routing/parameters.h"
 #include "maidsafe/routing/utils.h"
 
@@ -67,15 +71,17 @@ struct RoutingTableChange {
     NodeInfo node;
     bool routing_only_removal;
   };
-  RoutingTableChange() : added_node(), removed(), insertion(false), close_nodes_change(),
-                         health(0) {}
+  RoutingTableChange() : added_node(), removed(), removed_nodes(), insertion(false),
+                         close_nodes_change(), health(0) {}
   RoutingTableChange(const NodeInfo& added_node_in, const Remove& removed_in,
                      bool insertion_in, std::shared_ptr<CloseNodesChange> close_nodes_change_in,
                      unsigned int health_in)
-      : added_node(added_node_in), removed(removed_in), insertion(insertion_in),
+      : added_node(added_node_in), removed(removed_in), removed_nodes(), insertion(insertion_in),
         close_nodes_change(close_nodes_change_in), health(health_in) {}
   NodeInfo added_node;
   Remove removed;
+  // Set (rather than removed) by DropNodes, with close_nodes_change covering all of them.
+  std::vector<Remove> removed_nodes;
   bool insertion;
   std::shared_ptr<CloseNodesChange> close_nodes_change;
   unsigned int health;
@@ -87,15 +93,23 @@ typedef std::function<void(const RoutingTableChange& /*routing_table_change*/)>
 class RoutingTable {
  public:
   RoutingTable(bool client_mode, const NodeId& node_id, const asymm::Keys& keys);
+  // Allows the sizes normally taken from Parameters to be overridden for this table only.
+  RoutingTable(bool client_mode, const NodeId& node_id, const asymm::Keys& keys,
+               unsigned int max_size, unsigned int threshold_size);
   virtual ~RoutingTable();
   void InitialiseFunctors(RoutingTableChangeFunctor routing_table_change_functor);
   bool AddNode(const NodeInfo& peer);
   bool CheckNode(const NodeInfo& peer);
   NodeInfo DropNode(const NodeId& node_to_drop, bool routing_only);
+  // Drops all of nodes_to_drop which are held, sorting the table and reporting the change once for
+  // the lot rather than once per node.  Returns the dropped nodes.
+  std::vector<NodeInfo> DropNodes(const std::vector<NodeId>& nodes_to_drop, bool routing_only);
 
   bool IsThisNodeInRange(const NodeId& target_id, unsigned int range);
   bool IsThisNodeClosestTo(const NodeId& target_id, bool ignore_exact_match = false);
   bool Contains(const NodeId& node_id) const;
+  // Returns the number of held nodes which share node_id's bucket.
+  size_t NodesInBucketOf(const NodeId& node_id) const;
   bool ConfirmGroupMembers(const NodeId& node1, const NodeId& node2);
 
   bool GetNodeInfo(const NodeId& node_id, NodeInfo& node_info) const;
@@ -103,8 +117,17 @@ class RoutingTable {
   NodeInfo GetClosestNode(const NodeId& target_id,
                           bool ignore_exact_match = false,
                           const std::vector<std::string>& exclude = std::vector<std::string>());
+  // As above, but skipping the nodes in exclude and writing the result to closest_node.  Returns
+  // false, leaving closest_node unchanged, if there is no such node.
+  bool GetClosestNode(const NodeId& target_id, bool ignore_exact_match,
+                      const NodeIdExclusion& exclude, NodeInfo& closest_node);
   std::vector<NodeInfo> GetClosestNodes(const NodeId& target_id, unsigned int number_to_get,
                                         bool ignore_exact_match = false);
+  // As above, but filling a caller-supplied buffer (cleared first) rather than a new vector.  At
+  // most Capacity nodes are returned.
+  template <std::size_t Capacity>
+  void GetClosestNodes(const NodeId& target_id, unsigned int number_to_get,
+                       bool ignore_exact_match, FixedCapacityBuffer<NodeInfo, Capacity>& closest);
   NodeInfo GetNthClosestNode(const NodeId& target_id, unsigned int index);
   NodeId RandomConnectedNode();
 
@@ -130,7 +153,11 @@ class RoutingTable {
   RoutingTable& operator=(const RoutingTable&);
   bool AddOrCheckNode(NodeInfo node, bool remove);
   void SetBucketIndex(NodeInfo& node_info) const;
-  bool CheckPublicKeyIsUnique(const NodeInfo& node, std::unique_lock<std::mutex>& lock) const;
+  // Validates the peer's public key, unless its fingerprint shows it was validated recently.
+  bool ValidatePublicKey(const NodeInfo& peer, std::string& key_fingerprint);
+  bool CheckPublicKeyIsUnique(const std::string& key_fingerprint,
+                              std::unique_lock<std::mutex>& lock) const;
+  void EraseFromPublicKeyIndex(const NodeInfo& node, std::unique_lock<std::mutex>& lock);
 
   /** Attempts to find or allocate memory for an incomming connect request, returning true
    * indicates approval
@@ -144,11 +171,16 @@ class RoutingTable {
    * - in case more than one bucket have similar maximum bucket size, the furthest node in higher
    *    bucket will be evicted
    * - remove the selected node and return true **/
-  bool MakeSpaceForNodeToBeAdded(const NodeInfo& node, bool remove, NodeInfo& removed_node,
+  bool MakeSpaceForNodeToBeAdded(const NodeInfo& node, const std::string& key_fingerprint,
+                                 bool remove, NodeInfo& removed_node,
                                  std::unique_lock<std::mutex>& lock);
 
   unsigned int PartialSortFromTarget(const NodeId& target, unsigned int number,
                                      std::unique_lock<std::mutex>& lock);
+  // Sorts nodes_ and returns the index range of the number closest to target.
+  std::pair<size_t, size_t> ClosestRange(const NodeId& target_id, unsigned int number,
+                                         bool ignore_exact_match,
+                                         std::unique_lock<std::mutex>& lock);
   void NthElementSortFromTarget(const NodeId& target, unsigned int nth_element,
                                 std::unique_lock<std::mutex>& lock);
   std::pair<bool, std::vector<NodeInfo>::iterator> Find(const NodeId& node_id,
@@ -170,9 +202,25 @@ class RoutingTable {
   mutable std::mutex mutex_;
   RoutingTableChangeFunctor routing_table_change_functor_;
   std::vector<NodeInfo> nodes_;
+  // Fingerprints (see PublicKeyFingerprint) of the public keys of all nodes_, and each node's
+  // fingerprint keyed by its NodeId::string(), so that removal needn't re-encode the key.
+  std::unordered_set<std::string> public_key_index_;
+  std::unordered_map<std::string, std::string> key_fingerprints_;
+  BoundedKeySet validated_public_keys_;
   std::unique_ptr<boost::interprocess::message_queue> ipc_message_queue_;
 };
 
+template <std::size_t Capacity>
+void RoutingTable::GetClosestNodes(const NodeId& target_id, unsigned int number_to_get,
+                                   bool ignore_exact_match,
+                                   FixedCapacityBuffer<NodeInfo, Capacity>& closest) {
+  closest.clear();
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto range(ClosestRange(target_id, number_to_get, ignore_exact_match, lock));
+  for (auto index(range.first); index != range.second && !closest.full(); ++index)
+    closest.push_back(nodes_[index]);
+}
+
 }  // namespace routing
 
 }  // namespace maidsafe
@@ -141,6 +141,37 @@ protobuf::Message FindNodes(const NodeId& node_id, const NodeId& this_node_id,
   return message;
 }
 
+protobuf::Message FindNodesFromPeer(const NodeId& peer_id, const NodeId& target_id,
+                                    const NodeId& this_node_id, int num_nodes_requested) {
+  assert(!peer_id.IsZero() && "Invalid peer_id");
+  assert(!target_id.IsZero() && "Invalid target_id");
+  assert(!this_node_id.IsZero() && "Invalid my node_id");
+  protobuf::Message message;
+  protobuf::FindNodesRequest find_nodes;
+  find_nodes.set_num_nodes_requested(num_nodes_requested);
+  find_nodes.set_target_id(target_id.string());
+#ifdef TESTING
+  find_nodes.set_timestamp(GetTimeStamp());
+#endif
+  message.set_last_id(this_node_id.string());
+  message.set_destination_id(peer_id.string());
+  message.set_source_id(this_node_id.string());
+  message.set_routing_message(true);
+  message.add_data(find_nodes.SerializeAsString());
+  message.set_direct(true);
+  message.set_replication(1);
+  message.set_type(static_cast<int32_t>(MessageType::kFindNodes));
+  message.set_request(true);
+  message.add_route_history(this_node_id.string());
+  message.set_client_node(false);
+  message.set_visited(false);
+  message.set_id(RandomInt32());
+  message.set_hops_to_live(Parameters::hops_to_live);
+  message.set_ack_id(RandomInt32());
+  assert(message.IsInitialized() && "Unintialised message");
+  return message;
+}
+
 protobuf::Message ConnectSuccess(const NodeId& node_id, const NodeId& this_node_id,
                                  const NodeId& this_connection_id, bool requestor,
                                  bool client_node) {
@@ -56,6 +56,11 @@ protobuf::Message FindNodes(const NodeId& node_id, const NodeId& this_node_id,
                             int num_nodes_requested, bool relay_message = false,
                             NodeId relay_connection_id = NodeId());
 
+// Asks peer_id itself (rather than the node closest to target_id) for its closest nodes to
+// target_id.  Used by NodeLookup.
+protobuf::Message FindNodesFromPeer(const NodeId& peer_id, const NodeId& target_id,
+                                    const NodeId& this_node_id, int num_nodes_requested);
+
 protobuf::Message ProxyConnect(const NodeId& node_id, const NodeId& this_node_id,
                                const rudp::EndpointPair& endpoint_pair, bool relay_message = false,
                                NodeId relay_connection_id = NodeId());
@@ -261,18 +261,20 @@ void Service::FindNodes(protobuf::Message& message) {
     message.Clear();
     return;
   }
-  if (0 == find_nodes.num_nodes_requested() || NodeId(message.destination_id()).IsZero()) {
+  const NodeId kTarget(find_nodes.has_target_id() ? find_nodes.target_id()
+                                                  : message.destination_id());
+  if (0 == find_nodes.num_nodes_requested() || kTarget.IsZero()) {
     LOG(kWarning) << "Invalid find node request.";
     message.Clear();
     return;
   }
 
   LOG(kVerbose) << "[" << routing_table_.kNodeId() << "] parsed find node request for target id : "
-                << HexSubstr(message.destination_id());
+                << HexSubstr(kTarget.string());
   protobuf::FindNodesResponse found_nodes;
+  // However many a remote peer asks for, the answer is never more than this node's routing table.
   auto nodes(routing_table_.GetClosestNodes(
-                 NodeId(message.destination_id()),
-                 static_cast<unsigned int>(find_nodes.num_nodes_requested() - 1)));
+      kTarget, std::min(find_nodes.num_nodes_requested() - 1, routing_table_.kMaxSize())));
   found_nodes.add_nodes(routing_table_.kNodeId().string());
 
   for (const auto& node : nodes) {
@@ -338,7 +340,7 @@ void Service::HandleConnectSuccess(NodeInfo& peer, bool client) {
   }
   if (client) {
     if (!ValidateAndAddToRoutingTable(network_, routing_table_, client_routing_table_, peer.id,
-                                      peer.connection_id, asymm::PublicKey(), true)) {
+                                      peer.connection_id, nullptr, true)) {
       LOG(kVerbose) << "Failed to add to routing table";
       return;
     }
@@ -349,7 +351,7 @@ void Service::HandleConnectSuccess(NodeInfo& peer, bool client) {
       return;
     }
     if (!ValidateAndAddToRoutingTable(network_, routing_table_, client_routing_table_, peer.id,
-                                      peer.connection_id, *peer_public_key, false)) {
+                                      peer.connection_id, peer_public_key, false)) {
       LOG(kVerbose) << "Failed to add to routing table";
       return;
     } else {
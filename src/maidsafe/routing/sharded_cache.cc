@@ -0,0 +1,113 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/sharded_cache.h"
+
+#include <algorithm>
+#include <cassert>
+#include <functional>
+
+namespace maidsafe {
+
+namespace routing {
+
+ShardedCache::ShardedCache(size_t max_entries, size_t max_bytes, unsigned int shard_count)
+    : kMaxEntriesPerShard_(std::max<size_t>(1, (max_entries + shard_count - 1) / shard_count)),
+      kMaxBytesPerShard_((max_bytes + shard_count - 1) / shard_count),
+      shards_() {
+  assert(shard_count != 0);
+  for (unsigned int i(0); i != shard_count; ++i)
+    shards_.emplace_back(new Shard);
+}
+
+bool ShardedCache::Get(const std::string& key, std::string& value) {
+  Shard& shard(ShardFor(key));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto itr(shard.index.find(key));
+  if (itr == shard.index.end()) {
+    ++shard.misses;
+    return false;
+  }
+  ++shard.hits;
+  shard.entries.splice(shard.entries.begin(), shard.entries, itr->second);
+  value = itr->second->second;
+  return true;
+}
+
+bool ShardedCache::Put(const std::string& key, const std::string& value, AdmissionFunctor admit) {
+  const size_t kEntrySize(key.size() + value.size());
+  if (kEntrySize > kMaxBytesPerShard_)
+    return false;
+
+  Shard& shard(ShardFor(key));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  auto itr(shard.index.find(key));
+  if (itr != shard.index.end()) {
+    shard.bytes -= itr->second->first.size() + itr->second->second.size();
+    shard.entries.erase(itr->second);
+    shard.index.erase(itr);
+  } else if (admit && !shard.entries.empty() && IsFull(shard, kEntrySize) &&
+             !admit(key, shard.entries.back().first)) {
+    ++shard.rejections;
+    return false;
+  }
+  while (!shard.entries.empty() && IsFull(shard, kEntrySize)) {
+    const auto& oldest(shard.entries.back());
+    shard.bytes -= oldest.first.size() + oldest.second.size();
+    shard.index.erase(oldest.first);
+    shard.entries.pop_back();
+    ++shard.evictions;
+  }
+  shard.entries.emplace_front(key, value);
+  shard.index.insert(std::make_pair(key, shard.entries.begin()));
+  shard.bytes += kEntrySize;
+  return true;
+}
+
+bool ShardedCache::Contains(const std::string& key) const {
+  Shard& shard(ShardFor(key));
+  std::lock_guard<std::mutex> lock(shard.mutex);
+  return shard.index.count(key) != 0;
+}
+
+ShardedCache::Statistics ShardedCache::statistics() const {
+  Statistics statistics;
+  for (const auto& shard : shards_) {
+    std::lock_guard<std::mutex> lock(shard->mutex);
+    statistics.hits += shard->hits;
+    statistics.misses += shard->misses;
+    statistics.evictions += shard->evictions;
+    statistics.rejections += shard->rejections;
+    statistics.entries += shard->entries.size();
+    statistics.bytes += shard->bytes;
+  }
+  return statistics;
+}
+
+bool ShardedCache::IsFull(const Shard& shard, size_t entry_size) const {
+  return shard.entries.size() >= kMaxEntriesPerShard_ ||
+         shard.bytes + entry_size > kMaxBytesPerShard_;
+}
+
+ShardedCache::Shard& ShardedCache::ShardFor(const std::string& key) const {
+  return *shards_[std::hash<std::string>()(key) % shards_.size()];
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
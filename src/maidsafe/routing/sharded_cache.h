@@ -0,0 +1,92 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SHARDED_CACHE_H_
+#define MAIDSAFE_ROUTING_SHARDED_CACHE_H_
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace maidsafe {
+
+namespace routing {
+
+// An in-memory key/value cache bounded both in number of entries and in bytes (keys plus values),
+// evicting least-recently-used entries first.  Keys are spread over independently locked shards by
+// hash, so concurrent lookups of different keys rarely contend.  Each shard holds an equal part of
+// the overall limits; a value too large for a shard is never cached.
+class ShardedCache {
+ public:
+  struct Statistics {
+    Statistics() : hits(0), misses(0), evictions(0), rejections(0), entries(0), bytes(0) {}
+    uint64_t hits, misses, evictions, rejections;
+    size_t entries, bytes;
+  };
+
+  // Decides whether a new entry may replace the least-recently-used one when there isn't room for
+  // both.
+  typedef std::function<bool(const std::string& /*candidate_key*/,
+                             const std::string& /*victim_key*/)> AdmissionFunctor;
+
+  ShardedCache(size_t max_entries, size_t max_bytes, unsigned int shard_count);
+  ShardedCache(const ShardedCache&) = delete;
+  ShardedCache(const ShardedCache&&) = delete;
+  ShardedCache& operator=(const ShardedCache&) = delete;
+  ShardedCache& operator=(const ShardedCache&&) = delete;
+
+  // Returns true and sets 'value' if 'key' is cached.
+  bool Get(const std::string& key, std::string& value);
+  // Adds or replaces the value for 'key'.  Returns false if the entry is too large to be cached, or
+  // if making room for it would evict an entry and 'admit' rejects it.
+  bool Put(const std::string& key, const std::string& value,
+           AdmissionFunctor admit = AdmissionFunctor());
+  bool Contains(const std::string& key) const;
+  Statistics statistics() const;
+
+ private:
+  typedef std::list<std::pair<std::string, std::string>> Entries;  // most recently used first
+
+  struct Shard {
+    Shard()
+        : mutex(), entries(), index(), bytes(0), hits(0), misses(0), evictions(0), rejections(0) {}
+    mutable std::mutex mutex;
+    Entries entries;
+    std::unordered_map<std::string, Entries::iterator> index;
+    size_t bytes;
+    uint64_t hits, misses, evictions, rejections;
+  };
+
+  Shard& ShardFor(const std::string& key) const;
+  bool IsFull(const Shard& shard, size_t entry_size) const;
+
+  const size_t kMaxEntriesPerShard_, kMaxBytesPerShard_;
+  std::vector<std::unique_ptr<Shard>> shards_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SHARDED_CACHE_H_
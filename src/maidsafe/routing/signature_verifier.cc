@@ -0,0 +1,168 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_verifier.h"
+
+#include <algorithm>
+
+#include "maidsafe/common/crypto.h"
+#include "maidsafe/common/log.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+SignatureVerifier::SignatureVerifier(unsigned int thread_count, size_t cache_size)
+    : verified_(cache_size),
+      mutex_(),
+      condition_(),
+      streams_(),
+      queue_(),
+      delivering_(0),
+      stopped_(false),
+      statistics_(),
+      workers_() {
+  for (unsigned int i(0); i < std::max(thread_count, 1U); ++i)
+    workers_.emplace_back([this] { Run(); });
+}
+
+SignatureVerifier::~SignatureVerifier() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopped_ = true;
+  }
+  condition_.notify_all();
+  for (auto& worker : workers_)
+    worker.join();
+  // A submitting thread may still be delivering results.
+  std::unique_lock<std::mutex> lock(mutex_);
+  condition_.wait(lock, [this] { return delivering_ == 0; });
+}
+
+void SignatureVerifier::Verify(Check check, ResultFunctor result) {
+  Batch batch;
+  batch.emplace_back(std::move(check), std::move(result));
+  Verify(std::move(batch));
+}
+
+void SignatureVerifier::Verify(Batch batch) {
+  std::vector<std::shared_ptr<Job>> jobs;
+  jobs.reserve(batch.size());
+  for (auto& entry : batch) {
+    // The digest (and so the cache lookup) is computed here rather than on the workers, so that a
+    // cached or trivial check needn't wait for a worker.
+    std::string cache_key(entry.first.public_key ? CacheKey(entry.first) : std::string());
+    auto job(std::make_shared<Job>(std::move(entry.first), std::move(entry.second),
+                                   std::move(cache_key)));
+    if (!job->check.public_key)
+      job->state = State::kValid;
+    else if (verified_.Contains(job->cache_key))
+      job->state = State::kValid;
+    jobs.push_back(job);
+  }
+
+  bool queued(false);
+  std::vector<std::string> order_keys;
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (auto& job : jobs) {
+    if (job->state == State::kPending) {
+      queue_.push_back(job);
+      queued = true;
+    } else if (job->check.public_key) {
+      ++statistics_.cache_hits;
+    }
+    auto& stream(streams_[job->check.order_key]);
+    if (stream.jobs.empty())
+      order_keys.push_back(job->check.order_key);
+    stream.jobs.push_back(job);
+  }
+  if (queued)
+    condition_.notify_all();
+  for (const auto& order_key : order_keys)
+    Deliver(order_key, lock);
+}
+
+SignatureVerifier::Statistics SignatureVerifier::statistics() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return statistics_;
+}
+
+std::string SignatureVerifier::CacheKey(const Check& check) {
+  return check.signer_id +
+         crypto::Hash<crypto::SHA512>(check.data + check.signature).string();
+}
+
+void SignatureVerifier::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  for (;;) {
+    condition_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+    if (stopped_)
+      return;
+    auto job(queue_.front());
+    queue_.pop_front();
+    lock.unlock();
+
+    bool valid(false);
+    try {
+      valid = asymm::CheckSignature(asymm::PlainText(job->check.data),
+                                    asymm::Signature(job->check.signature),
+                                    *job->check.public_key);
+    }
+    catch (const std::exception& e) {
+      LOG(kWarning) << "Failed to check signature: " << e.what();
+    }
+    if (valid)
+      verified_.Insert(job->cache_key);
+
+    lock.lock();
+    job->state = valid ? State::kValid : State::kInvalid;
+    if (valid)
+      ++statistics_.verified;
+    else
+      ++statistics_.failures;
+    Deliver(job->check.order_key, lock);
+  }
+}
+
+void SignatureVerifier::Deliver(const std::string& order_key,
+                                std::unique_lock<std::mutex>& lock) {
+  assert(lock.owns_lock());
+  auto itr(streams_.find(order_key));
+  if (itr == std::end(streams_) || itr->second.delivering)
+    return;
+  // Only the delivering thread erases a stream, so 'stream' stays valid while the lock is released.
+  auto& stream(itr->second);
+  stream.delivering = true;
+  ++delivering_;
+  while (!stopped_ && !stream.jobs.empty() && stream.jobs.front()->state != State::kPending) {
+    auto job(stream.jobs.front());
+    stream.jobs.pop_front();
+    lock.unlock();
+    job->result(job->state == State::kValid);
+    lock.lock();
+  }
+  stream.delivering = false;
+  if (stream.jobs.empty())
+    streams_.erase(order_key);
+  if (--delivering_ == 0 && stopped_)
+    condition_.notify_all();
+}
+
+}  // namespace routing
+
+}  // namespace maidsafe
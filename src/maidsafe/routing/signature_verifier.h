@@ -0,0 +1,122 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#ifndef MAIDSAFE_ROUTING_SIGNATURE_VERIFIER_H_
+#define MAIDSAFE_ROUTING_SIGNATURE_VERIFIER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "maidsafe/common/rsa.h"
+
+#include "maidsafe/routing/bounded_key_set.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+// Checks RSA signatures on a pool of dedicated worker threads.  Results of checks sharing an
+// order_key are delivered in the order the checks were submitted, regardless of the order in which
+// the workers finish them, so callers can use this as an ordered stage in a message pipeline (e.g.
+// keyed by message source).  Checks with different keys are delivered independently.  A check with
+// no public key always passes; it is still delivered in order behind any earlier checks with its
+// key.  Recently verified (signer, digest) pairs are remembered so that a repeated signature isn't
+// checked again.
+class SignatureVerifier {
+ public:
+  struct Check {
+    Check() : order_key(), signer_id(), public_key(), data(), signature() {}
+    std::string order_key;
+    std::string signer_id;
+    std::shared_ptr<const asymm::PublicKey> public_key;
+    std::string data, signature;
+  };
+  typedef std::function<void(bool /*valid*/)> ResultFunctor;
+  typedef std::vector<std::pair<Check, ResultFunctor>> Batch;
+
+  struct Statistics {
+    Statistics() : verified(0), cache_hits(0), failures(0) {}
+    uint64_t verified, cache_hits, failures;
+  };
+
+  SignatureVerifier(unsigned int thread_count, size_t cache_size);
+  SignatureVerifier(const SignatureVerifier&) = delete;
+  SignatureVerifier(const SignatureVerifier&&) = delete;
+  SignatureVerifier& operator=(const SignatureVerifier&) = delete;
+  SignatureVerifier& operator=(const SignatureVerifier&&) = delete;
+  // Stops the workers and waits for any result being delivered.  Results not yet delivered are
+  // dropped.
+  ~SignatureVerifier();
+
+  // Result functors are invoked on whichever thread completes the oldest outstanding check with
+  // their order_key, which may be the submitting thread.  They are never invoked concurrently with
+  // one another for the same order_key.
+  void Verify(Check check, ResultFunctor result);
+  void Verify(Batch batch);
+  Statistics statistics() const;
+
+ private:
+  enum class State { kPending, kValid, kInvalid };
+  struct Job {
+    Job(Check check_in, ResultFunctor result_in, std::string cache_key_in)
+        : check(std::move(check_in)), result(std::move(result_in)),
+          cache_key(std::move(cache_key_in)), state(State::kPending) {}
+    Check check;
+    ResultFunctor result;
+    std::string cache_key;
+    State state;
+  };
+
+  // The undelivered jobs with one order_key, in submission order.
+  struct Stream {
+    Stream() : jobs(), delivering(false) {}
+    std::deque<std::shared_ptr<Job>> jobs;
+    bool delivering;
+  };
+
+  static std::string CacheKey(const Check& check);
+  void Run();
+  // Delivers the results of completed jobs at the front of the stream for 'order_key', unless
+  // another thread is already doing so.  Must be called with lock held; returns with it held.
+  void Deliver(const std::string& order_key, std::unique_lock<std::mutex>& lock);
+
+  BoundedKeySet verified_;
+  mutable std::mutex mutex_;
+  std::condition_variable condition_;
+  std::unordered_map<std::string, Stream> streams_;  // keyed by order_key; empty ones are erased
+  std::deque<std::shared_ptr<Job>> queue_;            // jobs awaiting a worker
+  unsigned int delivering_;                           // number of threads in Deliver()
+  bool stopped_;
+  Statistics statistics_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace routing
+
+}  // namespace maidsafe
+
+#endif  // MAIDSAFE_ROUTING_SIGNATURE_VERIFIER_H_
@@ -0,0 +1,78 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/tests/allocation_counter.h"
+
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <new>
+
+#include "maidsafe/common/config.h"
+
+namespace {
+
+std::atomic<bool> g_active(false);
+// Only the thread which created the active counter counts, so that work done meanwhile by other
+// threads (asio, rudp or pipeline stages) doesn't disturb its figures.
+thread_local bool t_counting(false);
+std::atomic<std::size_t> g_allocations(0);
+std::atomic<std::size_t> g_bytes(0);
+
+}  // unnamed namespace
+
+void* operator new(std::size_t size) {
+  if (t_counting) {
+    ++g_allocations;
+    g_bytes += size;
+  }
+  if (void* memory = std::malloc(size == 0 ? 1 : size))
+    return memory;
+  throw std::bad_alloc();
+}
+
+void operator delete(void* memory) MAIDSAFE_NOEXCEPT { std::free(memory); }
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+ScopedAllocationCounter::ScopedAllocationCounter() {
+  assert(!g_active && "Allocation counters must not overlap");
+  g_active = true;
+  g_allocations = 0;
+  g_bytes = 0;
+  t_counting = true;
+}
+
+ScopedAllocationCounter::~ScopedAllocationCounter() {
+  t_counting = false;
+  g_active = false;
+}
+
+std::size_t ScopedAllocationCounter::allocations() const { return g_allocations; }
+
+std::size_t ScopedAllocationCounter::bytes() const { return g_bytes; }
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,133 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/bootstrap_contact_store.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+class BootstrapContactStoreTest : public testing::Test {
+ protected:
+  BootstrapContactStoreTest()
+      : test_path_(maidsafe::test::CreateTestPath("MaidSafe_TestBootstrapContactStore")),
+        bootstrap_file_path_(*test_path_ / "bootstrap"),
+        asio_service_(1),
+        bootstrap_contacts_() {
+    for (int i(0); i < 100; ++i) {
+      BootstrapContact contact;
+      do {
+        contact = BootstrapContact(maidsafe::GetLocalIp(), maidsafe::test::GetRandomPort());
+      } while (std::find(bootstrap_contacts_.begin(), bootstrap_contacts_.end(), contact) !=
+               bootstrap_contacts_.end());
+      bootstrap_contacts_.push_back(contact);
+    }
+  }
+
+  void ExpectAllWritten() {
+    auto bootstrap_contacts_result(ReadBootstrapContacts(bootstrap_file_path_));
+    EXPECT_EQ(bootstrap_contacts_.size(), bootstrap_contacts_result.size());
+    for (const auto& contact : bootstrap_contacts_) {
+      EXPECT_NE(bootstrap_contacts_result.end(),
+                std::find(bootstrap_contacts_result.begin(), bootstrap_contacts_result.end(),
+                          contact));
+    }
+  }
+
+  maidsafe::test::TestPath test_path_;
+  const fs::path bootstrap_file_path_;
+  AsioService asio_service_;
+  BootstrapContacts bootstrap_contacts_;
+};
+
+TEST_F(BootstrapContactStoreTest, BEH_WritesBatchOnTimer) {
+  auto store(std::make_shared<BootstrapContactStore>(asio_service_, bootstrap_file_path_,
+                                                     std::chrono::milliseconds(200)));
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
+  for (const auto& contact : bootstrap_contacts_)
+    store->Add(contact);
+  // Duplicates are only written once.
+  store->Add(bootstrap_contacts_.front());
+  EXPECT_EQ(bootstrap_contacts_.size(), store->pending_count());
+  EXPECT_EQ(kCommitCount, detail::BootstrapFileCommitCount());
+  EXPECT_FALSE(fs::exists(bootstrap_file_path_));
+
+  Sleep(std::chrono::seconds(1));
+  EXPECT_EQ(0U, store->pending_count());
+  EXPECT_EQ(kCommitCount + 1, detail::BootstrapFileCommitCount());
+  ExpectAllWritten();
+}
+
+TEST_F(BootstrapContactStoreTest, BEH_FlushesOnDestruction) {
+  auto store(std::make_shared<BootstrapContactStore>(asio_service_, bootstrap_file_path_,
+                                                     std::chrono::hours(1)));
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
+  for (const auto& contact : bootstrap_contacts_)
+    store->Add(contact);
+  EXPECT_EQ(kCommitCount, detail::BootstrapFileCommitCount());
+  store.reset();
+  EXPECT_EQ(kCommitCount + 1, detail::BootstrapFileCommitCount());
+  ExpectAllWritten();
+}
+
+TEST_F(BootstrapContactStoreTest, BEH_ExplicitFlush) {
+  auto store(std::make_shared<BootstrapContactStore>(asio_service_, bootstrap_file_path_,
+                                                     std::chrono::hours(1)));
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
+  store->Flush();  // Nothing to write
+  EXPECT_EQ(kCommitCount, detail::BootstrapFileCommitCount());
+  for (const auto& contact : bootstrap_contacts_)
+    store->Add(contact);
+  store->Flush();
+  EXPECT_EQ(0U, store->pending_count());
+  EXPECT_EQ(kCommitCount + 1, detail::BootstrapFileCommitCount());
+  ExpectAllWritten();
+  store.reset();
+  EXPECT_EQ(kCommitCount + 1, detail::BootstrapFileCommitCount());
+}
+
+TEST_F(BootstrapContactStoreTest, BEH_ZeroIntervalWritesEachContact) {
+  auto store(std::make_shared<BootstrapContactStore>(
+      asio_service_, bootstrap_file_path_, std::chrono::steady_clock::duration::zero()));
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
+  for (const auto& contact : bootstrap_contacts_)
+    store->Add(contact);
+  EXPECT_EQ(0U, store->pending_count());
+  EXPECT_EQ(kCommitCount + bootstrap_contacts_.size(), detail::BootstrapFileCommitCount());
+  ExpectAllWritten();
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -16,6 +16,9 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
 #include <vector>
 
@@ -40,6 +43,7 @@ TEST(BootstrapFileOperationsTest, FUNC_FileExists) {
   ASSERT_FALSE(fs::exists(bootstrap_file_path));
   EXPECT_TRUE(WriteFile(bootstrap_file_path, file_content));
   EXPECT_TRUE(fs::exists(bootstrap_file_path));
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
   EXPECT_THROW(ReadBootstrapContacts(bootstrap_file_path), std::exception) << "read from bad file";
   EXPECT_TRUE(fs::exists(bootstrap_file_path)) << bootstrap_file_path.string() << "should exist";
   BootstrapContacts bootstrap_contacts;
@@ -50,6 +54,7 @@ TEST(BootstrapFileOperationsTest, FUNC_FileExists) {
   EXPECT_THROW(WriteBootstrapContacts(bootstrap_contacts, bootstrap_file_path), std::exception)
       << "file exists, should throw";
   EXPECT_THROW(ReadBootstrapContacts(bootstrap_file_path), std::exception) << "read bad file";
+  EXPECT_EQ(kCommitCount, detail::BootstrapFileCommitCount());
 }
 
 TEST(BootstrapFileOperationsTest, BEH_ReadWrite) {
@@ -73,7 +78,10 @@ TEST(BootstrapFileOperationsTest, BEH_ReadWrite) {
     bootstrap_contacts.push_back(contact);
   }
 
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
   EXPECT_NO_THROW(WriteBootstrapContacts(bootstrap_contacts, bootstrap_file_path));
+  // All of the contacts are written with a single sync.
+  EXPECT_EQ(kCommitCount + 1, detail::BootstrapFileCommitCount());
   auto bootstrap_contacts_result = ReadBootstrapContacts(bootstrap_file_path);
   EXPECT_EQ(bootstrap_contacts_result, bootstrap_contacts) << bootstrap_contacts_result.size()
                                                            << " vs " << bootstrap_contacts.size();
@@ -87,6 +95,7 @@ TEST(BootstrapFileOperationsTest, FUNC_Parallel_Unique_Update) {
   EXPECT_FALSE(fs::exists(bootstrap_file_path));
 
   std::mutex mutex;
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
   ::maidsafe::test::RunInParallel(20, [&] {
     BootstrapContacts bootstrap_contacts;
     for (int i(0); i < 20; ++i) {
@@ -108,6 +117,8 @@ TEST(BootstrapFileOperationsTest, FUNC_Parallel_Unique_Update) {
                 std::find(bootstrap_contacts_result.begin(), bootstrap_contacts_result.end(), i));
     }
   });
+  // Each update is a transaction, and so a sync, of its own.
+  EXPECT_EQ(kCommitCount + 20 * 20, detail::BootstrapFileCommitCount());
 }
 
 TEST(BootstrapFileOperationsTest, FUNC_Parallel_Duplicate_Update) {
@@ -123,6 +134,7 @@ TEST(BootstrapFileOperationsTest, FUNC_Parallel_Duplicate_Update) {
         BootstrapContact(maidsafe::GetLocalIp(), maidsafe::test::GetRandomPort()));
   }
 
+  const uint64_t kCommitCount(detail::BootstrapFileCommitCount());
   ::maidsafe::test::RunInParallel(20, [&] {
     for (const auto& i : bootstrap_contacts) {
       EXPECT_NO_THROW(InsertOrUpdateBootstrapContact(i, bootstrap_file_path));
@@ -133,6 +145,51 @@ TEST(BootstrapFileOperationsTest, FUNC_Parallel_Duplicate_Update) {
                 std::find(bootstrap_contacts_result.begin(), bootstrap_contacts_result.end(), i));
     }
   });
+  EXPECT_EQ(kCommitCount + 20 * bootstrap_contacts.size(), detail::BootstrapFileCommitCount());
+}
+
+TEST(BootstrapFileOperationsTest, BEH_ReadWriteRoutingTableContacts) {
+  maidsafe::test::TestPath test_path(maidsafe::test::CreateTestPath("MaidSafe_TestUtils"));
+  fs::path bootstrap_file_path(*test_path / "bootstrap");
+  const NodeId kOwner(NodeId::IdType::kRandomId), kOtherOwner(NodeId::IdType::kRandomId);
+  EXPECT_THROW(ReadRoutingTableContacts(kOwner, bootstrap_file_path), std::exception);
+
+  // Saved alongside bootstrap contacts, which are left alone.
+  BootstrapContacts bootstrap_contacts(
+      1, BootstrapContact(maidsafe::GetLocalIp(), maidsafe::test::GetRandomPort()));
+  EXPECT_NO_THROW(WriteBootstrapContacts(bootstrap_contacts, bootstrap_file_path));
+  const auto kNow(std::chrono::system_clock::now());
+  RoutingTableContacts contacts, other_contacts;
+  for (int i(0); i < 64; ++i) {
+    contacts.push_back(RoutingTableContact{NodeId(NodeId::IdType::kRandomId),
+                                           kNow - std::chrono::seconds(i)});
+    other_contacts.push_back(RoutingTableContact{NodeId(NodeId::IdType::kRandomId), kNow});
+  }
+  std::reverse(contacts.begin(), contacts.end());
+  EXPECT_NO_THROW(WriteRoutingTableContacts(kOwner, contacts, bootstrap_file_path));
+  EXPECT_NO_THROW(WriteRoutingTableContacts(kOtherOwner, other_contacts, bootstrap_file_path));
+
+  auto contacts_result(ReadRoutingTableContacts(kOwner, bootstrap_file_path));
+  ASSERT_EQ(contacts.size(), contacts_result.size());
+  // Most recently seen first, to the second.
+  for (size_t i(0); i != contacts.size(); ++i) {
+    const auto& contact(contacts.at(contacts.size() - 1 - i));
+    EXPECT_EQ(contact.node_id, contacts_result.at(i).node_id);
+    EXPECT_EQ(std::chrono::duration_cast<std::chrono::seconds>(
+                  contact.last_seen.time_since_epoch()),
+              std::chrono::duration_cast<std::chrono::seconds>(
+                  contacts_result.at(i).last_seen.time_since_epoch()));
+  }
+  EXPECT_EQ(bootstrap_contacts, ReadBootstrapContacts(bootstrap_file_path));
+
+  // Rewriting replaces the owner's contacts only.
+  contacts.resize(10);
+  EXPECT_NO_THROW(WriteRoutingTableContacts(kOwner, contacts, bootstrap_file_path));
+  EXPECT_EQ(contacts.size(), ReadRoutingTableContacts(kOwner, bootstrap_file_path).size());
+  EXPECT_EQ(other_contacts.size(),
+            ReadRoutingTableContacts(kOtherOwner, bootstrap_file_path).size());
+  EXPECT_TRUE(
+      ReadRoutingTableContacts(NodeId(NodeId::IdType::kRandomId), bootstrap_file_path).empty());
 }
 
 }  // namespace test
@@ -0,0 +1,76 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/bounded_key_set.h"
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(BoundedKeySetTest, BEH_InsertContainsErase) {
+  BoundedKeySet keys(3);
+  EXPECT_FALSE(keys.Contains("a"));
+  EXPECT_TRUE(keys.Insert("a"));
+  EXPECT_FALSE(keys.Insert("a"));
+  EXPECT_TRUE(keys.Contains("a"));
+  EXPECT_EQ(1U, keys.size());
+
+  keys.Erase("a");
+  keys.Erase("not present");
+  EXPECT_FALSE(keys.Contains("a"));
+  EXPECT_EQ(0U, keys.size());
+}
+
+TEST(BoundedKeySetTest, BEH_EvictsOldestWhenFull) {
+  BoundedKeySet keys(3);
+  for (const auto& key : {"a", "b", "c", "d"})
+    EXPECT_TRUE(keys.Insert(key));
+  EXPECT_EQ(3U, keys.size());
+  EXPECT_FALSE(keys.Contains("a"));
+  EXPECT_TRUE(keys.Contains("b"));
+  EXPECT_TRUE(keys.Contains("d"));
+
+  // Erasing from the middle leaves the remaining eviction order intact.
+  keys.Erase("c");
+  EXPECT_TRUE(keys.Insert("e"));
+  EXPECT_TRUE(keys.Insert("f"));
+  EXPECT_FALSE(keys.Contains("b"));
+  EXPECT_TRUE(keys.Contains("d"));
+  EXPECT_TRUE(keys.Contains("e"));
+  EXPECT_TRUE(keys.Contains("f"));
+
+  keys.Clear();
+  EXPECT_EQ(0U, keys.size());
+}
+
+TEST(BoundedKeySetTest, BEH_ZeroCapacityDisables) {
+  BoundedKeySet keys(0);
+  EXPECT_FALSE(keys.Insert("a"));
+  EXPECT_FALSE(keys.Contains("a"));
+  EXPECT_EQ(0U, keys.size());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
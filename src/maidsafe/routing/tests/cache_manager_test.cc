@@ -0,0 +1,290 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <string>
+
+#include "boost/filesystem/path.hpp"
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/acknowledgement.h"
+#include "maidsafe/routing/cache_manager.h"
+#include "maidsafe/routing/client_routing_table.h"
+#include "maidsafe/routing/message_handler.h"
+#include "maidsafe/routing/network.h"
+#include "maidsafe/routing/parameters.h"
+#include "maidsafe/routing/routing.pb.h"
+#include "maidsafe/routing/routing_table.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+class CacheManagerTest : public testing::Test {
+ protected:
+  CacheManagerTest()
+      : node_id_(NodeId::IdType::kRandomId),
+        kDestination_(NodeId::IdType::kRandomId),
+        asio_service_(2),
+        acknowledgement_(node_id_, asio_service_),
+        routing_table_(false, node_id_, asymm::GenerateKeyPair()),
+        client_routing_table_(routing_table_.kNodeId()),
+        network_(routing_table_, client_routing_table_, acknowledgement_),
+        kLocalRetrievalTimeout_(Parameters::local_retreival_timeout),
+        kMaxCacheSize_(Parameters::max_cache_size_in_bytes),
+        kCoalesceGets_(Parameters::coalesce_cacheable_gets),
+        kCoalescedGetTimeout_(Parameters::coalesced_get_timeout) {
+    Parameters::local_retreival_timeout = std::chrono::milliseconds(200);
+    Parameters::coalesced_get_timeout = std::chrono::milliseconds(200);
+  }
+
+  ~CacheManagerTest() {
+    Parameters::local_retreival_timeout = kLocalRetrievalTimeout_;
+    Parameters::max_cache_size_in_bytes = kMaxCacheSize_;
+    Parameters::coalesce_cacheable_gets = kCoalesceGets_;
+    Parameters::coalesced_get_timeout = kCoalescedGetTimeout_;
+    acknowledgement_.RemoveAll();
+    asio_service_.Stop();
+  }
+
+  protobuf::Message CacheableGet(const std::string& key) {
+    protobuf::Message message;
+    message.set_routing_message(false);
+    message.set_client_node(false);
+    message.set_request(true);
+    message.add_data(key);
+    message.set_direct(true);
+    message.set_type(static_cast<int32_t>(MessageType::kNodeLevel));
+    message.set_cacheable(static_cast<int32_t>(Cacheable::kGet));
+    message.set_hops_to_live(Parameters::hops_to_live);
+    message.set_source_id(NodeId(NodeId::IdType::kRandomId).string());
+    message.set_destination_id(kDestination_.string());
+    message.set_id(RandomUint32() % 10000);
+    return message;
+  }
+
+  protobuf::Message CacheablePut(const std::string& key, const std::string& value) {
+    protobuf::Message message;
+    message.set_routing_message(false);
+    message.set_client_node(false);
+    message.set_request(false);
+    message.add_data(value);
+    message.set_direct(true);
+    message.set_type(static_cast<int32_t>(MessageType::kNodeLevel));
+    message.set_hops_to_live(Parameters::hops_to_live);
+    message.set_cacheable(static_cast<int32_t>(Cacheable::kPut));
+    message.set_cache_key(key);
+    return message;
+  }
+
+  MessageAndCachingFunctors Functors(HaveCacheDataFunctor have_cache_data) {
+    MessageAndCachingFunctors functors;
+    functors.message_received = [](const std::string&, ReplyFunctor) {};  // NOLINT
+    functors.have_cache_data = have_cache_data;
+    functors.store_cache_data = [](const std::string&) {};  // NOLINT
+    return functors;
+  }
+
+  NodeId node_id_;
+  const NodeId kDestination_;
+  AsioService asio_service_;
+  Acknowledgement acknowledgement_;
+  RoutingTable routing_table_;
+  ClientRoutingTable client_routing_table_;
+  Network network_;
+  const std::chrono::steady_clock::duration kLocalRetrievalTimeout_;
+  const uint64_t kMaxCacheSize_;
+  const bool kCoalesceGets_;
+  const std::chrono::steady_clock::duration kCoalescedGetTimeout_;
+};
+
+TEST_F(CacheManagerTest, BEH_SlowCacheDoesNotBlock) {
+  CacheManager cache_manager(node_id_, network_, asio_service_);
+  ReplyFunctor pending_reply;
+  cache_manager.InitialiseFunctors(Functors(
+      [&](const std::string&, ReplyFunctor reply) { pending_reply = reply; }));  // NOLINT
+
+  std::promise<std::string> resumed;
+  auto message(CacheableGet("key"));
+  auto start(std::chrono::steady_clock::now());
+  cache_manager.HandleGetFromCache(message, [&](protobuf::Message& request) {
+    resumed.set_value(request.data(0));
+  });
+  EXPECT_LT(std::chrono::steady_clock::now() - start, Parameters::local_retreival_timeout);
+
+  auto future(resumed.get_future());
+  ASSERT_EQ(std::future_status::ready, future.wait_for(Parameters::local_retreival_timeout * 5));
+  EXPECT_EQ("key", future.get());
+  // A reply arriving after the deadline is ignored.
+  pending_reply("late reply");
+}
+
+TEST_F(CacheManagerTest, BEH_ReplyAfterDestructionIsIgnored) {
+  ReplyFunctor pending_reply;
+  std::atomic<bool> resumed(false);
+  {
+    CacheManager cache_manager(node_id_, network_, asio_service_);
+    cache_manager.InitialiseFunctors(Functors(
+        [&](const std::string&, ReplyFunctor reply) { pending_reply = reply; }));  // NOLINT
+    auto message(CacheableGet("key"));
+    cache_manager.HandleGetFromCache(message, [&](protobuf::Message&) { resumed = true; });
+  }
+  // Neither the reply nor the expiring timer may touch the destroyed CacheManager.
+  pending_reply("late reply");
+  pending_reply = nullptr;
+  Sleep(Parameters::local_retreival_timeout * 2);
+  EXPECT_FALSE(resumed);
+}
+
+TEST_F(CacheManagerTest, BEH_EmptyReplyResumesRequest) {
+  CacheManager cache_manager(node_id_, network_, asio_service_);
+  cache_manager.InitialiseFunctors(Functors(
+      [](const std::string&, ReplyFunctor reply) { reply(std::string()); }));  // NOLINT
+
+  std::promise<std::string> resumed;
+  auto message(CacheableGet("key"));
+  cache_manager.HandleGetFromCache(message, [&](protobuf::Message& request) {
+    resumed.set_value(request.data(0));
+  });
+  auto future(resumed.get_future());
+  ASSERT_EQ(std::future_status::ready, future.wait_for(Parameters::local_retreival_timeout));
+  EXPECT_EQ("key", future.get());
+}
+
+TEST_F(CacheManagerTest, BEH_AnswersFromRoutingCache) {
+  Parameters::max_cache_size_in_bytes = 1024 * 1024;
+  CacheManager cache_manager(node_id_, network_, asio_service_);
+  bool upper_layer_asked(false);
+  cache_manager.InitialiseFunctors(Functors([&](const std::string&, ReplyFunctor reply) {
+    upper_layer_asked = true;
+    reply(std::string());
+  }));
+
+  cache_manager.AddToCache(CacheablePut("key", "value"));
+
+  bool missed(false);
+  auto message(CacheableGet("key"));
+  cache_manager.HandleGetFromCache(message, [&](protobuf::Message&) { missed = true; });
+  EXPECT_FALSE(missed);
+  EXPECT_FALSE(upper_layer_asked);
+  EXPECT_EQ(1U, cache_manager.statistics().hits);
+  EXPECT_EQ(1U, cache_manager.statistics().entries);
+}
+
+TEST_F(CacheManagerTest, BEH_WritesToDiskOffTheCallersThread) {
+  maidsafe::test::TestPath test_path(maidsafe::test::CreateTestPath("MaidSafe_TestCacheManager"));
+  const boost::filesystem::path kDiskCacheDirectory(Parameters::disk_cache_directory);
+  Parameters::disk_cache_directory = *test_path;
+  Parameters::max_cache_size_in_bytes = 0;
+  bool upper_layer_asked(false);
+  auto functors(Functors([&](const std::string&, ReplyFunctor reply) {
+    upper_layer_asked = true;
+    reply(std::string());
+  }));
+  {
+    CacheManager cache_manager(node_id_, network_, asio_service_);
+    cache_manager.InitialiseFunctors(functors);
+    cache_manager.AddToCache(CacheablePut("key", "value"));
+  }
+  // Queued writes are completed when the CacheManager is destroyed.
+  CacheManager cache_manager(node_id_, network_, asio_service_);
+  cache_manager.InitialiseFunctors(functors);
+  auto message(CacheableGet("key"));
+  cache_manager.HandleGetFromCache(message, [](protobuf::Message&) {});  // NOLINT
+  EXPECT_FALSE(upper_layer_asked);
+  Parameters::disk_cache_directory = kDiskCacheDirectory;
+}
+
+TEST_F(CacheManagerTest, BEH_CoalescesIdenticalGets) {
+  Parameters::coalesce_cacheable_gets = true;
+  CacheManager cache_manager(node_id_, network_, asio_service_);
+  std::atomic<int> forwarded(0);
+  auto forward([&](protobuf::Message&) { ++forwarded; });  // NOLINT
+  for (int i(0); i != 3; ++i) {
+    auto message(CacheableGet("key"));
+    cache_manager.HandleGetFromCache(message, forward);
+  }
+  EXPECT_EQ(1, forwarded.load());
+  auto other(CacheableGet("other key"));
+  cache_manager.HandleGetFromCache(other, forward);
+  EXPECT_EQ(2, forwarded.load());
+
+  // The held requests are answered by the response, after which the key is no longer in flight.
+  cache_manager.AnswerCoalescedGets(CacheablePut("key", "value"));
+  auto message(CacheableGet("key"));
+  cache_manager.HandleGetFromCache(message, forward);
+  EXPECT_EQ(3, forwarded.load());
+}
+
+TEST_F(CacheManagerTest, BEH_CoalescesOnlySameDestinationAndType) {
+  Parameters::coalesce_cacheable_gets = true;
+  CacheManager cache_manager(node_id_, network_, asio_service_);
+  std::atomic<int> forwarded(0);
+  auto forward([&](protobuf::Message&) { ++forwarded; });  // NOLINT
+  auto send([&](const NodeId& destination, MessageType type) {
+    auto message(CacheableGet("key"));
+    message.set_destination_id(destination.string());
+    message.set_type(static_cast<int32_t>(type));
+    cache_manager.HandleGetFromCache(message, forward);
+  });
+  const NodeId kOtherDestination(NodeId::IdType::kRandomId);
+  send(kDestination_, MessageType::kNodeLevel);
+  send(kOtherDestination, MessageType::kNodeLevel);
+  send(kDestination_, MessageType::kFindNodes);
+  EXPECT_EQ(3, forwarded.load());
+
+  // A response for the data ends coalescing for every destination, but not for other types.
+  cache_manager.AnswerCoalescedGets(CacheablePut("key", "value"));
+  send(kDestination_, MessageType::kNodeLevel);
+  send(kOtherDestination, MessageType::kNodeLevel);
+  send(kDestination_, MessageType::kFindNodes);
+  EXPECT_EQ(5, forwarded.load());
+}
+
+TEST_F(CacheManagerTest, BEH_HeldGetsForwardedAfterTimeout) {
+  Parameters::coalesce_cacheable_gets = true;
+  CacheManager cache_manager(node_id_, network_, asio_service_);
+  std::atomic<int> forwarded(0);
+  std::promise<void> all_forwarded;
+  auto forward([&](protobuf::Message&) {  // NOLINT
+    if (++forwarded == 3)
+      all_forwarded.set_value();
+  });
+  for (int i(0); i != 3; ++i) {
+    auto message(CacheableGet("key"));
+    cache_manager.HandleGetFromCache(message, forward);
+  }
+  EXPECT_EQ(1, forwarded.load());
+  auto future(all_forwarded.get_future());
+  EXPECT_EQ(std::future_status::ready, future.wait_for(Parameters::coalesced_get_timeout * 5));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,187 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/callback_executor.h"
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(CallbackExecutorTest, BEH_WrappedFunctorRunsOnExecutor) {
+  auto executor(std::make_shared<CallbackExecutor>(1, 64));
+  std::promise<std::thread::id> promise;
+  auto future(promise.get_future());
+  std::function<void(const std::string&)> functor(
+      [&promise](const std::string& value) {
+        EXPECT_EQ("value", value);
+        promise.set_value(std::this_thread::get_id());
+      });
+  auto wrapped(executor->Wrap(functor));
+  {
+    std::string value("value");
+    wrapped(value);
+  }  // the argument must have been copied
+  ASSERT_EQ(std::future_status::ready, future.wait_for(std::chrono::seconds(5)));
+  EXPECT_NE(std::this_thread::get_id(), future.get());
+
+  EXPECT_FALSE(executor->Wrap(std::function<void(int)>()));
+}
+
+TEST(CallbackExecutorTest, BEH_SlowCallbackQueuesOthers) {
+  auto executor(std::make_shared<CallbackExecutor>(1, 64));
+  std::promise<void> release;
+  auto released(release.get_future().share());
+  std::atomic<int> count(0);
+  executor->Post([released] { released.wait(); });
+  for (int i(0); i != 10; ++i)
+    executor->Post([&count] { ++count; });
+  // The poster isn't blocked by the slow callback; the others wait behind it.
+  Sleep(std::chrono::milliseconds(100));
+  EXPECT_EQ(10U, executor->queue_depth());
+  EXPECT_LE(10U, executor->max_queue_depth());
+  EXPECT_EQ(0, count.load());
+
+  release.set_value();
+  executor.reset();  // runs what's queued before returning
+  EXPECT_EQ(10, count.load());
+}
+
+TEST(CallbackExecutorTest, BEH_FullQueueDropsCallback) {
+  auto executor(std::make_shared<CallbackExecutor>(1, 4));
+  std::promise<void> release, started;
+  auto released(release.get_future().share());
+  executor->Post([&started, released] {
+    started.set_value();
+    released.wait();
+  });
+  started.get_future().wait();
+  for (int i(0); i != 4; ++i)
+    executor->Post([] {});
+  EXPECT_EQ(4U, executor->queue_depth());
+  EXPECT_EQ(0U, executor->dropped_count());
+
+  bool called(false);
+  executor->Post([&called] { called = true; });
+  executor->PostOrdered([&called] { called = true; });
+  EXPECT_EQ(4U, executor->queue_depth());
+  EXPECT_EQ(2U, executor->dropped_count());
+  release.set_value();
+  executor.reset();
+  EXPECT_FALSE(called);
+}
+
+TEST(CallbackExecutorTest, BEH_OrderedCallbacksRunInOrder) {
+  auto executor(std::make_shared<CallbackExecutor>(4, 1024));
+  std::vector<int> order;
+  std::atomic<int> running(0), unordered(0);
+  bool overlapped(false);
+  std::function<void(int)> functor([&](int value) {
+    if (running++ != 0)
+      overlapped = true;
+    order.push_back(value);
+    --running;
+  });
+  auto wrapped(executor->WrapOrdered(functor));
+  for (int i(0); i != 200; ++i) {
+    wrapped(i);
+    executor->Post([&unordered] { ++unordered; });
+  }
+  executor.reset();  // runs what's queued before returning
+  EXPECT_FALSE(overlapped);
+  ASSERT_EQ(200U, order.size());
+  for (int i(0); i != 200; ++i)
+    EXPECT_EQ(i, order[i]);
+  EXPECT_EQ(200, unordered.load());
+}
+
+TEST(CallbackExecutorTest, BEH_WrappedFunctorDroppedOnceDestroyed) {
+  auto executor(std::make_shared<CallbackExecutor>(2, 64));
+  bool called(false);
+  std::function<void(int)> functor([&called](int) { called = true; });
+  auto wrapped(executor->Wrap(functor));
+  executor.reset();
+  wrapped(1);
+  EXPECT_FALSE(called);
+}
+
+TEST(CallbackExecutorTest, BEH_WrappedFunctorDroppedOnceLifetimeClosed) {
+  CallbackExecutor executor(2, 64);
+  auto lifetime(std::make_shared<Lifetime>());
+  std::promise<void> started, release;
+  auto release_future(release.get_future().share());
+  std::atomic<int> calls(0);
+  std::function<void(int)> functor([&](int value) {
+    ++calls;
+    if (value == 0) {
+      started.set_value();
+      release_future.wait();
+    }
+  });
+  auto wrapped(executor.Wrap(functor, lifetime));
+  wrapped(0);
+  started.get_future().wait();
+  // Close() waits for the running call, after which later calls are dropped.
+  auto closed(std::async(std::launch::async, [lifetime] { lifetime->Close(); }));
+  EXPECT_EQ(std::future_status::timeout, closed.wait_for(std::chrono::milliseconds(100)));
+  release.set_value();
+  closed.get();
+  wrapped(1);
+  executor.Stop();
+  EXPECT_EQ(1, calls);
+}
+
+TEST(CallbackExecutorTest, BEH_DestroyedFromOwnCallback) {
+  auto executor(std::make_shared<CallbackExecutor>(2, 64));
+  std::promise<void> destroyed;
+  // Once this reference is dropped, the callback holds the last one, so the executor is destroyed
+  // on its own thread.
+  std::shared_ptr<CallbackExecutor> last_reference(executor);
+  executor->Post([&destroyed, last_reference]() mutable {
+    last_reference.reset();
+    destroyed.set_value();
+  });
+  last_reference.reset();
+  executor.reset();
+  EXPECT_EQ(std::future_status::ready, destroyed.get_future().wait_for(std::chrono::seconds(5)));
+}
+
+TEST(CallbackExecutorTest, BEH_PostAfterStopIsDropped) {
+  CallbackExecutor executor(1, 64);
+  executor.Stop();
+  bool called(false);
+  executor.Post([&called] { called = true; });
+  EXPECT_FALSE(called);
+  EXPECT_EQ(1U, executor.dropped_count());
+  executor.Stop();
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
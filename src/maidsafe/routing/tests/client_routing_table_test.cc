@@ -170,9 +170,10 @@ TEST_F(ClientRoutingTableTest, BEH_CheckAddSameConnectionIdTwice) {
   EXPECT_TRUE(client_routing_table.CheckNode(nodes_.at(0), nodes_.at(2).id));
   EXPECT_TRUE(client_routing_table.AddNode(nodes_.at(0), nodes_.at(2).id));
 
-  nodes_.at(1).public_key = nodes_.at(0).public_key;
+  nodes_.at(1).set_public_key(nodes_.at(0).shared_public_key());
 
-  EXPECT_TRUE(asymm::MatchingKeys(nodes_.at(0).public_key, nodes_.at(1).public_key));
+  EXPECT_TRUE(asymm::MatchingKeys(*nodes_.at(0).shared_public_key(),
+                                  *nodes_.at(1).shared_public_key()));
   EXPECT_TRUE(client_routing_table.CheckNode(nodes_.at(1), nodes_.at(2).id));
   EXPECT_FALSE(client_routing_table.AddNode(nodes_.at(1), nodes_.at(2).id));
 }*/
@@ -187,10 +188,11 @@ TEST_F(ClientRoutingTableTest, BEH_CheckAddSameConnectionAndKeysTwice) {
   EXPECT_TRUE(client_routing_table.AddNode(nodes_.at(0), nodes_.at(2).id));
 
   nodes_.at(1).connection_id = nodes_.at(0).connection_id;
-  nodes_.at(1).public_key = nodes_.at(0).public_key;
+  nodes_.at(1).set_public_key(nodes_.at(0).shared_public_key());
 
   EXPECT_EQ(nodes_.at(0).connection_id, nodes_.at(1).connection_id);
-  EXPECT_TRUE(asymm::MatchingKeys(nodes_.at(0).public_key, nodes_.at(1).public_key));
+  EXPECT_TRUE(asymm::MatchingKeys(*nodes_.at(0).shared_public_key(),
+                                  *nodes_.at(1).shared_public_key()));
   EXPECT_TRUE(client_routing_table.CheckNode(nodes_.at(1), nodes_.at(2).id));
   EXPECT_FALSE(client_routing_table.AddNode(nodes_.at(1), nodes_.at(2).id));
 }
@@ -229,7 +231,8 @@ TEST_F(ClientRoutingTableTest, FUNC_DropNodes) {
     found_counterpart = false;
     for (const auto& dropped_node : dropped_nodes) {
       if ((expected_node.connection_id == dropped_node.connection_id) &&
-          asymm::MatchingKeys(expected_node.public_key, dropped_node.public_key)) {
+          asymm::MatchingKeys(*expected_node.shared_public_key(),
+                              *dropped_node.shared_public_key())) {
         found_counterpart = true;
         break;
       }
@@ -280,7 +283,7 @@ TEST_F(ClientRoutingTableTest, FUNC_GetNodesInfo) {
     found_counterpart = false;
     for (const auto& got_node : got_nodes) {
       if ((expected_node.connection_id == got_node.connection_id) &&
-          asymm::MatchingKeys(expected_node.public_key, got_node.public_key)) {
+          asymm::MatchingKeys(*expected_node.shared_public_key(), *got_node.shared_public_key())) {
         found_counterpart = true;
         break;
       }
@@ -0,0 +1,170 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/close_nodes_change_coalescer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/parameters.h"
+#include "maidsafe/routing/routing_table.h"
+#include "maidsafe/routing/tests/test_utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+class CloseNodesChangeCoalescerTest : public testing::Test {
+ protected:
+  CloseNodesChangeCoalescerTest()
+      : kQuietPeriod_(std::chrono::milliseconds(200)),
+        kMaxHold_(std::chrono::milliseconds(600)),
+        node_id_(NodeId::IdType::kRandomId),
+        asio_service_(1),
+        routing_table_(false, node_id_, asymm::GenerateKeyPair()),
+        mutex_(),
+        reported_(),
+        coalescer_(std::make_shared<CloseNodesChangeCoalescer>(
+            asio_service_, kQuietPeriod_, kMaxHold_,
+            [this](std::shared_ptr<CloseNodesChange> close_nodes_change) {
+              std::lock_guard<std::mutex> lock(mutex_);
+              reported_.push_back(close_nodes_change);
+            })),
+        raw_change_count_(0) {
+    routing_table_.InitialiseFunctors([this](const RoutingTableChange& routing_table_change) {
+      if (routing_table_change.close_nodes_change) {
+        ++raw_change_count_;
+        coalescer_->Add(routing_table_change.close_nodes_change);
+      }
+    });
+  }
+
+  std::vector<std::shared_ptr<CloseNodesChange>> Reported() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return reported_;
+  }
+
+  std::vector<NodeId> Sorted(std::vector<NodeId> node_ids) {
+    std::sort(node_ids.begin(), node_ids.end());
+    return node_ids;
+  }
+
+  const std::chrono::steady_clock::duration kQuietPeriod_, kMaxHold_;
+  const NodeId node_id_;
+  AsioService asio_service_;
+  RoutingTable routing_table_;
+  std::mutex mutex_;
+  std::vector<std::shared_ptr<CloseNodesChange>> reported_;
+  std::shared_ptr<CloseNodesChangeCoalescer> coalescer_;
+  int raw_change_count_;
+};
+
+TEST_F(CloseNodesChangeCoalescerTest, BEH_BurstReportedAsOneNetChange) {
+  std::vector<NodeId> added;
+  while (routing_table_.size() < Parameters::closest_nodes_size) {
+    NodeInfo node(MakeNode());
+    ASSERT_TRUE(routing_table_.AddNode(node));
+    added.push_back(node.id);
+  }
+  EXPECT_EQ(static_cast<int>(Parameters::closest_nodes_size), raw_change_count_);
+  EXPECT_TRUE(Reported().empty());
+
+  Sleep(kQuietPeriod_ * 3);
+  auto reported(Reported());
+  ASSERT_EQ(1U, reported.size());
+  EXPECT_TRUE(reported.front()->old_close_nodes().empty());
+  EXPECT_TRUE(reported.front()->lost_nodes().empty());
+  EXPECT_EQ(Sorted(added), Sorted(reported.front()->new_nodes()));
+  EXPECT_EQ(Sorted(added), Sorted(reported.front()->new_close_nodes()));
+  EXPECT_EQ(routing_table_.GetClosestNode(node_id_).id, reported.front()->new_node());
+}
+
+TEST_F(CloseNodesChangeCoalescerTest, BEH_ChangesWhichCancelOutNotReported) {
+  std::vector<NodeInfo> added;
+  while (routing_table_.size() < Parameters::closest_nodes_size) {
+    NodeInfo node(MakeNode());
+    ASSERT_TRUE(routing_table_.AddNode(node));
+    added.push_back(node);
+  }
+  Sleep(kQuietPeriod_ * 3);
+  ASSERT_EQ(1U, Reported().size());
+
+  // A node leaving and rejoining within the quiet period is no net change.
+  raw_change_count_ = 0;
+  routing_table_.DropNode(added.front().id, true);
+  ASSERT_TRUE(routing_table_.AddNode(added.front()));
+  EXPECT_EQ(2, raw_change_count_);
+  Sleep(kQuietPeriod_ * 3);
+  EXPECT_EQ(1U, Reported().size());
+
+  // A node leaving and another joining is reported as a single swap.
+  routing_table_.DropNode(added.front().id, true);
+  NodeInfo joiner(MakeNode());
+  ASSERT_TRUE(routing_table_.AddNode(joiner));
+  routing_table_.DropNode(added.back().id, true);
+  ASSERT_TRUE(routing_table_.AddNode(added.back()));
+  Sleep(kQuietPeriod_ * 3);
+  auto reported(Reported());
+  ASSERT_EQ(2U, reported.size());
+  EXPECT_EQ(std::vector<NodeId>(1, added.front().id), reported.back()->lost_nodes());
+  EXPECT_EQ(std::vector<NodeId>(1, joiner.id), reported.back()->new_nodes());
+}
+
+TEST_F(CloseNodesChangeCoalescerTest, BEH_ContinuousChurnReportedByMaxHold) {
+  std::vector<NodeInfo> added;
+  while (routing_table_.size() < Parameters::closest_nodes_size) {
+    NodeInfo node(MakeNode());
+    ASSERT_TRUE(routing_table_.AddNode(node));
+    added.push_back(node);
+  }
+  Sleep(kQuietPeriod_ * 3);
+  ASSERT_EQ(1U, Reported().size());
+
+  // Changes arriving more often than the quiet period would otherwise hold the report back for as
+  // long as they keep coming.
+  auto start(std::chrono::steady_clock::now());
+  while (std::chrono::steady_clock::now() - start < kMaxHold_ * 2) {
+    routing_table_.DropNode(added.front().id, true);
+    NodeInfo joiner(MakeNode());
+    ASSERT_TRUE(routing_table_.AddNode(joiner));
+    added.front() = joiner;
+    Sleep(kQuietPeriod_ / 4);
+  }
+  EXPECT_LE(2U, Reported().size());
+}
+
+TEST_F(CloseNodesChangeCoalescerTest, BEH_CancelDropsPendingChange) {
+  ASSERT_TRUE(routing_table_.AddNode(MakeNode()));
+  coalescer_->Cancel();
+  Sleep(kQuietPeriod_ * 3);
+  EXPECT_TRUE(Reported().empty());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,172 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/connection_manager.h"
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+class ConnectionManagerTest : public testing::Test {
+ protected:
+  ConnectionManagerTest()
+      : kMaxConcurrent_(3),
+        kMaxQueued_(10),
+        this_node_id_(NodeId::IdType::kRandomId),
+        asio_service_(1),
+        mutex_(),
+        priorities_(),
+        attempted_(),
+        connection_manager_() {}
+
+  void MakeConnectionManager(std::chrono::steady_clock::duration attempt_timeout) {
+    connection_manager_ = std::make_shared<ConnectionManager>(
+        asio_service_, this_node_id_, kMaxConcurrent_, kMaxQueued_, attempt_timeout,
+        [this](const NodeId& peer) {
+          auto itr(priorities_.find(peer));
+          return itr == priorities_.end() ? 0 : itr->second;
+        },
+        [this](const NodeId& peer) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          attempted_.push_back(peer);
+        });
+  }
+
+  std::vector<NodeId> Attempted() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return attempted_;
+  }
+
+  const unsigned int kMaxConcurrent_, kMaxQueued_;
+  const NodeId this_node_id_;
+  AsioService asio_service_;
+  std::mutex mutex_;
+  std::map<NodeId, int> priorities_;
+  std::vector<NodeId> attempted_;
+  std::shared_ptr<ConnectionManager> connection_manager_;
+};
+
+TEST_F(ConnectionManagerTest, BEH_BoundsConcurrentAttempts) {
+  MakeConnectionManager(std::chrono::seconds(10));
+  std::vector<NodeId> peers;
+  for (unsigned int i(0); i != kMaxConcurrent_ + 4; ++i) {
+    peers.push_back(NodeId(NodeId::IdType::kRandomId));
+    EXPECT_TRUE(connection_manager_->Add(peers.back()));
+  }
+  EXPECT_EQ(kMaxConcurrent_, Attempted().size());
+  EXPECT_EQ(kMaxConcurrent_, connection_manager_->in_flight_count());
+  EXPECT_EQ(4U, connection_manager_->queued_count());
+
+  connection_manager_->Finished(Attempted().front());
+  EXPECT_EQ(kMaxConcurrent_ + 1, Attempted().size());
+  EXPECT_EQ(kMaxConcurrent_, connection_manager_->in_flight_count());
+  EXPECT_EQ(3U, connection_manager_->queued_count());
+
+  // Finishing an unknown or already finished attempt frees nothing.
+  connection_manager_->Finished(Attempted().front());
+  connection_manager_->Finished(NodeId(NodeId::IdType::kRandomId));
+  EXPECT_EQ(kMaxConcurrent_ + 1, Attempted().size());
+
+  for (size_t i(0); i != peers.size(); ++i)
+    connection_manager_->Finished(Attempted().at(i));
+  EXPECT_EQ(peers.size(), Attempted().size());
+  EXPECT_EQ(0U, connection_manager_->in_flight_count());
+  EXPECT_EQ(0U, connection_manager_->queued_count());
+}
+
+TEST_F(ConnectionManagerTest, BEH_RejectsDuplicatesAndOverflow) {
+  MakeConnectionManager(std::chrono::seconds(10));
+  NodeId in_flight(NodeId::IdType::kRandomId);
+  EXPECT_TRUE(connection_manager_->Add(in_flight));
+  EXPECT_FALSE(connection_manager_->Add(in_flight));
+  for (unsigned int i(1); i != kMaxConcurrent_; ++i)
+    EXPECT_TRUE(connection_manager_->Add(NodeId(NodeId::IdType::kRandomId)));
+  NodeId queued(NodeId::IdType::kRandomId);
+  EXPECT_TRUE(connection_manager_->Add(queued));
+  EXPECT_FALSE(connection_manager_->Add(queued));
+  for (unsigned int i(1); i != kMaxQueued_; ++i)
+    EXPECT_TRUE(connection_manager_->Add(NodeId(NodeId::IdType::kRandomId)));
+  EXPECT_EQ(kMaxQueued_, connection_manager_->queued_count());
+  EXPECT_FALSE(connection_manager_->Add(NodeId(NodeId::IdType::kRandomId)));
+  EXPECT_EQ(kMaxConcurrent_, Attempted().size());
+
+  // Once finished, a peer can be attempted again.
+  connection_manager_->Finished(in_flight);
+  EXPECT_TRUE(connection_manager_->Add(in_flight));
+}
+
+TEST_F(ConnectionManagerTest, BEH_AttemptsInPriorityOrder) {
+  MakeConnectionManager(std::chrono::seconds(10));
+  std::vector<NodeId> blockers;
+  for (unsigned int i(0); i != kMaxConcurrent_; ++i) {
+    blockers.push_back(NodeId(NodeId::IdType::kRandomId));
+    connection_manager_->Add(blockers.back());
+  }
+  // Queue equal numbers of low, medium and high priority peers in a random order.
+  std::vector<NodeId> queued;
+  for (int i(0); i != 9; ++i) {
+    queued.push_back(NodeId(NodeId::IdType::kRandomId));
+    priorities_[queued.back()] = static_cast<int>(RandomUint32() % 3);
+  }
+  for (const auto& peer : queued)
+    EXPECT_TRUE(connection_manager_->Add(peer));
+
+  for (const auto& blocker : blockers)
+    connection_manager_->Finished(blocker);
+  for (size_t i(kMaxConcurrent_); i != kMaxConcurrent_ + queued.size(); ++i)
+    connection_manager_->Finished(Attempted().at(i));
+
+  auto attempted(Attempted());
+  ASSERT_EQ(kMaxConcurrent_ + queued.size(), attempted.size());
+  for (size_t i(kMaxConcurrent_ + 1); i < attempted.size(); ++i) {
+    const NodeId& previous(attempted.at(i - 1)), current(attempted.at(i));
+    EXPECT_GE(priorities_[previous], priorities_[current]);
+    if (priorities_[previous] == priorities_[current]) {
+      EXPECT_TRUE(NodeId::CloserToTarget(previous, current, this_node_id_));
+    }
+  }
+}
+
+TEST_F(ConnectionManagerTest, BEH_StalledAttemptsTimeOut) {
+  MakeConnectionManager(std::chrono::milliseconds(100));
+  for (unsigned int i(0); i != kMaxConcurrent_ * 2; ++i)
+    connection_manager_->Add(NodeId(NodeId::IdType::kRandomId));
+  EXPECT_EQ(kMaxConcurrent_, Attempted().size());
+  Sleep(std::chrono::milliseconds(500));
+  EXPECT_EQ(kMaxConcurrent_ * 2, Attempted().size());
+  Sleep(std::chrono::milliseconds(500));
+  EXPECT_EQ(0U, connection_manager_->in_flight_count());
+  EXPECT_EQ(0U, connection_manager_->queued_count());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,103 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <string>
+
+#include "boost/filesystem/operations.hpp"
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/disk_cache.h"
+
+namespace fs = boost::filesystem;
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(DiskCacheTest, BEH_GetAndPut) {
+  maidsafe::test::TestPath test_path(maidsafe::test::CreateTestPath("MaidSafe_TestDiskCache"));
+  DiskCache cache(*test_path / "cache", 64 * 1024, 16 * 1024);
+  std::string value;
+  EXPECT_FALSE(cache.Get("key", value));
+  EXPECT_TRUE(cache.Put("key", "value"));
+  EXPECT_TRUE(cache.Get("key", value));
+  EXPECT_EQ("value", value);
+  EXPECT_TRUE(cache.Put("key", "other value"));
+  EXPECT_TRUE(cache.Get("key", value));
+  EXPECT_EQ("other value", value);
+  EXPECT_EQ(1U, cache.entries());
+  EXPECT_FALSE(cache.Put("too large", std::string(16 * 1024, 'x')));
+}
+
+TEST(DiskCacheTest, BEH_SurvivesRestart) {
+  maidsafe::test::TestPath test_path(maidsafe::test::CreateTestPath("MaidSafe_TestDiskCache"));
+  const fs::path kDirectory(*test_path / "cache");
+  const std::string kValue(RandomString(1000));
+  {
+    DiskCache cache(kDirectory, 64 * 1024, 16 * 1024);
+    for (int i(0); i != 20; ++i)
+      EXPECT_TRUE(cache.Put(std::to_string(i), kValue));
+    EXPECT_TRUE(cache.Put("0", "replaced"));
+  }
+  DiskCache cache(kDirectory, 64 * 1024, 16 * 1024);
+  EXPECT_EQ(20U, cache.entries());
+  std::string value;
+  EXPECT_TRUE(cache.Get("0", value));
+  EXPECT_EQ("replaced", value);
+  EXPECT_TRUE(cache.Get("19", value));
+  EXPECT_EQ(kValue, value);
+}
+
+TEST(DiskCacheTest, BEH_DropsOldestSegmentWhenFull) {
+  maidsafe::test::TestPath test_path(maidsafe::test::CreateTestPath("MaidSafe_TestDiskCache"));
+  DiskCache cache(*test_path / "cache", 4 * 1024, 1024);
+  for (int i(0); i != 40; ++i)
+    EXPECT_TRUE(cache.Put(std::to_string(i), std::string(200, 'x')));
+  EXPECT_EQ(4U, cache.segment_count());
+  std::string value;
+  EXPECT_FALSE(cache.Get("0", value));
+  EXPECT_TRUE(cache.Get("39", value));
+}
+
+TEST(DiskCacheTest, BEH_Compaction) {
+  maidsafe::test::TestPath test_path(maidsafe::test::CreateTestPath("MaidSafe_TestDiskCache"));
+  DiskCache cache(*test_path / "cache", 8 * 1024, 1024);
+  EXPECT_TRUE(cache.Put("kept", std::string(200, 'k')));
+  for (int i(0); i != 12; ++i)
+    EXPECT_TRUE(cache.Put("replaced", std::string(200, static_cast<char>('a' + i))));
+  EXPECT_TRUE(cache.NeedsCompaction());
+  while (cache.NeedsCompaction())
+    cache.Compact();
+  EXPECT_EQ(2U, cache.entries());
+  EXPECT_GE(2U, cache.segment_count());
+  std::string value;
+  EXPECT_TRUE(cache.Get("kept", value));
+  EXPECT_EQ(std::string(200, 'k'), value);
+  EXPECT_TRUE(cache.Get("replaced", value));
+  EXPECT_EQ(std::string(200, 'l'), value);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
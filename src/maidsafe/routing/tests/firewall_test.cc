@@ -0,0 +1,150 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/firewall.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/message_inbox.h"
+#include "maidsafe/routing/parameters.h"
+#include "maidsafe/routing/routing.pb.h"
+#include "maidsafe/routing/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+std::string SerialisedMessage(const NodeId& source_id, int32_t id) {
+  protobuf::Message message;
+  message.set_source_id(source_id.string());
+  message.set_destination_id(NodeId(NodeId::IdType::kRandomId).string());
+  message.set_routing_message(false);
+  message.set_direct(true);
+  message.set_client_node(false);
+  message.set_request(true);
+  message.set_hops_to_live(Parameters::hops_to_live);
+  message.set_id(id);
+  message.add_data(RandomString(64));
+  return message.SerializeAsString();
+}
+
+// Pushes 'messages' through a MessageInbox with a ring per thread, steered by source as
+// Routing::Impl does, and returns how many per second pass the firewall's check.
+double MessagesPerSecond(unsigned int thread_count, unsigned int shard_count,
+                         const std::vector<std::string>& messages) {
+  AsioService asio_service(thread_count);
+  Firewall firewall(shard_count);
+  std::atomic<size_t> handled(0);
+  std::promise<void> all_handled;
+  MessageInbox inbox(thread_count, messages.size(), Parameters::message_inbox_batch_size,
+                     [&](std::function<void()> task) { asio_service.service().post(task); },
+                     [&](std::vector<std::string>& batch) {
+                       protobuf::Message message;
+                       for (const auto& serialised : batch) {
+                         if (message.ParseFromString(serialised)) {
+                           EXPECT_TRUE(firewall.Add(NodeId(message.source_id()), message.id()));
+                         }
+                       }
+                       if ((handled += batch.size()) == messages.size())
+                         all_handled.set_value();
+                     },
+                     &MessageShardIndex);
+  auto start(std::chrono::steady_clock::now());
+  for (const auto& message : messages)
+    inbox.Push(message);
+  all_handled.get_future().wait();
+  std::chrono::duration<double> elapsed(std::chrono::steady_clock::now() - start);
+  asio_service.Stop();
+  return messages.size() / elapsed.count();
+}
+
+}  // unnamed namespace
+
+TEST(FirewallTest, BEH_AddRejectsRepeats) {
+  Firewall firewall(4);
+  NodeId source(NodeId::IdType::kRandomId), other_source(NodeId::IdType::kRandomId);
+  EXPECT_FALSE(firewall.Add(NodeId(), 1));
+  EXPECT_TRUE(firewall.Add(source, 1));
+  EXPECT_FALSE(firewall.Add(source, 1));
+  EXPECT_TRUE(firewall.Add(source, 2));
+  EXPECT_TRUE(firewall.Add(other_source, 1));
+  EXPECT_FALSE(firewall.Add(other_source, 1));
+}
+
+TEST(FirewallTest, BEH_MessagesSteeredBySource) {
+  NodeId source(NodeId::IdType::kRandomId);
+  const size_t kShard(ShardIndex(source.string(), 16));
+  EXPECT_EQ(kShard, MessageShardIndex(SerialisedMessage(source, 1), 16));
+  EXPECT_EQ(kShard, MessageShardIndex(SerialisedMessage(source, 2), 16));
+  // Shards of a multiple of a count nest within those of the count.
+  EXPECT_EQ(kShard % 2, MessageShardIndex(SerialisedMessage(source, 3), 2));
+
+  // A relayed message has no source id, so is steered by its relay id.
+  protobuf::Message relayed;
+  relayed.ParseFromString(SerialisedMessage(source, 4));
+  relayed.clear_source_id();
+  relayed.set_relay_id(source.string());
+  EXPECT_EQ(kShard, MessageShardIndex(relayed.SerializeAsString(), 16));
+  EXPECT_EQ(ShardIndex(std::string(), 16), MessageShardIndex("not a message", 16));
+}
+
+// Reports the throughput of the receive path's lock-sharing part from one thread up to one per
+// core, with the firewall's state in a single shard and in Parameters::state_shard_count shards.
+TEST(FirewallTest, FUNC_ShardedProcessingScaling) {
+  const int kSources(256), kMessagesPerSource(400);
+  std::vector<std::string> messages;
+  messages.reserve(kSources * kMessagesPerSource);
+  std::vector<NodeId> sources;
+  for (int i(0); i != kSources; ++i)
+    sources.emplace_back(NodeId::IdType::kRandomId);
+  for (int id(0); id != kMessagesPerSource; ++id) {
+    for (const auto& source : sources)
+      messages.push_back(SerialisedMessage(source, id));
+  }
+
+  const unsigned int kMaxThreads(std::max(std::thread::hardware_concurrency(), 1U));
+  for (unsigned int threads(1); threads <= kMaxThreads; threads *= 2) {
+    double unsharded(MessagesPerSecond(threads, 1, messages));
+    double sharded(MessagesPerSecond(threads, Parameters::state_shard_count, messages));
+    LOG(kInfo) << threads << " thread(s) - 1 shard: " << static_cast<int>(unsharded)
+               << " msgs/s, " << Parameters::state_shard_count
+               << " shards: " << static_cast<int>(sharded) << " msgs/s";
+  }
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -0,0 +1,122 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/routing/frequency_sketch.h"
+#include "maidsafe/routing/sharded_cache.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+struct TraceResult {
+  double hit_ratio;
+  size_t bytes;
+};
+
+// Replays 'trace' through a cache of 'capacity' entries, fetching and caching each miss.
+TraceResult ReplayTrace(const std::vector<std::string>& trace, size_t capacity, bool admission) {
+  const std::string kValue(1024, 'v');
+  ShardedCache cache(capacity, capacity * 2048, 1);
+  FrequencySketch sketch(capacity);
+  ShardedCache::AdmissionFunctor admit;
+  if (admission) {
+    admit = [&sketch](const std::string& candidate_key, const std::string& victim_key) {
+      return sketch.Frequency(candidate_key) > sketch.Frequency(victim_key);
+    };
+  }
+  std::string value;
+  for (const auto& key : trace) {
+    if (admission)
+      sketch.Increment(key);
+    if (!cache.Get(key, value))
+      cache.Put(key, kValue, admit);
+  }
+  auto statistics(cache.statistics());
+  TraceResult result;
+  result.hit_ratio = static_cast<double>(statistics.hits) / trace.size();
+  result.bytes = statistics.bytes + (admission ? sketch.size_in_bytes() : 0);
+  return result;
+}
+
+}  // unnamed namespace
+
+TEST(FrequencySketchTest, BEH_EstimatesFrequency) {
+  FrequencySketch sketch(100);
+  EXPECT_EQ(0U, sketch.Frequency("key"));
+  for (int i(0); i != 5; ++i)
+    sketch.Increment("key");
+  sketch.Increment("other key");
+  EXPECT_GE(sketch.Frequency("key"), 5U);
+  EXPECT_GE(sketch.Frequency("other key"), 1U);
+  EXPECT_LT(sketch.Frequency("other key"), sketch.Frequency("key"));
+}
+
+TEST(FrequencySketchTest, BEH_CountersSaturateAndAge) {
+  FrequencySketch sketch(16);
+  for (int i(0); i != 100; ++i)
+    sketch.Increment("key");
+  EXPECT_EQ(15U, sketch.Frequency("key"));
+  // Enough other samples to trigger ageing at least once.
+  for (int i(0); i != 1000; ++i)
+    sketch.Increment(std::to_string(i));
+  EXPECT_LT(sketch.Frequency("key"), 15U);
+}
+
+// Trace-driven comparison of hit ratio and memory with and without admission.  The trace mixes
+// Zipf-distributed requests for popular data with an equal number of one-off requests, which an
+// LRU cache alone lets evict the popular entries.
+TEST(FrequencySketchTest, FUNC_AdmissionImprovesHitRatio) {
+  const size_t kPopularKeys(10000), kRequests(200000), kCapacity(500);
+  std::mt19937 generator(1);
+  std::vector<double> weights;
+  for (size_t i(1); i <= kPopularKeys; ++i)
+    weights.push_back(1.0 / std::pow(static_cast<double>(i), 0.9));
+  std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+  std::vector<std::string> trace;
+  for (size_t i(0); i != kRequests; ++i) {
+    if (i % 2 == 0)
+      trace.push_back("popular " + std::to_string(zipf(generator)));
+    else
+      trace.push_back("one-off " + std::to_string(i));
+  }
+
+  auto without_admission(ReplayTrace(trace, kCapacity, false));
+  auto with_admission(ReplayTrace(trace, kCapacity, true));
+  LOG(kInfo) << "LRU: hit ratio " << without_admission.hit_ratio << ", " << without_admission.bytes
+             << " bytes.  TinyLFU + LRU: hit ratio " << with_admission.hit_ratio << ", "
+             << with_admission.bytes << " bytes.";
+  EXPECT_GT(with_admission.hit_ratio, without_admission.hit_ratio);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -17,8 +17,10 @@
     use of the MaidSafe Software.                                                                 */
 
 #include <chrono>
+#include <string>
 
 #include "maidsafe/common/asio_service.h"
+#include "maidsafe/common/log.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/test.h"
 #include "maidsafe/common/node_id.h"
@@ -26,6 +28,8 @@
 #include "maidsafe/passport/passport.h"
 
 #include "maidsafe/routing/message_handler.h"
+#include "maidsafe/routing/network.h"
+#include "maidsafe/routing/tests/allocation_counter.h"
 #include "maidsafe/routing/tests/mock_service.h"
 #include "maidsafe/routing/tests/mock_response_handler.h"
 #include "maidsafe/routing/tests/mock_network.h"
@@ -745,6 +749,49 @@ TEST_F(MessageHandlerTest, BEH_ClientRoutingTable) {
   }
 }
 
+TEST_F(MessageHandlerTest, BEH_ForwardDoesNotCopyPayload) {
+  // The message is passed on to this node's only peer.  That peer is unknown to rudp, so the send
+  // fails, but only once the message has been serialised; any retry has no other peer to go to.
+  RoutingTable routing_table(false, NodeId(NodeId::IdType::kRandomId), asymm::GenerateKeyPair());
+  ClientRoutingTable client_routing_table(routing_table.kNodeId());
+  NodeInfo peer(MakeNodeInfoAndKeys().node_info);
+  ASSERT_TRUE(routing_table.AddNode(peer));
+  // With no transmit thread, the message is serialised for rudp on this thread, so the counter
+  // sees all that passing it on costs.
+  const unsigned int kTransmitThreadCount(Parameters::transmit_thread_count);
+  Parameters::transmit_thread_count = 0;
+  Network network(routing_table, client_routing_table, network_network_->acknowledgement_);
+  Parameters::transmit_thread_count = kTransmitThreadCount;
+  MessageHandler message_handler(routing_table, client_routing_table, network, timer_,
+                                 *network_network_, asio_service_);
+
+  const std::size_t kPayloadSize(1024 * 1024);
+  protobuf::Message message;
+  message.set_routing_message(false);
+  message.set_client_node(false);
+  message.set_request(true);
+  message.set_direct(true);
+  message.set_type(static_cast<int32_t>(MessageType::kNodeLevel));
+  message.set_hops_to_live(Parameters::hops_to_live);
+  message.set_source_id(NodeId(NodeId::IdType::kRandomId).string());
+  message.set_destination_id(peer.id.string());
+  message.add_data(std::string(kPayloadSize, 'p'));
+
+  std::size_t allocated_bytes(0);
+  {
+    ScopedAllocationCounter counter;
+    message_handler.HandleMessage(message);
+    allocated_bytes = counter.bytes();
+  }
+  // The serialised buffer handed to rudp; the message itself is passed on without being copied.
+  EXPECT_LT(kPayloadSize, allocated_bytes);
+  EXPECT_GT(2 * kPayloadSize, allocated_bytes);
+  LOG(kInfo) << "Allocated " << allocated_bytes << " bytes forwarding a " << kPayloadSize
+             << " byte payload";
+  // The ack timer would otherwise outlive network.
+  network_network_->acknowledgement_.RemoveAll();
+}
+
 }  // namespace test
 
 }  // namespace routing
@@ -0,0 +1,205 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/message_inbox.h"
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/routing/mpsc_ring.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+// Stands in for the asio queue so that tests can see each posted task.
+struct ManualPoster {
+  void Post(std::function<void()> task) {
+    std::lock_guard<std::mutex> lock(mutex);
+    tasks.push_back(task);
+  }
+  // Runs queued tasks (including ones they post) until none are left; returns how many ran.
+  size_t RunAll() {
+    size_t count(0);
+    for (;;) {
+      std::function<void()> task;
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (tasks.empty())
+          return count;
+        task = tasks.front();
+        tasks.pop_front();
+      }
+      task();
+      ++count;
+    }
+  }
+  std::mutex mutex;
+  std::deque<std::function<void()>> tasks;
+};
+
+}  // unnamed namespace
+
+TEST(MessageInboxTest, BEH_RingRejectsWhenFull) {
+  MpscRing<std::string> ring(3);
+  EXPECT_EQ(4U, ring.capacity());
+  EXPECT_FALSE(ring.HasPending());
+  for (int i(0); i != 4; ++i)
+    EXPECT_TRUE(ring.TryPush(std::to_string(i)));
+  std::string rejected("rejected");
+  EXPECT_FALSE(ring.TryPush(std::move(rejected)));
+  EXPECT_EQ("rejected", rejected);
+  std::string value;
+  for (int i(0); i != 4; ++i) {
+    ASSERT_TRUE(ring.TryPop(value));
+    EXPECT_EQ(std::to_string(i), value);
+  }
+  EXPECT_FALSE(ring.TryPop(value));
+  EXPECT_TRUE(ring.TryPush("again"));
+  EXPECT_TRUE(ring.HasPending());
+}
+
+TEST(MessageInboxTest, BEH_RingKeepsEachProducersOrder) {
+  const int kProducers(4), kPerProducer(20000);
+  MpscRing<std::string> ring(64);
+  std::vector<std::thread> producers;
+  for (int producer(0); producer != kProducers; ++producer) {
+    producers.emplace_back([&ring, producer, kPerProducer] {
+      for (int i(0); i != kPerProducer; ++i) {
+        std::string value(std::to_string(producer) + ":" + std::to_string(i));
+        while (!ring.TryPush(std::move(value)))
+          std::this_thread::yield();
+      }
+    });
+  }
+  std::vector<int> next(kProducers, 0);
+  std::string value;
+  for (int popped(0); popped != kProducers * kPerProducer;) {
+    if (!ring.TryPop(value)) {
+      std::this_thread::yield();
+      continue;
+    }
+    size_t colon(value.find(':'));
+    int producer(std::stoi(value.substr(0, colon)));
+    EXPECT_EQ(next[producer]++, std::stoi(value.substr(colon + 1)));
+    ++popped;
+  }
+  for (auto& producer : producers)
+    producer.join();
+  EXPECT_EQ(std::vector<int>(kProducers, kPerProducer), next);
+  EXPECT_FALSE(ring.HasPending());
+}
+
+TEST(MessageInboxTest, BEH_HandlesMessagesInBatches) {
+  ManualPoster poster;
+  std::vector<std::string> handled;
+  std::vector<size_t> batch_sizes;
+  MessageInbox inbox(1, 64, 4, [&poster](std::function<void()> task) { poster.Post(task); },
+                     [&](std::vector<std::string>& messages) {
+                       batch_sizes.push_back(messages.size());
+                       handled.insert(handled.end(), messages.begin(), messages.end());
+                     });
+  for (int i(0); i != 10; ++i)
+    inbox.Push(std::to_string(i));
+  // Only the first push posts a task; it then re-posts itself after each full batch of 4.
+  EXPECT_EQ(1U, poster.tasks.size());
+  EXPECT_EQ(3U, poster.RunAll());
+  EXPECT_EQ(std::vector<size_t>({4, 4, 2}), batch_sizes);
+  ASSERT_EQ(10U, handled.size());
+  for (int i(0); i != 10; ++i)
+    EXPECT_EQ(std::to_string(i), handled[i]);
+
+  inbox.Push("more");
+  EXPECT_EQ(1U, poster.RunAll());
+  EXPECT_EQ(1U, batch_sizes.back());
+  EXPECT_EQ("more", handled.back());
+}
+
+TEST(MessageInboxTest, BEH_FullRingDropsMessage) {
+  ManualPoster poster;
+  std::vector<std::string> handled;
+  MessageInbox inbox(1, 2, 64, [&poster](std::function<void()> task) { poster.Post(task); },
+                     [&handled](std::vector<std::string>& messages) {
+                       handled.insert(handled.end(), messages.begin(), messages.end());
+                     });
+  for (int i(0); i != 5; ++i)
+    inbox.Push(std::to_string(i));
+  // One drain task for the two ring slots; the overflowing messages are dropped rather than being
+  // handled out of order.
+  EXPECT_EQ(1U, poster.tasks.size());
+  EXPECT_EQ(3U, inbox.dropped_count());
+  poster.RunAll();
+  EXPECT_EQ(std::vector<std::string>({"0", "1"}), handled);
+
+  inbox.Push("5");
+  poster.RunAll();
+  EXPECT_EQ("5", handled.back());
+  EXPECT_EQ(3U, inbox.dropped_count());
+}
+
+TEST(MessageInboxTest, BEH_ConcurrentPushesAreAllHandled) {
+  const int kProducers(4), kPerProducer(5000);
+  ManualPoster poster;
+  std::mutex mutex;
+  std::multiset<std::string> handled;
+  // Room for every message, since the consumer may fall behind and a full ring drops.
+  MessageInbox inbox(2, kProducers * kPerProducer, 16,
+                     [&poster](std::function<void()> task) { poster.Post(task); },
+                     [&](std::vector<std::string>& messages) {
+                       std::lock_guard<std::mutex> lock(mutex);
+                       handled.insert(messages.begin(), messages.end());
+                     });
+  std::vector<std::thread> producers;
+  for (int producer(0); producer != kProducers; ++producer) {
+    producers.emplace_back([&inbox, producer, kPerProducer] {
+      for (int i(0); i != kPerProducer; ++i)
+        inbox.Push(std::to_string(producer * kPerProducer + i));
+    });
+  }
+  std::atomic<bool> done(false);
+  std::thread consumer([&] {
+    while (!done)
+      poster.RunAll();
+  });
+  for (auto& producer : producers)
+    producer.join();
+  done = true;
+  consumer.join();
+  poster.RunAll();
+  ASSERT_EQ(static_cast<size_t>(kProducers * kPerProducer), handled.size());
+  for (int i(0); i != kProducers * kPerProducer; ++i)
+    EXPECT_EQ(1U, handled.count(std::to_string(i)));
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
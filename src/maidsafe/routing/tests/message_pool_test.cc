@@ -0,0 +1,136 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/log.h"
+#include "maidsafe/common/node_id.h"
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/message_pool.h"
+#include "maidsafe/routing/parameters.h"
+#include "maidsafe/routing/routing.pb.h"
+#include "maidsafe/routing/rpcs.h"
+#include "maidsafe/routing/tests/allocation_counter.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+namespace {
+
+std::string SerialisedMessage(size_t data_size) {
+  protobuf::Message message(rpcs::Ping(NodeId(NodeId::IdType::kRandomId),
+                                       NodeId(NodeId::IdType::kRandomId).string()));
+  message.clear_data();
+  message.add_data(RandomString(data_size));
+  message.add_route_history(NodeId(NodeId::IdType::kRandomId).string());
+  message.add_route_history(NodeId(NodeId::IdType::kRandomId).string());
+  return message.SerializeAsString();
+}
+
+}  // unnamed namespace
+
+TEST(MessagePoolTest, BEH_RecyclesReleasedMessages) {
+  MessagePool pool(2, 1024);
+  EXPECT_EQ(0U, pool.size());
+  protobuf::Message* first_address(nullptr);
+  {
+    auto message(pool.Acquire());
+    first_address = message.get();
+    message->set_id(1);
+    message->add_data("data");
+  }
+  EXPECT_EQ(1U, pool.size());
+  auto message(pool.Acquire());
+  EXPECT_EQ(first_address, message.get());
+  EXPECT_FALSE(message->has_id());
+  EXPECT_EQ(0, message->data_size());
+  EXPECT_EQ(0U, pool.size());
+
+  // Capacity is respected.
+  {
+    auto message1(pool.Acquire()), message2(pool.Acquire()), message3(pool.Acquire());
+  }
+  EXPECT_EQ(2U, pool.size());
+}
+
+TEST(MessagePoolTest, BEH_LargeMessagesNotRecycled) {
+  MessagePool pool(2, 1024);
+  {
+    auto message(pool.Acquire());
+    message->add_data(std::string(2048, 'a'));
+  }
+  EXPECT_EQ(0U, pool.size());
+  {
+    auto copy(pool.Copy(protobuf::Message()));
+    copy->add_data(std::string(512, 'a'));
+  }
+  EXPECT_EQ(1U, pool.size());
+}
+
+TEST(MessagePoolTest, BEH_MessageOutlivesPool) {
+  std::shared_ptr<protobuf::Message> message;
+  {
+    MessagePool pool(2, 1024);
+    message = pool.Acquire();
+  }
+  message->set_id(1);
+  message.reset();
+}
+
+TEST(MessagePoolTest, BEH_ParseAllocations) {
+  const int kIterations(1000);
+  std::vector<std::string> serialised;
+  for (int i(0); i != 16; ++i)
+    serialised.push_back(SerialisedMessage(256 + i));
+
+  std::size_t fresh_allocations(0), pooled_allocations(0);
+  {
+    ScopedAllocationCounter counter;
+    for (int i(0); i != kIterations; ++i) {
+      protobuf::Message message;
+      EXPECT_TRUE(message.ParseFromString(serialised[i % serialised.size()]));
+    }
+    fresh_allocations = counter.allocations();
+  }
+
+  MessagePool pool(Parameters::message_pool_size, Parameters::max_pooled_message_size);
+  pool.Acquire();  // warm the pool
+  {
+    ScopedAllocationCounter counter;
+    for (int i(0); i != kIterations; ++i) {
+      auto message(pool.Acquire());
+      EXPECT_TRUE(message->ParseFromString(serialised[i % serialised.size()]));
+    }
+    pooled_allocations = counter.allocations();
+  }
+  LOG(kInfo) << "Allocations parsing " << kIterations << " messages: " << fresh_allocations
+             << " without pool, " << pooled_allocations << " with pool";
+  EXPECT_LT(pooled_allocations * 2, fresh_allocations);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
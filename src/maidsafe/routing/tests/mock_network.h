@@ -39,6 +39,10 @@ class MockNetwork : public Network {
   virtual ~MockNetwork();
 
   MOCK_METHOD1(SendToClosestNode, void(const protobuf::Message& message));
+  // Reported as a call to the mocked overload, leaving 'message' intact.
+  void SendToClosestNode(protobuf::Message&& message) override {
+    SendToClosestNode(static_cast<const protobuf::Message&>(message));
+  }
   MOCK_METHOD1(MarkConnectionAsValid, int(const NodeId& peer_id));
   MOCK_METHOD3(SendToDirect, void(protobuf::Message& message, const NodeId& peer,
                                   const NodeId& connection));
@@ -0,0 +1,220 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/node_lookup.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+class NodeLookupTest : public testing::Test {
+ protected:
+  NodeLookupTest()
+      : kParallelism_(3),
+        kShortlistSize_(8),
+        target_(NodeId::IdType::kRandomId),
+        asio_service_(2),
+        network_(),
+        unresponsive_(),
+        mutex_(),
+        cond_var_(),
+        result_(),
+        finished_(false),
+        outstanding_(0),
+        max_outstanding_(0),
+        query_count_(0),
+        lookup_() {
+    // Each node knows its own nearest neighbours plus a couple of nodes at each distance (as a
+    // routing table would), so a lookup has to iterate to find the nodes closest to the target.
+    std::vector<NodeId> all_nodes;
+    for (int i(0); i != 200; ++i)
+      all_nodes.push_back(NodeId(NodeId::IdType::kRandomId));
+    for (const auto& node : all_nodes) {
+      std::vector<NodeId> others(all_nodes);
+      others.erase(std::find(others.begin(), others.end(), node));
+      std::sort(others.begin(), others.end(), [&node](const NodeId& lhs, const NodeId& rhs) {
+        return NodeId::CloserToTarget(lhs, rhs, node);
+      });
+      std::vector<NodeId> known(others.begin(), others.begin() + 4);
+      std::map<int, int> per_bucket;
+      for (const auto& other : others) {
+        if (++per_bucket[CommonLeadingBits(node, other)] <= 2)
+          known.push_back(other);
+      }
+      network_[node] = known;
+    }
+  }
+
+  static int CommonLeadingBits(const NodeId& lhs, const NodeId& rhs) {
+    const std::string kLhs(lhs.string()), kRhs(rhs.string());
+    for (size_t i(0); i != kLhs.size(); ++i) {
+      auto difference(static_cast<unsigned char>(kLhs[i] ^ kRhs[i]));
+      if (difference != 0) {
+        int bits(static_cast<int>(i) * 8);
+        while ((difference & 0x80) == 0) {
+          difference = static_cast<unsigned char>(difference << 1);
+          ++bits;
+        }
+        return bits;
+      }
+    }
+    return static_cast<int>(kLhs.size()) * 8;
+  }
+
+  std::shared_ptr<NodeLookup> MakeLookup(std::chrono::steady_clock::duration response_timeout) {
+    auto node_lookup(std::make_shared<NodeLookup>(
+        asio_service_, target_, kParallelism_, kShortlistSize_, response_timeout,
+        [this](const NodeId& peer) { Query(peer); },
+        [this](const std::vector<NodeId>& closest_nodes) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          result_ = closest_nodes;
+          finished_ = true;
+          cond_var_.notify_one();
+        }));
+    lookup_ = node_lookup;
+    return node_lookup;
+  }
+
+  void Query(const NodeId& peer) {
+    ++query_count_;
+    unsigned int outstanding(++outstanding_);
+    unsigned int max_outstanding(max_outstanding_);
+    while (outstanding > max_outstanding &&
+           !max_outstanding_.compare_exchange_weak(max_outstanding, outstanding)) {
+    }
+    if (unresponsive_.count(peer) != 0)
+      return;
+    std::vector<NodeId> reply(network_.at(peer));
+    std::sort(reply.begin(), reply.end(), [this](const NodeId& lhs, const NodeId& rhs) {
+      return NodeId::CloserToTarget(lhs, rhs, target_);
+    });
+    reply.resize(std::min(reply.size(), static_cast<size_t>(kShortlistSize_)));
+    std::weak_ptr<NodeLookup> weak_lookup(lookup_);
+    asio_service_.service().post([this, weak_lookup, peer, reply]() {
+      --outstanding_;
+      if (auto node_lookup = weak_lookup.lock())
+        node_lookup->OnResponse(peer, reply);
+    });
+  }
+
+  bool WaitForResult() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return cond_var_.wait_for(lock, std::chrono::seconds(5), [this] { return finished_; });
+  }
+
+  std::vector<NodeId> ClosestTo(const NodeId& target, const std::set<NodeId>& excluded) const {
+    std::vector<NodeId> nodes;
+    for (const auto& entry : network_) {
+      if (excluded.count(entry.first) == 0)
+        nodes.push_back(entry.first);
+    }
+    std::sort(nodes.begin(), nodes.end(), [&target](const NodeId& lhs, const NodeId& rhs) {
+      return NodeId::CloserToTarget(lhs, rhs, target);
+    });
+    return nodes;
+  }
+
+  std::vector<NodeId> Seeds(size_t count) const {
+    std::vector<NodeId> seeds;
+    auto itr(network_.begin());
+    while (seeds.size() != count)
+      seeds.push_back((itr++)->first);
+    return seeds;
+  }
+
+  const unsigned int kParallelism_, kShortlistSize_;
+  const NodeId target_;
+  AsioService asio_service_;
+  std::map<NodeId, std::vector<NodeId>> network_;
+  std::set<NodeId> unresponsive_;
+  std::mutex mutex_;
+  std::condition_variable cond_var_;
+  std::vector<NodeId> result_;
+  bool finished_;
+  std::atomic<unsigned int> outstanding_, max_outstanding_, query_count_;
+  std::shared_ptr<NodeLookup> lookup_;
+};
+
+TEST_F(NodeLookupTest, BEH_FindsClosestNodes) {
+  auto node_lookup(MakeLookup(std::chrono::seconds(5)));
+  node_lookup->Start(Seeds(3));
+  ASSERT_TRUE(WaitForResult());
+  EXPECT_TRUE(node_lookup->done());
+  ASSERT_FALSE(result_.empty());
+  EXPECT_LE(result_.size(), kShortlistSize_);
+  EXPECT_EQ(ClosestTo(target_, std::set<NodeId>()).front(), result_.front());
+  EXPECT_TRUE(std::is_sorted(result_.begin(), result_.end(),
+                             [this](const NodeId& lhs, const NodeId& rhs) {
+                               return NodeId::CloserToTarget(lhs, rhs, target_);
+                             }));
+  EXPECT_LE(max_outstanding_, kParallelism_);
+  EXPECT_LT(query_count_, network_.size());
+}
+
+TEST_F(NodeLookupTest, BEH_UnresponsiveNodesAbandoned) {
+  for (const auto& entry : network_) {
+    if (RandomUint32() % 4 == 0)
+      unresponsive_.insert(entry.first);
+  }
+  auto node_lookup(MakeLookup(std::chrono::milliseconds(100)));
+  node_lookup->Start(Seeds(kShortlistSize_));
+  ASSERT_TRUE(WaitForResult());
+  for (const auto& node : result_)
+    EXPECT_EQ(0U, unresponsive_.count(node));
+}
+
+TEST_F(NodeLookupTest, BEH_NoSeedsFinishesImmediately) {
+  auto node_lookup(MakeLookup(std::chrono::seconds(5)));
+  node_lookup->Start(std::vector<NodeId>(1, target_));
+  EXPECT_TRUE(node_lookup->done());
+  ASSERT_TRUE(WaitForResult());
+  EXPECT_TRUE(result_.empty());
+  EXPECT_EQ(0U, query_count_);
+}
+
+TEST_F(NodeLookupTest, BEH_CancelStopsLookup) {
+  unresponsive_.insert(network_.begin()->first);
+  auto node_lookup(MakeLookup(std::chrono::milliseconds(100)));
+  node_lookup->Start(Seeds(1));
+  node_lookup->Cancel();
+  EXPECT_TRUE(node_lookup->done());
+  Sleep(std::chrono::milliseconds(300));
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_FALSE(finished_);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
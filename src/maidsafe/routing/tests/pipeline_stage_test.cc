@@ -0,0 +1,94 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/pipeline_stage.h"
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(PipelineStageTest, BEH_ProcessesItemsInBatchesOnOwnThread) {
+  std::promise<void> release;
+  auto released(release.get_future().share());
+  std::mutex mutex;
+  std::vector<std::vector<int>> batches;
+  std::thread::id worker;
+  {
+    PipelineStage<int> stage(1, 100, 4, [&](std::vector<int>& batch) {
+      released.wait();
+      std::lock_guard<std::mutex> lock(mutex);
+      worker = std::this_thread::get_id();
+      batches.push_back(batch);
+    });
+    // The first item is taken straight away and holds the worker up while the rest queue.
+    int item(0);
+    ASSERT_TRUE(stage.TryPush(item));
+    Sleep(std::chrono::milliseconds(100));
+    for (item = 1; item != 10; ++item)
+      ASSERT_TRUE(stage.TryPush(item));
+    EXPECT_EQ(9U, stage.queue_depth());
+    release.set_value();
+  }  // processes what's queued before returning
+  EXPECT_NE(std::this_thread::get_id(), worker);
+  ASSERT_EQ(4U, batches.size());
+  EXPECT_EQ(std::vector<int>({0}), batches[0]);
+  EXPECT_EQ(std::vector<int>({1, 2, 3, 4}), batches[1]);
+  EXPECT_EQ(std::vector<int>({5, 6, 7, 8}), batches[2]);
+  EXPECT_EQ(std::vector<int>({9}), batches[3]);
+}
+
+TEST(PipelineStageTest, BEH_RefusesItemsWhenFullOrThreadless) {
+  std::promise<void> release;
+  auto released(release.get_future().share());
+  std::atomic<int> processed(0);
+  PipelineStage<std::string> stage(1, 2, 1, [&](std::vector<std::string>& batch) {
+    released.wait();
+    processed += static_cast<int>(batch.size());
+  });
+  std::string item("item");
+  ASSERT_TRUE(stage.TryPush(item));
+  Sleep(std::chrono::milliseconds(100));
+  item = "item";
+  EXPECT_TRUE(stage.TryPush(item));
+  item = "item";
+  EXPECT_TRUE(stage.TryPush(item));
+  item = "refused";
+  EXPECT_FALSE(stage.TryPush(item));
+  EXPECT_EQ("refused", item);
+  release.set_value();
+
+  PipelineStage<std::string> threadless(0, 2, 1, [](std::vector<std::string>&) {});
+  EXPECT_FALSE(threadless.TryPush(item));
+  EXPECT_EQ("refused", item);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
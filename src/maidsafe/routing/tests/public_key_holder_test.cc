@@ -44,14 +44,17 @@ TEST(PublicKeyHolderTest, BEH_AddFindRemoveTimeout) {
 
   EXPECT_FALSE(public_key_holder.Find(NodeId(NodeId::IdType::kRandomId)));
 
-  public_key_holder.Add(node_details.node_info.id, node_details.node_info.public_key);
+  public_key_holder.Add(node_details.node_info.id, *node_details.node_info.shared_public_key());
   EXPECT_TRUE(public_key_holder.Find(node_details.node_info.id));
+  // Each lookup shares the one handle rather than copying the key.
+  EXPECT_EQ(public_key_holder.Find(node_details.node_info.id),
+            public_key_holder.Find(node_details.node_info.id));
   EXPECT_FALSE(public_key_holder.Find(NodeId(NodeId::IdType::kRandomId)));
 
   Sleep(std::chrono::seconds(Parameters::public_key_holding_time + 1));
   EXPECT_FALSE(public_key_holder.Find(node_details.node_info.id));
 
-  public_key_holder.Add(node_details.node_info.id, node_details.node_info.public_key);
+  public_key_holder.Add(node_details.node_info.id, *node_details.node_info.shared_public_key());
   EXPECT_TRUE(public_key_holder.Find(node_details.node_info.id));
   public_key_holder.Remove(node_details.node_info.id);
   Sleep(std::chrono::seconds(1));
@@ -79,8 +82,8 @@ TEST(PublicKeyHolderTest, BEH_MultipleAddFindRemove) {
     futures.emplace_back(
         std::async(std::launch::async,
                    [index, &public_key_holder, &nodes_details]() {
-                     return public_key_holder.Add(nodes_details.at(index).node_info.id,
-                                                  nodes_details.at(index).node_info.public_key);
+                     const NodeInfo& node_info(nodes_details.at(index).node_info);
+                     return public_key_holder.Add(node_info.id, *node_info.shared_public_key());
                    }));
 
   for (auto& future : futures)
@@ -156,8 +159,8 @@ TEST(PublicKeyHolderTest, BEH_MultipleAddFindTimeout) {
     futures.emplace_back(
         std::async(std::launch::async,
                    [index, &public_key_holder, &nodes_details]() {
-                     return public_key_holder.Add(nodes_details.at(index).node_info.id,
-                                                  nodes_details.at(index).node_info.public_key);
+                     const NodeInfo& node_info(nodes_details.at(index).node_info);
+                     return public_key_holder.Add(node_info.id, *node_info.shared_public_key());
                    }));
 
   for (auto& future : futures)
@@ -199,6 +202,45 @@ TEST(PublicKeyHolderTest, BEH_MultipleAddFindTimeout) {
     EXPECT_FALSE(future.get());
 }
 
+TEST(PublicKeyHolderTest, FUNC_AddFindCostAtTenThousandPeers) {
+  AsioService asio_service(1);
+  auto node_details(MakeNodeInfoAndKeysWithPmid(passport::CreatePmidAndSigner().first));
+  RoutingTable routing_table(false, node_details.node_info.id, asymm::Keys());
+  ClientRoutingTable client_routing_table(node_details.node_info.id);
+  Acknowledgement acknowledgment(node_details.node_info.id, asio_service);
+  Network network(routing_table, client_routing_table, acknowledgment);
+  PublicKeyHolder public_key_holder(asio_service, network);
+  const size_t kPeers(10000);
+  std::vector<NodeId> peers;
+  for (size_t index(0); index < kPeers; ++index)
+    peers.emplace_back(NodeId::IdType::kRandomId);
+
+  // The holder doesn't inspect the keys, so a single key serves for every peer.
+  auto start(std::chrono::steady_clock::now());
+  for (const auto& peer : peers)
+    EXPECT_TRUE(public_key_holder.Add(peer, *node_details.node_info.shared_public_key()));
+  auto added(std::chrono::steady_clock::now());
+  for (const auto& peer : peers)
+    EXPECT_TRUE(public_key_holder.Find(peer));
+  auto found(std::chrono::steady_clock::now());
+  EXPECT_EQ(kPeers, public_key_holder.size());
+
+  typedef std::chrono::duration<double, std::micro> Micro;
+  LOG(kInfo) << "At " << kPeers << " pending peers - Add: "
+             << Micro(added - start).count() / kPeers << " us, Find: "
+             << Micro(found - added).count() / kPeers << " us";
+
+  // Removing an unknown peer is a no-op and a duplicate Add is rejected.
+  public_key_holder.Remove(NodeId(NodeId::IdType::kRandomId));
+  EXPECT_FALSE(public_key_holder.Add(peers.front(), *node_details.node_info.shared_public_key()));
+  public_key_holder.Remove(peers.front());
+  EXPECT_FALSE(public_key_holder.Find(peers.front()));
+  EXPECT_EQ(kPeers - 1, public_key_holder.size());
+
+  Sleep(std::chrono::seconds(Parameters::public_key_holding_time + 1));
+  EXPECT_EQ(0U, public_key_holder.size());
+}
+
 }  // namespace test
 
 }  // namespace routing
@@ -0,0 +1,128 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/public_key_request_batcher.h"
+
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+
+#include "maidsafe/routing/parameters.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+class PublicKeyRequestBatcherTest : public testing::Test {
+ protected:
+  PublicKeyRequestBatcherTest()
+      : kBatchWindow_(Parameters::public_key_request_batch_window),
+        kMaxBatchSize_(Parameters::max_public_key_request_batch_size),
+        asio_service_(1),
+        batcher_(std::make_shared<PublicKeyRequestBatcher>(asio_service_)),
+        mutex_(),
+        batches_(),
+        replies_() {
+    Parameters::public_key_request_batch_window = std::chrono::milliseconds(100);
+    batcher_->set_request_public_keys_functor([this](std::vector<NodeId> peers,
+                                                     GivePublicKeysFunctor give_public_keys) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      batches_.push_back(peers);
+      replies_.push_back(give_public_keys);
+    });
+  }
+
+  ~PublicKeyRequestBatcherTest() {
+    Parameters::public_key_request_batch_window = kBatchWindow_;
+    Parameters::max_public_key_request_batch_size = kMaxBatchSize_;
+  }
+
+  GivePublicKeyFunctor Recorder(std::atomic<int>& given_count, std::atomic<int>& missing_count) {
+    return [&given_count, &missing_count](boost::optional<asymm::PublicKey> public_key) {
+      if (public_key)
+        ++given_count;
+      else
+        ++missing_count;
+    };
+  }
+
+  const std::chrono::steady_clock::duration kBatchWindow_;
+  const unsigned int kMaxBatchSize_;
+  AsioService asio_service_;
+  std::shared_ptr<PublicKeyRequestBatcher> batcher_;
+  std::mutex mutex_;
+  std::vector<std::vector<NodeId>> batches_;
+  std::vector<GivePublicKeysFunctor> replies_;
+};
+
+TEST_F(PublicKeyRequestBatcherTest, BEH_RequestsInWindowShareOneCall) {
+  NodeId peer1(NodeId::IdType::kRandomId), peer2(NodeId::IdType::kRandomId);
+  std::atomic<int> given_count(0), missing_count(0);
+  auto request_public_key(batcher_->GetRequestPublicKeyFunctor());
+  request_public_key(peer1, Recorder(given_count, missing_count));
+  request_public_key(peer2, Recorder(given_count, missing_count));
+  request_public_key(peer1, Recorder(given_count, missing_count));
+
+  Sleep(std::chrono::milliseconds(500));
+  std::lock_guard<std::mutex> lock(mutex_);
+  ASSERT_EQ(1U, batches_.size());
+  EXPECT_EQ(2U, batches_.front().size());
+
+  // Only peer1's key is given, so both of its waiters get the key and peer2's waiter gets none.
+  std::vector<std::pair<NodeId, asymm::PublicKey>> public_keys;
+  public_keys.emplace_back(peer1, asymm::GenerateKeyPair().public_key);
+  replies_.front()(public_keys);
+  EXPECT_EQ(2, given_count.load());
+  EXPECT_EQ(1, missing_count.load());
+
+  // Further replies for the same batch are ignored.
+  replies_.front()(public_keys);
+  EXPECT_EQ(2, given_count.load());
+  EXPECT_EQ(1, missing_count.load());
+}
+
+TEST_F(PublicKeyRequestBatcherTest, BEH_FullBatchSentImmediately) {
+  Parameters::max_public_key_request_batch_size = 3;
+  Parameters::public_key_request_batch_window = std::chrono::seconds(10);
+  std::atomic<int> given_count(0), missing_count(0);
+  for (int i(0); i != 3; ++i)
+    batcher_->Request(NodeId(NodeId::IdType::kRandomId), Recorder(given_count, missing_count));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ASSERT_EQ(1U, batches_.size());
+    EXPECT_EQ(3U, batches_.front().size());
+    replies_.front()(std::vector<std::pair<NodeId, asymm::PublicKey>>());
+  }
+  EXPECT_EQ(0, given_count.load());
+  EXPECT_EQ(3, missing_count.load());
+
+  // The next request starts a new batch.
+  batcher_->Request(NodeId(NodeId::IdType::kRandomId), Recorder(given_count, missing_count));
+  std::lock_guard<std::mutex> lock(mutex_);
+  EXPECT_EQ(1U, batches_.size());
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
@@ -131,6 +131,69 @@ TEST(APITest, BEH_API_ZeroState) {
   LOG(kInfo) << "done!!!";
 }
 
+TEST(APITest, BEH_API_SharedAsioService) {
+  Endpoint endpoint1(maidsafe::GetLocalIp(), maidsafe::test::GetRandomPort()),
+    endpoint2(maidsafe::GetLocalIp(), maidsafe::test::GetRandomPort());
+  ScopedBootstrapFile bootstrap_file({ endpoint1, endpoint2 });
+
+  auto pmid1(passport::CreatePmidAndSigner().first), pmid2(passport::CreatePmidAndSigner().first),
+    pmid3(passport::CreatePmidAndSigner().first);
+  NodeInfoAndPrivateKey node1(MakeNodeInfoAndKeysWithPmid(pmid1));
+  NodeInfoAndPrivateKey node2(MakeNodeInfoAndKeysWithPmid(pmid2));
+  std::map<NodeId, asymm::PublicKey> key_map;
+  key_map.insert(std::make_pair(node1.node_info.id, pmid1.public_key()));
+  key_map.insert(std::make_pair(node2.node_info.id, pmid2.public_key()));
+  key_map.insert(std::make_pair(NodeId(pmid3.name()->string()), pmid3.public_key()));
+
+  // All three nodes run on one two-threaded service; the third also overrides its table size.
+  RoutingOptions options;
+  options.asio_service = std::make_shared<AsioService>(2);
+  RoutingOptions small_table_options(options);
+  small_table_options.max_routing_table_size = 8;
+  small_table_options.routing_table_size_threshold = 4;
+
+  Functors functors1, functors2, functors3;
+  {
+    Routing routing1(pmid1, options);
+    Routing routing2(pmid2, options);
+    Routing routing3(pmid3, small_table_options);
+
+    functors1.network_status = [](int) {};  // NOLINT
+    functors1.message_and_caching.message_received = no_ops_message_received_functor;
+    functors1.request_public_key = [&](const NodeId& node_id, GivePublicKeyFunctor give_key) {
+      auto itr(key_map.find(node_id));
+      if (key_map.end() != itr)
+        give_key((*itr).second);
+    };
+    functors3 = functors2 = functors1;
+
+    auto a1 = boost::async(boost::launch::async, [&] {
+      return routing1.ZeroStateJoin(functors1, endpoint1, endpoint2, node2.node_info);
+    });
+    auto a2 = boost::async(boost::launch::async, [&] {
+      return routing2.ZeroStateJoin(functors2, endpoint2, endpoint1, node1.node_info);
+    });
+    EXPECT_EQ(kSuccess, a2.get());
+    EXPECT_EQ(kSuccess, a1.get());
+
+    std::once_flag flag;
+    boost::promise<void> join_promise;
+    auto join_future = join_promise.get_future();
+    functors3.network_status = [&flag, &join_promise](int result) {
+      // Health is relative to the overridden table size of 8, i.e. 2 peers give 25%.
+      if (result == 2 * 100 / 8)
+        std::call_once(flag, [&join_promise]() { join_promise.set_value(); });
+    };
+    routing3.Join(functors3);
+    ASSERT_EQ(join_future.wait_for(boost::chrono::seconds(5)), boost::future_status::ready);
+  }
+  // Destroying the Routing objects must leave the shared service usable.
+  std::promise<void> posted;
+  options.asio_service->service().post([&posted] { posted.set_value(); });
+  EXPECT_EQ(std::future_status::ready, posted.get_future().wait_for(std::chrono::seconds(1)));
+  options.asio_service->Stop();
+}
+
 TEST(APITest, BEH_API_GetPublicKeyFailure) {
   Endpoint endpoint1(maidsafe::GetLocalIp(), maidsafe::test::GetRandomPort()),
     endpoint2(maidsafe::GetLocalIp(), maidsafe::test::GetRandomPort());
@@ -512,6 +512,59 @@ TEST_F(RoutingNetworkTest, FUNC_NonexistentIsConnectedVaultOrClient) {
   }
 }
 
+TEST_F(RoutingNetworkTest, FUNC_ParallelLookupTimeToReady) {
+  // Compares how long joining vaults take to fill their routing tables using single routed
+  // FindNodes requests and using parallel lookups (see NodeLookup).
+  const unsigned int kParallelism(Parameters::find_nodes_parallelism);
+  auto mean_time_to_ready([this](unsigned int parallelism) -> std::chrono::milliseconds {
+    Parameters::find_nodes_parallelism = parallelism;
+    const int kRepeats(3);
+    std::chrono::steady_clock::duration total(std::chrono::steady_clock::duration::zero());
+    for (int i(0); i != kRepeats; ++i) {
+      env_->AddNode(false);
+      auto node(env_->nodes_.at(env_->ClientIndex() - 1));
+      EXPECT_NE(std::chrono::steady_clock::duration::zero(), node->time_to_ready());
+      total += node->time_to_ready();
+      EXPECT_TRUE(env_->RemoveNode(node->node_id()));
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(total / kRepeats);
+  });
+  auto serial(mean_time_to_ready(0));
+  auto parallel(mean_time_to_ready(kParallelism == 0 ? 3 : kParallelism));
+  Parameters::find_nodes_parallelism = kParallelism;
+  LOG(kInfo) << "Mean time to ready : " << serial.count() << " ms serial, " << parallel.count()
+             << " ms parallel.";
+  RecordProperty("serial_time_to_ready_ms", static_cast<int>(serial.count()));
+  RecordProperty("parallel_time_to_ready_ms", static_cast<int>(parallel.count()));
+}
+
+TEST_F(RoutingNetworkTest, FUNC_RoutingTableTransferTimeToReady) {
+  // Compares how long joining vaults take to fill their routing tables with and without asking
+  // for the closest node's routing table on joining.
+  const bool kRequestRoutingTable(Parameters::request_routing_table_on_join);
+  auto mean_time_to_ready([this](bool request_routing_table) -> std::chrono::milliseconds {
+    Parameters::request_routing_table_on_join = request_routing_table;
+    const int kRepeats(3);
+    std::chrono::steady_clock::duration total(std::chrono::steady_clock::duration::zero());
+    for (int i(0); i != kRepeats; ++i) {
+      env_->AddNode(false);
+      auto node(env_->nodes_.at(env_->ClientIndex() - 1));
+      EXPECT_NE(std::chrono::steady_clock::duration::zero(), node->time_to_ready());
+      total += node->time_to_ready();
+      EXPECT_TRUE(env_->RemoveNode(node->node_id()));
+    }
+    return std::chrono::duration_cast<std::chrono::milliseconds>(total / kRepeats);
+  });
+  auto without_transfer(mean_time_to_ready(false));
+  auto with_transfer(mean_time_to_ready(true));
+  Parameters::request_routing_table_on_join = kRequestRoutingTable;
+  LOG(kInfo) << "Mean time to ready : " << without_transfer.count() << " ms without, "
+             << with_transfer.count() << " ms with routing table transfer.";
+  RecordProperty("time_to_ready_without_transfer_ms",
+                 static_cast<int>(without_transfer.count()));
+  RecordProperty("time_to_ready_with_transfer_ms", static_cast<int>(with_transfer.count()));
+}
+
 }  // namespace test
 
 }  // namespace routing
@@ -83,7 +83,9 @@ GenericNode::GenericNode(bool has_symmetric_nat)
       endpoint_(),
       messages_(),
       routing_(),
-      health_(0) {
+      health_(0),
+      join_time_(),
+      time_to_ready_() {
   node_info_plus_.reset(new NodeInfoAndPrivateKey(MakeNodeInfoAndKeys()));
   routing_.reset(new Routing());  // FIXME Prakash
   node_info_plus_->node_info.id = routing_->kNodeId();
@@ -108,7 +110,9 @@ GenericNode::GenericNode(bool client_mode, const rudp::NatType& nat_type)
       endpoint_(),
       messages_(),
       routing_(),
-      health_(0) {
+      health_(0),
+      join_time_(),
+      time_to_ready_() {
   if (client_mode) {
     auto maid(passport::CreateMaidAndSigner().first);
     node_info_plus_.reset(new NodeInfoAndPrivateKey(MakeNodeInfoAndKeysWithMaid(maid)));
@@ -127,7 +131,8 @@ GenericNode::GenericNode(bool client_mode, const rudp::NatType& nat_type)
   id_ = next_node_id_++;
 }
 
-GenericNode::GenericNode(const passport::Pmid& pmid, bool has_symmetric_nat)
+GenericNode::GenericNode(const passport::Pmid& pmid, bool has_symmetric_nat,
+                         const RoutingOptions& options)
     : functors_(),
       id_(0),
       node_info_plus_(std::make_shared<NodeInfoAndPrivateKey>(MakeNodeInfoAndKeysWithFob(pmid))),
@@ -141,17 +146,20 @@ GenericNode::GenericNode(const passport::Pmid& pmid, bool has_symmetric_nat)
       endpoint_(),
       messages_(),
       routing_(),
-      health_(0) {
+      health_(0),
+      join_time_(),
+      time_to_ready_() {
   endpoint_.address(GetLocalIp());
   endpoint_.port(maidsafe::test::GetRandomPort());
   InitialiseFunctors();
-  routing_.reset(new Routing(pmid));
+  routing_.reset(new Routing(pmid, options));
   LOG(kVerbose) << "Node constructor";
   std::lock_guard<std::mutex> lock(mutex_);
   id_ = next_node_id_++;
 }
 
-GenericNode::GenericNode(const passport::Maid& maid, bool has_symmetric_nat)
+GenericNode::GenericNode(const passport::Maid& maid, bool has_symmetric_nat,
+                         const RoutingOptions& options)
     : functors_(),
       id_(0),
       node_info_plus_(std::make_shared<NodeInfoAndPrivateKey>(MakeNodeInfoAndKeysWithFob(maid))),
@@ -165,11 +173,13 @@ GenericNode::GenericNode(const passport::Maid& maid, bool has_symmetric_nat)
       endpoint_(),
       messages_(),
       routing_(),
-      health_(0) {
+      health_(0),
+      join_time_(),
+      time_to_ready_() {
   endpoint_.address(GetLocalIp());
   endpoint_.port(maidsafe::test::GetRandomPort());
   InitialiseFunctors();
-  routing_.reset(new Routing(maid));
+  routing_.reset(new Routing(maid, options));
   LOG(kVerbose) << "Node constructor";
   std::lock_guard<std::mutex> lock(mutex_);
   id_ = next_node_id_++;
@@ -318,7 +328,14 @@ int GenericNode::ZeroStateJoin(const Endpoint& peer_endpoint, const NodeInfo& pe
   return routing_->ZeroStateJoin(functors_, endpoint(), peer_endpoint, peer_node_info);
 }
 
-void GenericNode::Join() { routing_->Join(functors_); }
+void GenericNode::Join() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    join_time_ = std::chrono::steady_clock::now();
+    time_to_ready_ = std::chrono::steady_clock::duration::zero();
+  }
+  routing_->Join(functors_);
+}
 
 void GenericNode::set_joined(const bool node_joined) { joined_ = node_joined; }
 
@@ -375,7 +392,7 @@ passport::Maid GenericNode::GetMaid() {
 
 asymm::PublicKey GenericNode::public_key() {
   std::lock_guard<std::mutex> lock(mutex_);
-  return node_info_plus_->node_info.public_key;
+  return *node_info_plus_->node_info.shared_public_key();
 }
 
 int GenericNode::Health() {
@@ -384,18 +401,31 @@ int GenericNode::Health() {
 
 void GenericNode::SetHealth(int health) {
   health_ = health;
+  std::lock_guard<std::mutex> lock(mutex_);
+  const int kReadyHealth(std::min(
+      static_cast<int>(expected_),
+      NetworkStatus(client_mode_, static_cast<int>(Parameters::routing_table_ready_to_response))));
+  if (time_to_ready_ == std::chrono::steady_clock::duration::zero() && health >= kReadyHealth) {
+    time_to_ready_ = std::chrono::steady_clock::now() - join_time_;
+  }
+}
+
+std::chrono::steady_clock::duration GenericNode::time_to_ready() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return time_to_ready_;
 }
 
 void GenericNode::PostTaskToAsioService(std::function<void()> functor) {
   std::lock_guard<std::mutex> lock(routing_->pimpl_->running_mutex_);
   if (routing_->pimpl_->running_)
-    routing_->pimpl_->asio_service_.service().post(functor);
+    routing_->pimpl_->asio_service_->service().post(functor);
 }
 
 rudp::NatType GenericNode::nat_type() { return routing_->pimpl_->network_->nat_type(); }
 
 GenericNetwork::GenericNetwork()
-    : mutex_(),
+    : shared_asio_service_(),
+      mutex_(),
       fobs_mutex_(),
       public_keys_(),
       client_index_(0),
@@ -417,8 +447,8 @@ GenericNetwork::~GenericNetwork() {
 }
 
 void GenericNetwork::SetUp() {
-  NodePtr node1(new GenericNode(passport::CreatePmidAndSigner().first)),
-      node2(new GenericNode(passport::CreatePmidAndSigner().first));
+  NodePtr node1(new GenericNode(passport::CreatePmidAndSigner().first, false, NodeOptions())),
+      node2(new GenericNode(passport::CreatePmidAndSigner().first, false, NodeOptions()));
   nodes_.push_back(node1);
   nodes_.push_back(node2);
   bootstrap_file_.reset();
@@ -484,27 +514,27 @@ void GenericNetwork::SetUpNetwork(size_t total_number_vaults, size_t total_numbe
   size_t num_nonsym_nat_clients(total_number_clients - num_symmetric_nat_clients);
 
   for (size_t index(2); index < num_nonsym_nat_vaults; ++index) {
-    NodePtr node(new GenericNode(passport::CreatePmidAndSigner().first));
+    NodePtr node(new GenericNode(passport::CreatePmidAndSigner().first, false, NodeOptions()));
     AddNodeDetails(node);
     LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
     //      node->PrintRoutingTable();
   }
 
   for (size_t index(0); index < num_symmetric_nat_vaults; ++index) {
-    NodePtr node(new GenericNode(passport::CreatePmidAndSigner().first, true));
+    NodePtr node(new GenericNode(passport::CreatePmidAndSigner().first, true, NodeOptions()));
     AddNodeDetails(node);
     LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
     //      node->PrintRoutingTable();
   }
 
   for (size_t index(0); index < num_nonsym_nat_clients; ++index) {
-    NodePtr node(new GenericNode(passport::CreateMaidAndSigner().first));
+    NodePtr node(new GenericNode(passport::CreateMaidAndSigner().first, false, NodeOptions()));
     AddNodeDetails(node);
     LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
   }
 
   for (size_t index(0); index < num_symmetric_nat_clients; ++index) {
-    NodePtr node(new GenericNode(passport::CreateMaidAndSigner().first, true));
+    NodePtr node(new GenericNode(passport::CreateMaidAndSigner().first, true, NodeOptions()));
     AddNodeDetails(node);
     LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
   }
@@ -518,10 +548,10 @@ void GenericNetwork::AddNode(bool client_mode, CloseNodesChangeFunctor close_nod
   NodePtr node;
   if (client_mode) {
     auto maid(passport::CreateMaidAndSigner().first);
-    node.reset(new GenericNode(maid));
+    node.reset(new GenericNode(maid, false, NodeOptions()));
   } else {
     auto pmid(passport::CreatePmidAndSigner().first);
-    node.reset(new GenericNode(pmid, false));
+    node.reset(new GenericNode(pmid, false, NodeOptions()));
   }
   node->SetCloseNodesChangeFunctor(close_nodes_change_functor);
   AddNodeDetails(node);
@@ -530,13 +560,13 @@ void GenericNetwork::AddNode(bool client_mode, CloseNodesChangeFunctor close_nod
 
 void GenericNetwork::AddNode(const passport::Maid& maid, bool has_symmetric_nat) {
   NodePtr node;
-  node.reset(new GenericNode(maid, has_symmetric_nat));
+  node.reset(new GenericNode(maid, has_symmetric_nat, NodeOptions()));
   AddNodeDetails(node);
   LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
 }
 void GenericNetwork::AddNode(const passport::Pmid& pmid, bool has_symmetric_nat) {
   NodePtr node;
-  node.reset(new GenericNode(pmid, has_symmetric_nat));
+  node.reset(new GenericNode(pmid, has_symmetric_nat, NodeOptions()));
   AddNodeDetails(node);
   LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
 }
@@ -559,7 +589,7 @@ void GenericNetwork::AddVault(bool has_symmetric_nat) {
 void GenericNetwork::AddNode(const passport::Maid& maid,
                              CloseNodesChangeFunctor close_nodes_change_functor) {
   NodePtr node;
-  node.reset(new GenericNode(maid));
+  node.reset(new GenericNode(maid, false, NodeOptions()));
   node->SetCloseNodesChangeFunctor(close_nodes_change_functor);
   AddNodeDetails(node);
   LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
@@ -568,7 +598,7 @@ void GenericNetwork::AddNode(const passport::Maid& maid,
 void GenericNetwork::AddNode(const passport::Pmid& pmid,
                              CloseNodesChangeFunctor close_nodes_change_functor) {
   NodePtr node;
-  node.reset(new GenericNode(pmid, false));
+  node.reset(new GenericNode(pmid, false, NodeOptions()));
   node->SetCloseNodesChangeFunctor(close_nodes_change_functor);
   AddNodeDetails(node);
   LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
@@ -591,9 +621,11 @@ void GenericNetwork::AddNode(bool client_mode, const rudp::NatType& nat_type) {
 void GenericNetwork::AddNode(bool client_mode, bool has_symmetric_nat) {
   NodePtr node;
   if (client_mode)
-    node.reset(new GenericNode(passport::CreateMaidAndSigner().first, has_symmetric_nat));
+    node.reset(new GenericNode(passport::CreateMaidAndSigner().first, has_symmetric_nat,
+                               NodeOptions()));
   else
-    node.reset(new GenericNode(passport::CreatePmidAndSigner().first, has_symmetric_nat));
+    node.reset(new GenericNode(passport::CreatePmidAndSigner().first, has_symmetric_nat,
+                               NodeOptions()));
   AddNodeDetails(node);
   LOG(kVerbose) << "Node # " << nodes_.size() << " added to network";
   //    node->PrintRoutingTable();
@@ -1344,6 +1376,17 @@ void GenericNetwork::AddPublicKey(const NodeId& node_id, const asymm::PublicKey&
   public_keys_.insert(std::make_pair(node_id, public_key));
 }
 
+void GenericNetwork::ShareAsioService(unsigned int thread_count) {
+  assert(nodes_.empty() && "Must be called before any node is created");
+  shared_asio_service_ = std::make_shared<AsioService>(thread_count);
+}
+
+RoutingOptions GenericNetwork::NodeOptions() const {
+  RoutingOptions options;
+  options.asio_service = shared_asio_service_;
+  return options;
+}
+
 unsigned int GenericNetwork::NonClientNonSymmetricNatNodesSize() const {
   unsigned int non_client_non_sym_size(0);
   for (const auto& node : nodes_) {
@@ -139,8 +139,8 @@ void RoutingTableNetwork::AddNode(std::shared_ptr<RoutingTableInfo> lhs,
   NodeInfo lhs_node_info, rhs_node_info;
   lhs_node_info.id = lhs->routing_table->kNodeId();
   rhs_node_info.id = rhs->routing_table->kNodeId();
-  lhs_node_info.public_key = lhs->pmid.public_key();
-  rhs_node_info.public_key = rhs->pmid.public_key();
+  lhs_node_info.set_public_key(lhs->pmid.public_key());
+  rhs_node_info.set_public_key(rhs->pmid.public_key());
   if (lhs->routing_table->CheckNode(rhs_node_info) &&
       rhs->routing_table->CheckNode(lhs_node_info)) {
     lhs->routing_table->AddNode(rhs_node_info);
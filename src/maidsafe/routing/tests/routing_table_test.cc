@@ -16,6 +16,7 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <algorithm>
 #include <bitset>
 #include <memory>
 #include <vector>
@@ -54,7 +55,7 @@ TEST(RoutingTableTest, BEH_AddCloseNodes) {
   // check we cannot input nodes with invalid public_keys
   for (unsigned int i = 0; i < Parameters::closest_nodes_size; ++i) {
     NodeInfo node(MakeNode());
-    node.public_key = dummy_key;
+    node.set_public_key(dummy_key);
     EXPECT_FALSE(routing_table.AddNode(node));
   }
   EXPECT_EQ(0, routing_table.size());
@@ -110,6 +111,106 @@ TEST(RoutingTableTest, BEH_GetNthClosest) {
   }
 }
 
+TEST(RoutingTableTest, BEH_QueriesShareStoredPublicKeys) {
+  NodeId node_id(NodeId::IdType::kRandomId);
+  RoutingTable routing_table(false, node_id, asymm::GenerateKeyPair());
+  std::vector<NodeInfo> added;
+  while (routing_table.size() < Parameters::closest_nodes_size) {
+    NodeInfo node(MakeNode());
+    EXPECT_TRUE(routing_table.AddNode(node));
+    added.push_back(node);
+  }
+
+  auto stored_key([&added](const NodeInfo& node_info) {
+    return std::find_if(added.begin(), added.end(), [&node_info](const NodeInfo& node) {
+      return node.id == node_info.id;
+    })->shared_public_key().get();
+  });
+  for (const auto& node_info : routing_table.GetClosestNodes(node_id, 4))
+    EXPECT_EQ(stored_key(node_info), node_info.shared_public_key().get());
+  NodeInfo closest(routing_table.GetClosestNode(node_id));
+  EXPECT_EQ(stored_key(closest), closest.shared_public_key().get());
+  NodeInfo found;
+  EXPECT_TRUE(routing_table.GetNodeInfo(added.front().id, found));
+  EXPECT_EQ(added.front().shared_public_key().get(), found.shared_public_key().get());
+}
+
+TEST(RoutingTableTest, BEH_DuplicatePublicKeyRejectedUntilDropped) {
+  NodeId node_id(NodeId::IdType::kRandomId);
+  RoutingTable routing_table(false, node_id, asymm::GenerateKeyPair());
+  NodeInfo node(MakeNode());
+  EXPECT_TRUE(routing_table.AddNode(node));
+
+  // A different node holding an equal (but separately allocated) key is rejected.
+  NodeInfo duplicate(MakeNode());
+  duplicate.set_public_key(*node.shared_public_key());
+  EXPECT_FALSE(routing_table.AddNode(duplicate));
+  EXPECT_EQ(1U, routing_table.size());
+
+  // Once the original holder of the key has gone, the key may be reused.
+  routing_table.DropNode(node.id, true);
+  EXPECT_TRUE(routing_table.AddNode(duplicate));
+  EXPECT_FALSE(routing_table.AddNode(node));
+  EXPECT_EQ(1U, routing_table.size());
+
+  // An invalid key is never accepted.
+  NodeInfo invalid(MakeNode());
+  invalid.set_public_key(asymm::PublicKey());
+  EXPECT_FALSE(routing_table.AddNode(invalid));
+}
+
+TEST(RoutingTableTest, BEH_DropNodesReportsOneChange) {
+  NodeId node_id(NodeId::IdType::kRandomId);
+  RoutingTable routing_table(false, node_id, asymm::GenerateKeyPair());
+  std::vector<NodeId> added;
+  while (routing_table.size() < Parameters::closest_nodes_size * 2) {
+    NodeInfo node(MakeNode());
+    EXPECT_TRUE(routing_table.AddNode(node));
+    added.push_back(node.id);
+  }
+  std::sort(added.begin(), added.end(), [&node_id](const NodeId& lhs, const NodeId& rhs) {
+    return NodeId::CloserToTarget(lhs, rhs, node_id);
+  });
+
+  int change_count(0);
+  RoutingTableChange last_change;
+  routing_table.InitialiseFunctors([&](const RoutingTableChange& routing_table_change) {
+    ++change_count;
+    last_change = routing_table_change;
+  });
+
+  // Drop the three closest nodes along with one unknown id in a single call.
+  std::vector<NodeId> to_drop(added.begin(), added.begin() + 3);
+  to_drop.push_back(NodeId(NodeId::IdType::kRandomId));
+  auto dropped(routing_table.DropNodes(to_drop, true));
+  EXPECT_EQ(3U, dropped.size());
+  EXPECT_EQ(Parameters::closest_nodes_size * 2 - 3, routing_table.size());
+  ASSERT_EQ(1, change_count);
+  EXPECT_TRUE(last_change.removed.node.id.IsZero());
+  ASSERT_EQ(3U, last_change.removed_nodes.size());
+  for (const auto& removed : last_change.removed_nodes) {
+    EXPECT_NE(to_drop.begin() + 3,
+              std::find(to_drop.begin(), to_drop.begin() + 3, removed.node.id));
+    EXPECT_TRUE(removed.routing_only_removal);
+  }
+  ASSERT_TRUE(last_change.close_nodes_change != nullptr);
+  EXPECT_EQ(added.front(), last_change.close_nodes_change->lost_node());
+  EXPECT_EQ(added.at(Parameters::closest_nodes_size),
+            last_change.close_nodes_change->new_node());
+  std::vector<NodeId> expected_close(added.begin() + 3,
+                                     added.begin() + 3 + Parameters::closest_nodes_size);
+  EXPECT_EQ(expected_close, last_change.close_nodes_change->new_close_nodes());
+  EXPECT_EQ(std::vector<NodeId>(added.begin(), added.begin() + 3),
+            last_change.close_nodes_change->lost_nodes());
+  EXPECT_EQ(std::vector<NodeId>(added.begin() + Parameters::closest_nodes_size,
+                                added.begin() + Parameters::closest_nodes_size + 3),
+            last_change.close_nodes_change->new_nodes());
+
+  // Nothing held, nothing reported.
+  EXPECT_TRUE(routing_table.DropNodes(to_drop, true).empty());
+  EXPECT_EQ(1, change_count);
+}
+
 TEST(RoutingTableTest, FUNC_GetClosestNodeWithExclusion) {
   NodeId node_id(NodeId::IdType::kRandomId);
   RoutingTable routing_table(false, node_id, asymm::GenerateKeyPair());
@@ -203,6 +304,44 @@ TEST(RoutingTableTest, FUNC_GetClosestNodeWithExclusion) {
   EXPECT_EQ(node_info.id, NodeInfo().id);
 }
 
+TEST(RoutingTableTest, BEH_GetClosestNodesIntoBuffer) {
+  NodeId node_id(NodeId::IdType::kRandomId);
+  RoutingTable routing_table(false, node_id, asymm::GenerateKeyPair());
+  FixedCapacityBuffer<NodeInfo, 4> closest;
+  routing_table.GetClosestNodes(node_id, 4, false, closest);
+  EXPECT_TRUE(closest.empty());
+
+  while (routing_table.size() < Parameters::closest_nodes_size)
+    EXPECT_TRUE(routing_table.AddNode(MakeNode()));
+  auto expected(routing_table.GetClosestNodes(node_id, 8));
+  routing_table.GetClosestNodes(node_id, 8, false, closest);
+  ASSERT_EQ(4U, closest.size());
+  for (size_t index(0); index != closest.size(); ++index)
+    EXPECT_EQ(expected[index].id, closest[index].id);
+
+  // The buffer is refilled, not appended to.
+  auto expected_excluding_target(routing_table.GetClosestNodes(expected[0].id, 2, true));
+  routing_table.GetClosestNodes(expected[0].id, 2, true, closest);
+  ASSERT_EQ(2U, closest.size());
+  EXPECT_EQ(expected_excluding_target[0].id, closest[0].id);
+  EXPECT_EQ(expected_excluding_target[1].id, closest[1].id);
+
+  NodeIdExclusion exclude;
+  NodeInfo closest_node;
+  EXPECT_TRUE(routing_table.GetClosestNode(node_id, false, exclude, closest_node));
+  EXPECT_EQ(expected[0].id, closest_node.id);
+  exclude.push_back(expected[0].id);
+  exclude.push_back(expected[1].id);
+  EXPECT_TRUE(routing_table.GetClosestNode(node_id, false, exclude, closest_node));
+  EXPECT_EQ(expected[2].id, closest_node.id);
+  exclude.clear();
+  for (const auto& node_info : routing_table.GetClosestNodes(node_id,
+                                                             Parameters::closest_nodes_size))
+    exclude.push_back(node_info.id);
+  EXPECT_FALSE(routing_table.GetClosestNode(node_id, false, exclude, closest_node));
+  EXPECT_EQ(expected[2].id, closest_node.id);
+}
+
 TEST(RoutingTableTest, FUNC_ClosestToId) {
   NodeId own_node_id(NodeId::IdType::kRandomId);
   RoutingTable routing_table(false, own_node_id, asymm::GenerateKeyPair());
@@ -16,6 +16,8 @@
     See the Licences for the specific language governing permissions and limitations relating to
     use of the MaidSafe Software.                                                                 */
 
+#include <algorithm>
+#include <limits>
 #include <memory>
 #include <vector>
 
@@ -26,6 +28,7 @@
 #include "maidsafe/rudp/managed_connections.h"
 
 #include "maidsafe/routing/client_routing_table.h"
+#include "maidsafe/routing/message_handler.h"
 #include "maidsafe/routing/network_statistics.h"
 #include "maidsafe/routing/network.h"
 #include "maidsafe/routing/parameters.h"
@@ -110,6 +113,46 @@ TEST(ServicesTest, BEH_FindNodes) {
   // EXPECT_FALSE(message.has_relay());
 }
 
+TEST(ServicesTest, BEH_FindNodesForWholeRoutingTable) {
+  NodeId node_id(NodeId::IdType::kRandomId);
+  RoutingTable routing_table(false, node_id, asymm::GenerateKeyPair());
+  std::vector<NodeId> held;
+  while (routing_table.size() < Parameters::closest_nodes_size * 2) {
+    NodeInfo node(MakeNode());
+    EXPECT_TRUE(routing_table.AddNode(node));
+    held.push_back(node.id);
+  }
+  ClientRoutingTable client_routing_table(routing_table.kNodeId());
+  AsioService asio_service(1);
+  Acknowledgement acknowledgement(node_id, asio_service);
+  Network network(routing_table, client_routing_table, acknowledgement);
+  PublicKeyHolder public_key_holder(asio_service, network);
+  Service service(routing_table, client_routing_table, network, public_key_holder);
+  // As sent by a joining node: the requester is one of the held nodes, so should be left out of
+  // the response.
+  protobuf::Message message =
+      rpcs::FindNodes(held.front(), held.front(), static_cast<int>(routing_table.kMaxSize()) + 1);
+  service.FindNodes(message);
+  protobuf::FindNodesResponse find_nodes_response;
+  ASSERT_TRUE(find_nodes_response.ParseFromString(message.data(0)));
+  ASSERT_EQ(static_cast<int>(held.size()), find_nodes_response.nodes_size());
+  EXPECT_EQ(node_id.string(), find_nodes_response.nodes(0));
+  for (auto itr(held.begin() + 1); itr != held.end(); ++itr) {
+    EXPECT_NE(find_nodes_response.nodes().end(),
+              std::find(find_nodes_response.nodes().begin(), find_nodes_response.nodes().end(),
+                        itr->string()));
+  }
+  EXPECT_EQ(message.destination_id(), held.front().string());
+  EXPECT_EQ(static_cast<int32_t>(MessageType::kFindNodes), message.type());
+  EXPECT_FALSE(message.request());
+
+  // A request for more than the whole routing table gets no more than it.
+  message = rpcs::FindNodes(held.front(), held.front(), std::numeric_limits<int>::max());
+  service.FindNodes(message);
+  ASSERT_TRUE(find_nodes_response.ParseFromString(message.data(0)));
+  EXPECT_EQ(static_cast<int>(held.size()), find_nodes_response.nodes_size());
+}
+
 // TEST(ServicesTest, BEH_ProxyConnect) {
 //   asymm::Keys my_keys;
 //   my_keys.identity = RandomString(64);
@@ -0,0 +1,105 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+#include "maidsafe/routing/sharded_cache.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+TEST(ShardedCacheTest, BEH_GetAndPut) {
+  ShardedCache cache(10, 1024, 2);
+  std::string value;
+  EXPECT_FALSE(cache.Get("key", value));
+  EXPECT_TRUE(cache.Put("key", "value"));
+  EXPECT_TRUE(cache.Get("key", value));
+  EXPECT_EQ("value", value);
+  EXPECT_TRUE(cache.Put("key", "other value"));
+  EXPECT_TRUE(cache.Get("key", value));
+  EXPECT_EQ("other value", value);
+
+  auto statistics(cache.statistics());
+  EXPECT_EQ(2U, statistics.hits);
+  EXPECT_EQ(1U, statistics.misses);
+  EXPECT_EQ(1U, statistics.entries);
+  EXPECT_EQ(std::string("key").size() + std::string("other value").size(), statistics.bytes);
+}
+
+TEST(ShardedCacheTest, BEH_EvictsLeastRecentlyUsed) {
+  ShardedCache cache(3, 1024, 1);
+  EXPECT_TRUE(cache.Put("a", "1"));
+  EXPECT_TRUE(cache.Put("b", "2"));
+  EXPECT_TRUE(cache.Put("c", "3"));
+  std::string value;
+  EXPECT_TRUE(cache.Get("a", value));
+  EXPECT_TRUE(cache.Put("d", "4"));
+  EXPECT_TRUE(cache.Contains("a"));
+  EXPECT_FALSE(cache.Contains("b"));
+  EXPECT_TRUE(cache.Contains("c"));
+  EXPECT_TRUE(cache.Contains("d"));
+  EXPECT_EQ(1U, cache.statistics().evictions);
+}
+
+TEST(ShardedCacheTest, BEH_BoundedInBytes) {
+  const size_t kMaxBytes(1000);
+  ShardedCache cache(1000, kMaxBytes, 4);
+  EXPECT_FALSE(cache.Put("too large", std::string(kMaxBytes, 'x')));
+  for (int i(0); i != 100; ++i)
+    EXPECT_TRUE(cache.Put(RandomString(10), RandomString(50)));
+  auto statistics(cache.statistics());
+  EXPECT_LE(statistics.bytes, kMaxBytes);
+  EXPECT_EQ(statistics.bytes, statistics.entries * 60);
+  EXPECT_EQ(100U, statistics.entries + statistics.evictions);
+}
+
+TEST(ShardedCacheTest, BEH_ConcurrentAccess) {
+  ShardedCache cache(100, 100 * 1024, 8);
+  std::vector<std::thread> threads;
+  for (int i(0); i != 8; ++i) {
+    threads.emplace_back([&cache, i] {
+      std::string value;
+      for (int j(0); j != 1000; ++j) {
+        std::string key(std::to_string((i * 1000 + j) % 200));
+        if (!cache.Get(key, value))
+          cache.Put(key, key);
+        else
+          EXPECT_EQ(key, value);
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  auto statistics(cache.statistics());
+  EXPECT_EQ(8000U, statistics.hits + statistics.misses);
+  EXPECT_LE(statistics.entries, 100U);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
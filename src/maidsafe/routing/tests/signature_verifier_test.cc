@@ -0,0 +1,168 @@
+/*  Copyright 2013 MaidSafe.net limited
+
+    This MaidSafe Software is licensed to you under (1) the MaidSafe.net Commercial License,
+    version 1.0 or later, or (2) The General Public License (GPL), version 3, depending on which
+    licence you accepted on initial access to the Software (the "Licences").
+
+    By contributing code to the MaidSafe Software, or to this project generally, you agree to be
+    bound by the terms of the MaidSafe Contributor Agreement, version 1.0, found in the root
+    directory of this project at LICENSE, COPYING and CONTRIBUTOR respectively and also
+    available at: http://www.maidsafe.net/licenses
+
+    Unless required by applicable law or agreed to in writing, the MaidSafe Software distributed
+    under the GPL Licence is distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS
+    OF ANY KIND, either express or implied.
+
+    See the Licences for the specific language governing permissions and limitations relating to
+    use of the MaidSafe Software.                                                                 */
+
+#include "maidsafe/routing/signature_verifier.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "maidsafe/common/test.h"
+#include "maidsafe/common/utils.h"
+
+namespace maidsafe {
+
+namespace routing {
+
+namespace test {
+
+class SignatureVerifierTest : public testing::Test {
+ protected:
+  SignatureVerifierTest()
+      : keys_(asymm::GenerateKeyPair()),
+        public_key_(std::make_shared<asymm::PublicKey>(keys_.public_key)) {}
+
+  SignatureVerifier::Check SignedCheck(const std::string& data) {
+    SignatureVerifier::Check check;
+    check.signer_id = "signer";
+    check.public_key = public_key_;
+    check.data = data;
+    check.signature = asymm::Sign(asymm::PlainText(data), keys_.private_key).string();
+    return check;
+  }
+
+  asymm::Keys keys_;
+  std::shared_ptr<const asymm::PublicKey> public_key_;
+};
+
+TEST_F(SignatureVerifierTest, BEH_ResultsDeliveredInSubmissionOrder) {
+  SignatureVerifier verifier(4, 64);
+  std::mutex mutex;
+  std::vector<std::pair<size_t, bool>> results;
+  std::condition_variable condition;
+  const size_t kCount(40);
+
+  SignatureVerifier::Batch batch;
+  for (size_t i(0); i < kCount; ++i) {
+    SignatureVerifier::Check check;
+    if (i % 3 == 1) {
+      check = SignedCheck(RandomString(100));
+    } else if (i % 3 == 2) {
+      check = SignedCheck(RandomString(100));
+      check.data += "tampered";
+    }  // else nothing to check
+    batch.emplace_back(check, [i, &mutex, &results, &condition](bool valid) {
+      std::lock_guard<std::mutex> lock(mutex);
+      results.emplace_back(i, valid);
+      condition.notify_one();
+    });
+  }
+  verifier.Verify(batch);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  ASSERT_TRUE(condition.wait_for(lock, std::chrono::seconds(10),
+                                 [&] { return results.size() == kCount; }));
+  for (size_t i(0); i < kCount; ++i) {
+    EXPECT_EQ(i, results.at(i).first);
+    EXPECT_EQ(i % 3 != 2, results.at(i).second);
+  }
+  auto statistics(verifier.statistics());
+  EXPECT_EQ(static_cast<uint64_t>(kCount / 3), statistics.verified);
+  EXPECT_EQ(static_cast<uint64_t>(kCount / 3), statistics.failures);
+}
+
+TEST_F(SignatureVerifierTest, BEH_OrderKeysDeliveredIndependently) {
+  SignatureVerifier verifier(1, 64);
+  std::promise<void> gate;
+  auto gate_future(gate.get_future().share());
+  std::promise<void> first_a_started, second_a, b;
+  SignatureVerifier::Check check_a, check_b;
+  check_a.order_key = "a";
+  check_b.order_key = "b";
+
+  // The submitting thread delivers the first "a" result itself and is held inside it.
+  auto submitter(std::async(std::launch::async, [&] {
+    verifier.Verify(check_a, [&](bool) {
+      first_a_started.set_value();
+      gate_future.wait();
+    });
+  }));
+  first_a_started.get_future().wait();
+  verifier.Verify(check_a, [&](bool) { second_a.set_value(); });
+  verifier.Verify(check_b, [&](bool) { b.set_value(); });
+
+  // "b" isn't held up behind "a", but the second "a" waits for the first.
+  EXPECT_EQ(std::future_status::ready, b.get_future().wait_for(std::chrono::seconds(10)));
+  auto second_a_future(second_a.get_future());
+  EXPECT_EQ(std::future_status::timeout, second_a_future.wait_for(std::chrono::milliseconds(100)));
+  gate.set_value();
+  EXPECT_EQ(std::future_status::ready, second_a_future.wait_for(std::chrono::seconds(10)));
+  submitter.get();
+}
+
+TEST_F(SignatureVerifierTest, BEH_DestructionWaitsForDelivery) {
+  std::promise<void> started;
+  std::atomic<bool> finished(false);
+  std::future<void> submitter;
+  {
+    SignatureVerifier verifier(1, 64);
+    submitter = std::async(std::launch::async, [&] {
+      verifier.Verify(SignatureVerifier::Check(), [&](bool) {
+        started.set_value();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        finished = true;
+      });
+    });
+    started.get_future().wait();
+  }
+  EXPECT_TRUE(finished);
+  submitter.get();
+}
+
+TEST_F(SignatureVerifierTest, BEH_VerifiedSignaturesCached) {
+  SignatureVerifier verifier(1, 64);
+  auto check(SignedCheck(RandomString(100)));
+  std::promise<bool> first, second;
+  verifier.Verify(check, [&first](bool valid) { first.set_value(valid); });
+  EXPECT_TRUE(first.get_future().get());
+  verifier.Verify(check, [&second](bool valid) { second.set_value(valid); });
+  EXPECT_TRUE(second.get_future().get());
+
+  auto statistics(verifier.statistics());
+  EXPECT_EQ(1U, statistics.verified);
+  EXPECT_EQ(1U, statistics.cache_hits);
+
+  // The same data with a different signature isn't a cache hit.
+  auto forged(check);
+  forged.signature = RandomString(forged.signature.size());
+  std::promise<bool> third;
+  verifier.Verify(forged, [&third](bool valid) { third.set_value(valid); });
+  EXPECT_FALSE(third.get_future().get());
+  EXPECT_EQ(1U, verifier.statistics().failures);
+}
+
+}  // namespace test
+
+}  // namespace routing
+
+}  // namespace maidsafe
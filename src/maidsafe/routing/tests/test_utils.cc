@@ -58,7 +58,7 @@ NodeInfo MakeNode() {
   NodeInfo node;
   node.id = NodeId(RandomString(64));
   asymm::Keys keys(asymm::GenerateKeyPair());
-  node.public_key = keys.public_key;
+  node.set_public_key(keys.public_key);
   node.connection_id = node.id;
   return node;
 }
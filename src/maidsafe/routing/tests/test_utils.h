@@ -63,7 +63,7 @@ template <typename FobType>
 NodeInfoAndPrivateKey MakeNodeInfoAndKeysWithFob(FobType fob) {
   NodeInfo node;
   node.id = NodeId(fob.name()->string());
-  node.public_key = fob.public_key();
+  node.set_public_key(fob.public_key());
   node.connection_id = node.id;
   NodeInfoAndPrivateKey node_info_and_private_key;
   node_info_and_private_key.node_info = node;
@@ -74,7 +74,8 @@ class TimerTest : public testing::Test {
 
   void TearDown() override {
     asio_service_.Stop();
-    EXPECT_TRUE(timer_.tasks_.empty());
+    for (const auto& shard : timer_.shards_)
+      EXPECT_TRUE(shard->tasks.empty());
   }
 
  protected:
@@ -22,13 +22,17 @@
 #include <pwd.h>
 #endif
 
+#include <functional>
 #include <string>
 #include <algorithm>
 #include <vector>
 
 #include "boost/filesystem/operations.hpp"
 #include "boost/filesystem/path.hpp"
+#include "google/protobuf/io/coded_stream.h"
+#include "google/protobuf/wire_format_lite.h"
 
+#include "maidsafe/common/crypto.h"
 #include "maidsafe/common/log.h"
 #include "maidsafe/common/utils.h"
 #include "maidsafe/common/node_id.h"
@@ -69,7 +73,7 @@ int AddToRudp(Network& network, const NodeId& this_node_id, const NodeId& this_c
 bool ValidateAndAddToRoutingTable(Network& network, RoutingTable& routing_table,
                                   ClientRoutingTable& client_routing_table,
                                   const NodeId& peer_id, const NodeId& connection_id,
-                                  const asymm::PublicKey& public_key, bool client) {
+                                  NodeInfo::PublicKeyPtr public_key, bool client) {
   if (network.MarkConnectionAsValid(connection_id) != kSuccess) {
     LOG(kError) << "[" << routing_table.kNodeId()
                 << "]  Rudp failed to validate connection with  Peer id : " << peer_id
@@ -79,7 +83,7 @@ bool ValidateAndAddToRoutingTable(Network& network, RoutingTable& routing_table,
 
   NodeInfo peer;
   peer.id = peer_id;
-  peer.public_key = public_key;
+  peer.set_public_key(std::move(public_key));
   peer.connection_id = connection_id;
   bool routing_accepted_node(false);
   if (client) {
@@ -109,6 +113,81 @@ bool ValidateAndAddToRoutingTable(Network& network, RoutingTable& routing_table,
   return false;
 }
 
+std::string PublicKeyFingerprint(const asymm::PublicKey& public_key) {
+  return crypto::Hash<crypto::SHA512>(asymm::EncodeKey(public_key).string()).string();
+}
+
+void SignRequest(const asymm::PrivateKey& private_key, protobuf::Message& message) {
+  if (!Parameters::verify_routing_signatures || message.data_size() == 0)
+    return;
+  try {
+    message.set_signature(asymm::Sign(asymm::PlainText(message.data(0)), private_key).string());
+  }
+  catch (const std::exception& e) {
+    LOG(kWarning) << "Failed to sign " << MessageTypeString(message) << ": " << e.what();
+  }
+}
+
+bool GetEchoedRequest(const protobuf::Message& message, std::string& request,
+                      std::string& signature) {
+  if (!IsRoutingMessage(message) || IsRequest(message) || message.data_size() == 0)
+    return false;
+  switch (static_cast<MessageType>(message.type())) {
+    case MessageType::kPing: {
+      protobuf::PingResponse ping_response;
+      if (!ping_response.ParseFromString(message.data(0)))
+        return false;
+      request = ping_response.original_request();
+      signature = ping_response.original_signature();
+      return true;
+    }
+    case MessageType::kConnect: {
+      protobuf::ConnectResponse connect_response;
+      if (!connect_response.ParseFromString(message.data(0)))
+        return false;
+      request = connect_response.original_request();
+      signature = connect_response.original_signature();
+      return true;
+    }
+    case MessageType::kFindNodes: {
+      protobuf::FindNodesResponse find_nodes_response;
+      if (!find_nodes_response.ParseFromString(message.data(0)))
+        return false;
+      request = find_nodes_response.original_request();
+      signature = find_nodes_response.original_signature();
+      return true;
+    }
+    default:
+      return false;
+  }
+}
+
+size_t ShardIndex(const std::string& id, size_t shard_count) {
+  return std::hash<std::string>()(id) % shard_count;
+}
+
+size_t MessageShardIndex(const std::string& serialised_message, size_t shard_count) {
+  using google::protobuf::internal::WireFormatLite;
+  google::protobuf::io::CodedInputStream input(
+      reinterpret_cast<const uint8_t*>(serialised_message.data()),
+      static_cast<int>(serialised_message.size()));
+  // Fields are serialised in field number order, so this only reads past source_id for relayed
+  // messages, and never past relay_id.
+  std::string id;
+  for (uint32_t tag(input.ReadTag()); tag != 0; tag = input.ReadTag()) {
+    int field(WireFormatLite::GetTagFieldNumber(tag));
+    if (field == protobuf::Message::kSourceIdFieldNumber ||
+        field == protobuf::Message::kRelayIdFieldNumber) {
+      if (!WireFormatLite::ReadBytes(&input, &id))
+        id.clear();
+      break;
+    }
+    if (field > protobuf::Message::kRelayIdFieldNumber || !WireFormatLite::SkipField(&input, tag))
+      break;
+  }
+  return ShardIndex(id, shard_count);
+}
+
 void InformClientOfNewCloseNode(Network& network, const NodeInfo& client,
                                 const NodeInfo& new_close_node, const NodeId& this_node_id) {
   protobuf::Message inform_client_of_new_close_node(
@@ -371,6 +450,22 @@ std::string PrintMessage(const protobuf::Message& message) {
   return s;
 }
 
+std::shared_ptr<const protobuf::Message> CopyHeader(protobuf::Message& message) {
+  // Swapping the data out is constant time, so only the header fields are copied.
+  google::protobuf::RepeatedPtrField<std::string> data;
+  data.Swap(message.mutable_data());
+  std::shared_ptr<protobuf::Message> header;
+  try {
+    header = std::make_shared<protobuf::Message>(message);
+  }
+  catch (...) {
+    data.Swap(message.mutable_data());
+    throw;
+  }
+  data.Swap(message.mutable_data());
+  return header;
+}
+
 std::vector<NodeId> DeserializeNodeIdList(const std::string& node_list_str) {
   std::vector<NodeId> node_list;
   protobuf::NodeIdList node_list_msg;
@@ -19,6 +19,7 @@
 #ifndef MAIDSAFE_ROUTING_UTILS_H_
 #define MAIDSAFE_ROUTING_UTILS_H_
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -58,7 +59,26 @@ int AddToRudp(Network& network, const NodeId& this_node_id, const NodeId& this_c
 
 bool ValidateAndAddToRoutingTable(Network& network, RoutingTable& routing_table,
     ClientRoutingTable& client_routing_table, const NodeId& peer_id, const NodeId& connection_id,
-    const asymm::PublicKey& public_key, bool client);
+    NodeInfo::PublicKeyPtr public_key, bool client);
+
+// Returns the SHA-512 hash of the DER encoding of public_key.  Throws if the key can't be encoded.
+std::string PublicKeyFingerprint(const asymm::PublicKey& public_key);
+
+// If Parameters::verify_routing_signatures is set, signs the request held in message.data(0).
+void SignRequest(const asymm::PrivateKey& private_key, protobuf::Message& message);
+
+// If message is a response which echoes a request and its signature, sets request and signature
+// to these and returns true.
+bool GetEchoedRequest(const protobuf::Message& message, std::string& request,
+                      std::string& signature);
+
+// Maps id (the bytes of a NodeId) to one of shard_count shards.  For any two shard counts where one
+// is a multiple of the other, ids sharing a shard of the larger count share one of the smaller.
+size_t ShardIndex(const std::string& id, size_t shard_count);
+
+// Returns ShardIndex() of the source id of a serialised protobuf::Message (or of its relay id if it
+// has no source id) without parsing the whole message.
+size_t MessageShardIndex(const std::string& serialised_message, size_t shard_count);
 
 void InformClientOfNewCloseNode(Network& network, const NodeInfo& client,
                                 const NodeInfo& new_close_node, const NodeId& this_node_id);
@@ -91,6 +111,9 @@ std::vector<boost::asio::ip::udp::endpoint> OrderBootstrapList(
 protobuf::NatType NatTypeProtobuf(const rudp::NatType& nat_type);
 rudp::NatType NatTypeFromProtobuf(const protobuf::NatType& nat_type_proto);
 std::string PrintMessage(const protobuf::Message& message);
+// Returns a shared copy of 'message' without its data, for continuations which only need the
+// header (e.g. to address a reply or an ack).  'message' is unchanged on return.
+std::shared_ptr<const protobuf::Message> CopyHeader(protobuf::Message& message);
 std::vector<NodeId> DeserializeNodeIdList(const std::string& node_list_str);
 std::string SerializeNodeIdList(const std::vector<NodeId>& node_list);
 SingleToSingleMessage CreateSingleToSingleMessage(const protobuf::Message& proto_message);